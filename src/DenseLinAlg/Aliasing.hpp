@@ -0,0 +1,246 @@
+/*
+ * Aliasing.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef DENSELINALG_ALIASING_HPP_
+#define DENSELINALG_ALIASING_HPP_
+
+#include <cstddef>
+#include <vector>
+#include <boost/mpl/bool.hpp>
+#include <boost/proto/proto.hpp>
+
+#include <DenseLinAlg/Grammar.hpp>
+#include <DenseLinAlg/Allocator.hpp>
+
+
+namespace DenseLinAlg {
+
+	namespace mpl = boost::mpl;
+	namespace proto = boost::proto;
+
+
+	// Callable transform object telling whether the elements of
+	// the vector v and those of lhs share any memory
+	struct Overlaps : proto::callable
+	{
+		typedef bool result_type;
+
+		template < typename VecType, typename LhsType >
+		bool operator()( const VecType& v, const LhsType& lhs) const
+		{
+			if ( v.size() == 0 || lhs.size() == 0 ) return false;
+			const char* const vBegin = reinterpret_cast< const char* >( &v(0) );
+			const char* const vEnd =
+				reinterpret_cast< const char* >( &v( v.size() - 1) + 1 );
+			const char* const lhsBegin =
+				reinterpret_cast< const char* >( &lhs(0) );
+			const char* const lhsEnd =
+				reinterpret_cast< const char* >( &lhs( lhs.size() - 1) + 1 );
+			return vBegin < lhsEnd && lhsBegin < vEnd;
+		}
+	};
+
+	// Callable transform object telling whether the elements of
+	// the matrix m and those of lhs share any memory
+	struct MatOverlaps : proto::callable
+	{
+		typedef bool result_type;
+
+		template < typename MatType, typename LhsType >
+		bool operator()( const MatType& m, const LhsType& lhs) const
+		{
+			if ( m.rowSize() == 0 || m.columnSize() == 0 ||
+				lhs.rowSize() == 0 || lhs.columnSize() == 0 ) return false;
+			const char* const mBegin =
+				reinterpret_cast< const char* >( &m( 0, 0) );
+			const char* const mEnd = reinterpret_cast< const char* >(
+				&m( m.rowSize() - 1, m.columnSize() - 1) + 1 );
+			const char* const lhsBegin =
+				reinterpret_cast< const char* >( &lhs( 0, 0) );
+			const char* const lhsEnd = reinterpret_cast< const char* >(
+				&lhs( lhs.rowSize() - 1, lhs.columnSize() - 1) + 1 );
+			return mBegin < lhsEnd && lhsBegin < mEnd;
+		}
+	};
+
+	struct LogicalOr : proto::callable
+	{
+		typedef bool result_type;
+
+		bool operator()( bool a, bool b) const { return a || b; }
+	};
+
+	// The transformation rule telling whether a vector expression
+	// reads the elements of the vector given as the data
+	struct ReadAliasGrammar : proto::or_<
+		proto::when< VecTermGrammar, Overlaps( proto::_value, proto::_data) >,
+
+		proto::when< proto::terminal< proto::_ >, mpl::false_() >,
+
+		proto::when<
+			proto::nary_expr< proto::_, proto::vararg< proto::_ > >,
+			proto::fold< proto::_, mpl::false_(),
+						LogicalOr( ReadAliasGrammar, proto::_state) >
+		>
+	> {};
+
+	// The transformation rule telling whether a vector expression
+	// gathers the elements of the vector given as the data,
+	// i.e. whether the vector is multiplied by a matrix in the expression.
+	// Assigning such an expression into the vector element by element
+	// overwrites the elements before all of them are read.
+	// The elements read elementwise are not checked, since
+	// each of them is read before it is overwritten.
+	struct GatherAliasGrammar : proto::or_<
+		// Matrix * Vector
+		proto::when< MatVecMultGrammar,
+					Overlaps( proto::_value( proto::_right), proto::_data) >,
+
+		// Matrix * VecExprGrammar
+		proto::when< proto::multiplies< MatTermGrammar, VecExprGrammar >,
+					ReadAliasGrammar( proto::_right) >,
+
+		proto::when< proto::terminal< proto::_ >, mpl::false_() >,
+
+		proto::when<
+			proto::nary_expr< proto::_, proto::vararg< proto::_ > >,
+			proto::fold< proto::_, mpl::false_(),
+						LogicalOr( GatherAliasGrammar, proto::_state) >
+		>
+	> {};
+
+	// The transformation rule telling whether a matrix expression
+	// multiplies the matrix given as the data.
+	// Assigning such an expression into the matrix a tile at a time
+	// overwrites the elements before the other tiles read them.
+	struct MatProductAliasGrammar : proto::or_<
+		// Matrix * DiagonalMatrix * Matrix
+		proto::when<
+			proto::multiplies<
+				proto::multiplies< MatTermGrammar, DiagMatTermGrammar >,
+				MatTermGrammar
+			>,
+			LogicalOr(
+				MatOverlaps( proto::_value( proto::_left( proto::_left) ),
+							proto::_data),
+				MatOverlaps( proto::_value( proto::_right), proto::_data) )
+		>,
+
+		// Matrix * Matrix
+		proto::when< proto::multiplies< MatTermGrammar, MatTermGrammar >,
+			LogicalOr( MatOverlaps( proto::_value( proto::_left), proto::_data),
+					MatOverlaps( proto::_value( proto::_right), proto::_data) )
+		>,
+
+		proto::when< proto::terminal< proto::_ >, mpl::false_() >,
+
+		proto::when<
+			proto::nary_expr< proto::_, proto::vararg< proto::_ > >,
+			proto::fold< proto::_, mpl::false_(),
+						LogicalOr( MatProductAliasGrammar, proto::_state) >
+		>
+	> {};
+
+
+	// Pool of the aligned scratch buffers, which are
+	// reused by the assignments of the aliased expressions.
+	// Every thread has its own pool.
+	class ScratchPool
+	{
+	private:
+		struct Buffer
+		{
+			void* data;
+			std::size_t bytes;
+			bool inUse;
+		};
+
+		std::vector< Buffer > buffers;
+
+		ScratchPool() {}
+		ScratchPool( const ScratchPool& ) = delete;
+		ScratchPool& operator=( const ScratchPool& ) = delete;
+
+	public:
+		~ScratchPool() {
+			for (std::size_t b = 0; b < buffers.size(); b++)
+				DefaultAllocator::deallocate( buffers[b].data);
+		}
+
+		// the pool of the calling thread
+		static ScratchPool& local() {
+			static thread_local ScratchPool pool;
+			return pool;
+		}
+
+		// a buffer of bytes or more, which is reused if possible
+		void* acquire( std::size_t bytes)
+		{
+			Buffer* grown = nullptr;
+			for (std::size_t b = 0; b < buffers.size(); b++) {
+				if ( buffers[b].inUse ) continue;
+				if ( buffers[b].bytes >= bytes ) {
+					buffers[b].inUse = true;
+					return buffers[b].data;
+				}
+				grown = &buffers[b];
+			}
+
+			if ( grown == nullptr ) {
+				const Buffer added = { nullptr, 0, false };
+				buffers.push_back( added);
+				grown = &buffers.back();
+			}
+			DefaultAllocator::deallocate( grown->data);
+			grown->data = nullptr;
+			grown->bytes = 0;
+			grown->data = DefaultAllocator::allocate< char >( bytes);
+			grown->bytes = bytes;
+			grown->inUse = true;
+			return grown->data;
+		}
+
+		void release( void* data)
+		{
+			for (std::size_t b = 0; b < buffers.size(); b++)
+				if ( buffers[b].data == data ) buffers[b].inUse = false;
+		}
+	};
+
+
+	// Vector borrowing its buffer from the scratch pool of the thread
+	// while it is alive
+	template < typename Scalar >
+	class ScratchVector
+	{
+	private:
+		const int sz;
+		Scalar* const data;
+
+	public:
+		typedef Scalar value_type;
+
+		explicit ScratchVector( int size) :
+			sz( size),
+			data( static_cast< Scalar* >( ScratchPool::local().acquire(
+										size * sizeof( Scalar) ) ) ) {}
+
+		ScratchVector( const ScratchVector& ) = delete;
+		ScratchVector& operator=( const ScratchVector& ) = delete;
+
+		~ScratchVector() { ScratchPool::local().release( data); }
+
+		int size() const { return sz; }
+
+		Scalar& operator()(int i) { return data[i]; }
+		const Scalar& operator()(int i) const { return data[i]; }
+	};
+
+}
+
+
+#endif /* DENSELINALG_ALIASING_HPP_ */
@@ -0,0 +1,145 @@
+/*
+ * Allocator.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef DENSELINALG_ALLOCATOR_HPP_
+#define DENSELINALG_ALLOCATOR_HPP_
+
+#include <stdlib.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+#endif
+
+
+namespace DenseLinAlg {
+
+	// Allocator policy for the element buffers of
+	// Vector, Matrix and DiagonalMatrix
+	//
+	// Every buffer is aligned by Alignment bytes.
+	// A buffer of HugePageThreshold bytes or more is aligned by
+	// the huge page size and advised to be backed by huge pages,
+	// unless HugePageThreshold is zero.
+	template < std::size_t Alignment, std::size_t HugePageThreshold = 0 >
+	struct AlignedAllocator
+	{
+		static const std::size_t alignment = Alignment;
+		static const std::size_t hugePageSize = 2 * 1024 * 1024;
+
+		template < typename T = double >
+		static T* allocate( std::size_t sz)
+		{
+			std::size_t bytes = sz * sizeof( T);
+			if ( bytes == 0 ) bytes = Alignment;
+
+			if ( HugePageThreshold > 0 && bytes >= HugePageThreshold ) {
+				bytes = roundUp( bytes, hugePageSize);
+				T* const p = static_cast< T* >(
+						alignedAllocate( hugePageSize, bytes) );
+				#ifdef MADV_HUGEPAGE
+				madvise( p, bytes, MADV_HUGEPAGE);
+				#endif
+				return p;
+			}
+			return static_cast< T* >(
+					alignedAllocate( Alignment, roundUp( bytes, Alignment) ) );
+		}
+
+		static void deallocate( void* p) { free( p); }
+
+	private:
+		static std::size_t roundUp( std::size_t bytes, std::size_t unit)
+		{
+			return ( bytes + unit - 1 ) / unit * unit;
+		}
+
+		// The buffer is returned rather than stored through
+		// the address of a local pointer, which the compiler would
+		// suspect of being dangling.
+		// The bytes should be a multiple of the alignment.
+		static void* alignedAllocate( std::size_t alignment, std::size_t bytes)
+		{
+			void* const p = aligned_alloc( alignment, bytes);
+			if ( p == 0 ) throw std::bad_alloc();
+			return p;
+		}
+	};
+
+
+	// The allocator used by the containers of this library.
+	// Defining DENSELINALG_HUGE_PAGE_THRESHOLD (in bytes) enables
+	// huge page backing for large buffers.
+#ifdef DENSELINALG_HUGE_PAGE_THRESHOLD
+	typedef AlignedAllocator< 64, DENSELINALG_HUGE_PAGE_THRESHOLD >
+		DefaultAllocator;
+#else
+	typedef AlignedAllocator< 64 > DefaultAllocator;
+#endif
+
+	// Interleaving the pages of the buffer of the count elements at p
+	// round-robin across the NUMA nodes allowed for the process,
+	// so that the threads on all the nodes read it at the same bandwidth.
+	// The pages already touched are moved.
+	// Returning false if the NUMA policy is not supported.
+	// It is a template, not an inline function,
+	// since it is too large to be inlined.
+	template < typename T >
+	bool interleavePages( const T* p, std::size_t count)
+	{
+#if defined( __linux__ ) && defined( SYS_mbind ) && defined( SYS_get_mempolicy )
+		const unsigned long maxNode = 1024;
+		unsigned long nodes[ maxNode / ( 8 * sizeof( unsigned long) ) ] = {};
+		// The system calls take the number of the bits plus one.
+		if ( syscall( SYS_get_mempolicy, nullptr, nodes, maxNode + 1,
+					nullptr, MPOL_F_MEMS_ALLOWED) != 0 )
+			return false;
+
+		// The policy is given to the whole pages within the buffer,
+		// since the pages at its ends may hold the other buffers.
+		const std::uintptr_t page = sysconf( _SC_PAGESIZE),
+			first = ( reinterpret_cast< std::uintptr_t >( p)
+						+ page - 1 ) / page * page,
+			last = reinterpret_cast< std::uintptr_t >( p + count)
+						/ page * page;
+		if ( first >= last ) return true;
+		return syscall( SYS_mbind, first, last - first, MPOL_INTERLEAVE,
+						nodes, maxNode + 1, MPOL_MF_MOVE) == 0;
+#else
+		(void)p;
+		(void)count;
+		return false;
+#endif
+	}
+
+
+	// Alignment guaranteed at compile time for the element buffers
+	const std::size_t DataAlignment = DefaultAllocator::alignment;
+
+	// Telling the compiler that a buffer allocated by DefaultAllocator
+	// is aligned, so that the kernels can use aligned loads.
+	template < typename T >
+	inline T* assumeAligned( T* p)
+	{
+#ifdef __GNUC__
+		return static_cast< T* >(
+				__builtin_assume_aligned( p, DataAlignment) );
+#else
+		return p;
+#endif
+	}
+
+}
+
+
+#endif /* DENSELINALG_ALLOCATOR_HPP_ */
@@ -0,0 +1,225 @@
+/*
+ * CommonSubexpr.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef DENSELINALG_COMMONSUBEXPR_HPP_
+#define DENSELINALG_COMMONSUBEXPR_HPP_
+
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <boost/mpl/if.hpp>
+#include <boost/mpl/int.hpp>
+#include <boost/proto/proto.hpp>
+
+#include <DenseLinAlg/Grammar.hpp>
+
+
+namespace DenseLinAlg {
+
+	namespace mpl = boost::mpl;
+	namespace proto = boost::proto;
+
+
+	// Meta function counting the subtrees of the type Node
+	// in the expression of the type Expr
+	template < typename Node, typename Expr >
+	struct SubtreeCount;
+
+	template < typename Node, typename Expr, long I, long Arity >
+	struct ChildrenSubtreeCount : mpl::int_<
+		SubtreeCount< Node,
+			typename proto::result_of::child_c< Expr, I >::type >::value +
+		ChildrenSubtreeCount< Node, Expr, I + 1, Arity >::value > {};
+
+	template < typename Node, typename Expr, long Arity >
+	struct ChildrenSubtreeCount< Node, Expr, Arity, Arity >
+		: mpl::int_< 0 > {};
+
+	template < typename Node, typename Expr >
+	struct SubtreeCount : mpl::int_<
+		std::is_same< typename std::decay< Node >::type,
+						typename std::decay< Expr >::type >::value +
+		ChildrenSubtreeCount< Node, typename std::decay< Expr >::type, 0,
+			proto::arity_of< typename std::decay< Expr >::type >::value
+		>::value > {};
+
+
+	// Memos of the subexpressions repeated in a vector expression,
+	// each of which keeps the element at the last evaluated index.
+	//
+	// The occurrences of a subexpression of the same type on
+	// the same terminals share a memo.
+	// Every thread should make its own object, which should outlive
+	// the expression rewritten with it by VecLazyGrammar .
+	class VecExprMemo
+	{
+	public:
+		class Slot
+		{
+		private:
+			const void* type;
+			const void* left;
+			const void* right;
+			int index;
+			// the bytes of the element, copied in and out by std::memcpy
+			// so that they are not read through a pointer of another type
+			alignas( long double ) unsigned char
+				storage[ sizeof( long double) ];
+
+			friend class VecExprMemo;
+
+		public:
+			Slot() : type( nullptr), left( nullptr), right( nullptr),
+				index( -1) {}
+
+			bool has( int i) const { return index == i; }
+
+			template < typename T >
+			T value() const {
+				static_assert( sizeof( T) <= sizeof( storage) &&
+								std::is_trivially_copyable< T >::value,
+							"The element type can not be memorized." );
+				T elm;
+				std::memcpy( &elm, storage, sizeof( T) );
+				return elm;
+			}
+
+			template < typename T >
+			void store( int i, T elm) {
+				static_assert( sizeof( T) <= sizeof( storage) &&
+								std::is_trivially_copyable< T >::value,
+							"The element type can not be memorized." );
+				std::memcpy( storage, &elm, sizeof( T) );
+				index = i;
+			}
+		};
+
+		static const int capacity = 8;
+
+	private:
+		Slot slots[ capacity];
+		int sz;
+
+		template < typename Expr > struct TypeKey { static const char id = 0; };
+
+	public:
+		VecExprMemo() : sz( 0) {}
+
+		// The lazy function objects keep the pointers to the slots.
+		VecExprMemo( const VecExprMemo& ) = delete;
+		VecExprMemo& operator=( const VecExprMemo& ) = delete;
+
+		// the slot shared by the binary subexpressions of the type Expr
+		// on the operands l and r , or nullptr if all the slots are used
+		template < typename Expr, typename L, typename R >
+		Slot* slot( const L& l, const R& r)
+		{
+			const void* const type = &TypeKey< Expr >::id;
+			for (int s = 0; s < sz; s++)
+				if ( slots[s].type == type && slots[s].left == &l &&
+						slots[s].right == &r )
+					return &slots[s];
+			if ( sz == capacity ) return nullptr;
+
+			slots[sz].type = type;
+			slots[sz].left = &l;
+			slots[sz].right = &r;
+			slots[sz].index = -1;
+			return &slots[ sz++];
+		}
+	};
+
+	template < typename Expr >
+	const char VecExprMemo::TypeKey< Expr >::id;
+
+
+	// Lazy function object for evaluating an element of
+	// a subexpression repeated in a vector expression.
+	// The element is evaluated only once for every index,
+	// and the other occurrences read it from the shared memo.
+	template < typename Expr >
+	struct LazyMemoVecExpr
+	{
+		Expr expr;
+		VecExprMemo::Slot* const slot;
+
+		typedef typename std::decay< decltype(
+			VecExprGrammar()( std::declval< const Expr& >()( 0) )
+		) >::type result_type;
+
+		explicit LazyMemoVecExpr( const Expr& e, VecExprMemo::Slot* s) :
+			expr( e), slot( s) {}
+
+		result_type operator()(int index) const
+		{
+			if ( slot == nullptr )
+				return VecExprGrammar()( expr( index) );
+			if ( ! slot->has( index) )
+				slot->store( index,
+					result_type( VecExprGrammar()( expr( index) ) ) );
+			return slot->value< result_type >();
+		}
+	};
+
+
+	// Callable transform object replacing a subexpression node
+	// by the expression evaluated, when the subexpressions of the same type
+	// appear more than once in the root expression.
+	// The replaced expression is memorized into a terminal of
+	// LazyMemoVecExpr , the others are returned as they are.
+	struct MemoVecExpr : proto::callable
+	{
+		template < typename Sig > struct result;
+
+		template < typename This, typename Node, typename Root,
+					typename Memo, typename EvalExpr >
+		struct result< This( Node, Root, Memo, EvalExpr) >
+		{
+			typedef typename std::decay< EvalExpr >::type eval_type;
+
+			typedef typename mpl::if_c<
+				( SubtreeCount< Node, Root >::value > 1 ),
+				typename proto::terminal<
+					LazyMemoVecExpr< eval_type > >::type,
+				eval_type
+			>::type type;
+		};
+
+		template < typename Node, typename Root, typename EvalExpr >
+		typename result< MemoVecExpr(
+				const Node&, const Root&, VecExprMemo&, const EvalExpr&)
+			>::type
+		operator()( const Node& node, const Root&, VecExprMemo& memo,
+					const EvalExpr& evalExpr ) const
+		{
+			return memorize( node, memo, evalExpr,
+				mpl::bool_< ( SubtreeCount< Node, Root >::value > 1 ) >() );
+		}
+
+	private:
+		template < typename Node, typename EvalExpr >
+		typename proto::terminal< LazyMemoVecExpr< EvalExpr > >::type
+		memorize( const Node& node, VecExprMemo& memo,
+					const EvalExpr& evalExpr, mpl::true_ ) const
+		{
+			return proto::as_expr( LazyMemoVecExpr< EvalExpr >( evalExpr,
+				memo.slot< Node >( proto::value( proto::left( node) ),
+									proto::value( proto::right( node) ) ) ) );
+		}
+
+		template < typename Node, typename EvalExpr >
+		EvalExpr memorize( const Node&, VecExprMemo&,
+					const EvalExpr& evalExpr, mpl::false_ ) const
+		{
+			return evalExpr;
+		}
+	};
+
+}
+
+
+#endif /* DENSELINALG_COMMONSUBEXPR_HPP_ */
@@ -0,0 +1,496 @@
+/*
+ * CostModel.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef DENSELINALG_COSTMODEL_HPP_
+#define DENSELINALG_COSTMODEL_HPP_
+
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <boost/mpl/bool.hpp>
+#include <boost/mpl/long.hpp>
+#include <boost/proto/proto.hpp>
+
+#include <DenseLinAlg/Grammar.hpp>
+#include <DenseLinAlg/Aliasing.hpp>
+
+
+namespace DenseLinAlg {
+
+	namespace mpl = boost::mpl;
+	namespace proto = boost::proto;
+
+
+	// Nominal constants of the cost model of vector expressions
+	struct VecCostModel
+	{
+		// the number of the elements of an operand read for an element of
+		// its product by a matrix, i.e. the nominal length of the rows
+		static const long rowReads = 16;
+		// the cost of moving a byte in floating point operations
+		static const long flopsPerByte = 4;
+	};
+
+
+	// Meta function estimating the floating point operations and
+	// the bytes read for evaluating an element of a vector expression.
+	// The operands of the matrix vector products, which are chosen
+	// to be materialized by MaterializeOperand , are counted as
+	// the vectors read.
+	template < typename Expr >
+	struct VecElmCost;
+
+	template < typename Scalar, long Flops, long Bytes >
+	struct VecElmCostValue
+	{
+		typedef Scalar value_type;
+		typedef mpl::long_< Flops > flops;
+		typedef mpl::long_< Bytes > bytes;
+		typedef mpl::long_< Flops + Bytes * VecCostModel::flopsPerByte > total;
+	};
+
+	// Meta function telling whether the operand of the type Expr
+	// multiplied by a matrix should be evaluated into a temporary.
+	// Its elements are read rowReads times by the product,
+	// while the temporary costs an evaluation, a write and
+	// rowReads reads of an element.
+	template < typename Expr >
+	struct MaterializeOperand : mpl::bool_< (
+		VecCostModel::rowReads * VecElmCost< Expr >::total::value >
+		VecElmCost< Expr >::total::value +
+			( 1 + VecCostModel::rowReads ) * VecCostModel::flopsPerByte *
+			long( sizeof( typename VecElmCost< Expr >::value_type ) )
+	) > {};
+
+	template < typename Expr >
+	struct ChildType
+	{
+		typedef typename std::decay<
+			typename proto::result_of::child_c< Expr, 0 >::type >::type left;
+		typedef typename std::decay< typename proto::result_of::child_c<
+			Expr, proto::arity_of< Expr >::value - 1 >::type >::type right;
+	};
+
+	template < typename Expr, typename Tag = typename proto::tag_of< Expr >::type >
+	struct VecElmCostImpl;
+
+	// Vector
+	template < typename Expr >
+	struct VecElmCostImpl< Expr, proto::tag::terminal >
+	{
+		typedef typename std::decay<
+			typename proto::result_of::value< Expr >::type >::type::value_type
+				scalar_type;
+		typedef VecElmCostValue< scalar_type, 0, sizeof( scalar_type ) > type;
+	};
+
+	// VecExpr +(-) VecExpr
+	template < typename Left, typename Right >
+	struct AdditiveVecElmCost
+	{
+		typedef VecElmCost< Left > left;
+		typedef VecElmCost< Right > right;
+		typedef VecElmCostValue<
+			typename std::common_type< typename left::value_type,
+										typename right::value_type >::type,
+			left::flops::value + right::flops::value + 1,
+			left::bytes::value + right::bytes::value
+		> type;
+	};
+
+	template < typename Expr >
+	struct VecElmCostImpl< Expr, proto::tag::plus > : AdditiveVecElmCost<
+		typename ChildType< Expr >::left, typename ChildType< Expr >::right > {};
+
+	template < typename Expr >
+	struct VecElmCostImpl< Expr, proto::tag::minus > : AdditiveVecElmCost<
+		typename ChildType< Expr >::left, typename ChildType< Expr >::right > {};
+
+	template < typename Left, typename Right,
+		bool ScalarLeft = proto::matches< Left, ScalarTermGrammar >::value,
+		bool ScalarRight = proto::matches< Right, ScalarTermGrammar >::value,
+		bool DiagLeft = proto::matches< Left, DiagMatTermGrammar >::value >
+	struct MultipliesVecElmCost;
+
+	// Scalar * VecExpr
+	template < typename Left, typename Right >
+	struct MultipliesVecElmCost< Left, Right, true, false, false >
+	{
+		typedef VecElmCost< Right > right;
+		typedef VecElmCostValue<
+			typename std::common_type< typename std::decay<
+				typename proto::result_of::value< Left >::type >::type,
+				typename right::value_type >::type,
+			right::flops::value + 1, right::bytes::value
+		> type;
+	};
+
+	// VecExpr * Scalar
+	template < typename Left, typename Right >
+	struct MultipliesVecElmCost< Left, Right, false, true, false >
+		: MultipliesVecElmCost< Right, Left, true, false, false > {};
+
+	// DiagonalMatrix * VecExpr
+	template < typename Left, typename Right >
+	struct MultipliesVecElmCost< Left, Right, false, false, true >
+	{
+		typedef typename std::decay< typename proto::result_of::value<
+			Left >::type >::type::value_type diag_type;
+		typedef VecElmCost< Right > right;
+		typedef VecElmCostValue<
+			typename std::common_type< diag_type,
+										typename right::value_type >::type,
+			right::flops::value + 1,
+			right::bytes::value + sizeof( diag_type )
+		> type;
+	};
+
+	// Matrix * VecExpr , reading a row of the matrix and
+	// rowReads elements of the operand or of its temporary
+	template < typename Left, typename Right >
+	struct MultipliesVecElmCost< Left, Right, false, false, false >
+	{
+		typedef typename std::decay< typename proto::result_of::value<
+			Left >::type >::type::value_type mat_type;
+		typedef VecElmCost< Right > right;
+		static const bool materialized = MaterializeOperand< Right >::value;
+		typedef VecElmCostValue<
+			typename std::common_type< mat_type,
+										typename right::value_type >::type,
+			VecCostModel::rowReads *
+				( 2 + ( materialized ? 0 : right::flops::value ) ),
+			VecCostModel::rowReads * ( long( sizeof( mat_type ) ) +
+				( materialized ? long( sizeof( typename right::value_type ) ) :
+									right::bytes::value ) )
+		> type;
+	};
+
+	template < typename Expr >
+	struct VecElmCostImpl< Expr, proto::tag::multiplies > : MultipliesVecElmCost<
+		typename ChildType< Expr >::left, typename ChildType< Expr >::right > {};
+
+	template < typename Expr >
+	struct VecElmCost :
+		VecElmCostImpl< typename std::decay< Expr >::type >::type {};
+
+
+	// The grammar for the products of a matrix and a vector expression,
+	// whose operands may be materialized
+	struct MatVecExprMultGrammar :
+		proto::multiplies< MatTermGrammar, VecExprGrammar > {};
+
+	// Meta function counting the products of a matrix and
+	// the operand of the type Node , which is materialized,
+	// in the expression of the type Expr .
+	// The products of the transposed matrices and vectors, which are
+	// scattered at once, are counted as their own materialized operands.
+	// Those of any operand are counted for Node of void.
+	template < typename Node, typename Expr >
+	struct MaterializedOperandCount;
+
+	template < typename Node, typename Expr,
+		bool Product = proto::matches< Expr, MatVecExprMultGrammar >::value,
+		bool TransProduct = proto::matches< Expr, TransMatVecMultGrammar >::value >
+	struct IsMaterializedProduct : mpl::false_ {};
+
+	template < typename Node, typename Expr >
+	struct IsMaterializedProduct< Node, Expr, true, false > : mpl::bool_<
+		( std::is_void< Node >::value ||
+			std::is_same< Node, typename ChildType< Expr >::right >::value ) &&
+		MaterializeOperand< typename ChildType< Expr >::right >::value > {};
+
+	template < typename Node, typename Expr >
+	struct IsMaterializedProduct< Node, Expr, false, true > : mpl::bool_<
+		std::is_void< Node >::value || std::is_same< Node, Expr >::value > {};
+
+	template < typename Node, typename Expr, long I, long Arity >
+	struct ChildrenMaterializedOperandCount : mpl::long_<
+		MaterializedOperandCount< Node,
+			typename proto::result_of::child_c< Expr, I >::type >::value +
+		ChildrenMaterializedOperandCount< Node, Expr, I + 1, Arity >::value > {};
+
+	template < typename Node, typename Expr, long Arity >
+	struct ChildrenMaterializedOperandCount< Node, Expr, Arity, Arity >
+		: mpl::long_< 0 > {};
+
+	template < typename Node, typename Expr >
+	struct MaterializedOperandCount : mpl::long_<
+		IsMaterializedProduct< typename std::decay< Node >::type,
+								typename std::decay< Expr >::type >::value +
+		ChildrenMaterializedOperandCount< Node, typename std::decay< Expr >::type,
+			0, proto::arity_of< typename std::decay< Expr >::type >::value
+		>::value > {};
+
+	// Meta function telling whether the subexpression of the type Node
+	// is materialized in the expression of the type Root
+	template < typename Node, typename Root >
+	struct IsMaterialized
+		: mpl::bool_< ( MaterializedOperandCount< Node, Root >::value > 0 ) > {};
+
+	// Meta function telling whether any subexpression of
+	// the expression of the type Expr is materialized
+	template < typename Expr >
+	struct HasMaterialized : IsMaterialized< void, Expr > {};
+
+
+	// Vector on a buffer of VecExprTemps ,
+	// into which a subexpression is materialized
+	template < typename Scalar >
+	class TempVector
+	{
+	private:
+		Scalar* data;
+		int sz;
+
+	public:
+		typedef Scalar value_type;
+
+		template <typename Sig> struct result;
+
+		template <typename This, typename T>
+		struct result< This(T) > { typedef Scalar type; };
+
+		TempVector( Scalar* d, int size) : data( d), sz( size) {}
+
+		int size() const { return sz; }
+
+		Scalar& operator()(int i) { return data[i]; }
+		const Scalar& operator()(int i) const { return data[i]; }
+	};
+
+
+	// Meta function telling whether two subexpressions of the type Expr
+	// are made of the same terminals.
+	// The scalars are compared by their values,
+	// the others by their addresses.
+	template < typename Expr, long Arity = proto::arity_of< Expr >::value >
+	struct SameTerminals
+	{
+		template < long I >
+		static bool children( const Expr& a, const Expr& b, mpl::long_< I > )
+		{
+			typedef typename std::decay< typename proto::result_of::child_c<
+				Expr, I >::type >::type child_type;
+			return SameTerminals< child_type >::apply(
+						proto::child_c< I >( a), proto::child_c< I >( b) ) &&
+					children( a, b, mpl::long_< I + 1 >() );
+		}
+
+		static bool children( const Expr&, const Expr&, mpl::long_< Arity > )
+		{
+			return true;
+		}
+
+		static bool apply( const Expr& a, const Expr& b)
+		{
+			return children( a, b, mpl::long_< 0 >() );
+		}
+	};
+
+	template < typename Expr >
+	struct SameTerminals< Expr, 0 >
+	{
+		template < typename T >
+		static bool equal( const T& a, const T& b, std::true_type )
+		{
+			return a == b;
+		}
+
+		template < typename T >
+		static bool equal( const T& a, const T& b, std::false_type )
+		{
+			return &a == &b;
+		}
+
+		static bool apply( const Expr& a, const Expr& b)
+		{
+			typedef typename std::decay<
+				typename proto::result_of::value< Expr >::type >::type value_type;
+			return equal( proto::value( a), proto::value( b),
+							std::is_arithmetic< value_type >() );
+		}
+	};
+
+
+	// Temporaries of the subexpressions materialized in a vector expression,
+	// whose buffers are borrowed from the scratch pool of the thread.
+	// The occurrences of a subexpression of the same type on
+	// the same terminals share a temporary.
+	// The object should outlive the expression rewritten
+	// with it by VecPlanGrammar .
+	class VecExprTemps
+	{
+	private:
+		struct Entry
+		{
+			const void* type;
+			const void* node;
+			void* data;
+		};
+
+		std::vector< Entry > entries;
+
+		template < typename Expr > struct TypeKey { static const char id = 0; };
+
+	public:
+		VecExprTemps() {}
+
+		VecExprTemps( const VecExprTemps& ) = delete;
+		VecExprTemps& operator=( const VecExprTemps& ) = delete;
+
+		~VecExprTemps() {
+			for (std::size_t e = 0; e < entries.size(); e++)
+				ScratchPool::local().release( entries[e].data);
+		}
+
+		// the temporary of the subexpression node , which is
+		// reused if made before, otherwise made and to be evaluated
+		template < typename Scalar, typename Expr >
+		TempVector< Scalar > temporary( const Expr& node, int size,
+										bool& evaluated)
+		{
+			const void* const type = &TypeKey< Expr >::id;
+			for (std::size_t e = 0; e < entries.size(); e++)
+				if ( entries[e].type == type &&
+						SameTerminals< Expr >::apply(
+							*static_cast< const Expr* >( entries[e].node), node) ) {
+					evaluated = true;
+					return TempVector< Scalar >(
+								static_cast< Scalar* >( entries[e].data), size);
+				}
+
+			const Entry added = { type, &node,
+				ScratchPool::local().acquire( size * sizeof( Scalar) ) };
+			entries.push_back( added);
+			evaluated = false;
+			return TempVector< Scalar >(
+						static_cast< Scalar* >( added.data), size);
+		}
+	};
+
+	template < typename Expr >
+	const char VecExprTemps::TypeKey< Expr >::id;
+
+
+	// evaluating the vector expression expr into temp ,
+	// defined with AssignVecExpr
+	template < typename Expr, typename Scalar >
+	void materializeVecExpr( const Expr& expr, TempVector< Scalar >& temp);
+
+	// Callable transform object replacing a subexpression by
+	// a terminal of its temporary, which is evaluated
+	// when the subexpression appears first
+	struct MaterializeVecExpr : proto::callable
+	{
+		template < typename Sig > struct result;
+
+		template < typename This, typename Expr, typename Temps >
+		struct result< This( Expr, Temps) >
+		{
+			typedef typename proto::terminal< TempVector<
+				typename VecElmCost< Expr >::value_type > >::type type;
+		};
+
+		template < typename Expr >
+		typename result< MaterializeVecExpr( const Expr&, VecExprTemps&) >::type
+		operator()( const Expr& expr, VecExprTemps& temps) const
+		{
+			typedef typename VecElmCost< Expr >::value_type Scalar;
+			bool evaluated;
+			TempVector< Scalar > temp = temps.temporary< Scalar >(
+									expr, VecSizeGrammar()( expr), evaluated);
+			if ( ! evaluated ) materializeVecExpr( expr, temp);
+			return proto::as_expr( temp);
+		}
+	};
+
+	// The transformation rule replacing the subexpressions of
+	// a vector expression of the type Root , which are chosen
+	// to be materialized by the cost model, by the terminals of
+	// their temporaries.
+	// The other occurrences of those subexpressions, e.g. A * x in
+	// D * ( A * x ) + B * ( A * x ) , are replaced by the same temporary.
+	// This transform accepts VecExprTemps as the data.
+	// The output is evaluated in the same way as the other expressions.
+	template < typename Root >
+	struct VecPlanGrammar : proto::or_<
+		proto::when<
+			proto::if_< IsMaterialized< proto::_, Root >() >,
+			MaterializeVecExpr( proto::_, proto::_data )
+		>,
+		proto::terminal< proto::_ >,
+		proto::nary_expr< proto::_, proto::vararg< VecPlanGrammar< Root > > >
+	> {};
+
+
+	// Printer of a node of a vector expression of the type Root
+	// and its children
+	template < typename Root, typename Expr,
+				long Arity = proto::arity_of< Expr >::value >
+	struct VecPlanNodePrinter
+	{
+		template < long I >
+		static void children( Expr const & expr, int depth, mpl::long_< I > )
+		{
+			typedef typename std::decay< typename proto::result_of::child_c<
+				Expr, I >::type >::type child_type;
+			VecPlanNodePrinter< Root, child_type >::print(
+				proto::child_c< I >( expr), depth,
+				proto::matches< Expr, MatVecExprMultGrammar >::value &&
+					I == 1 );
+			children( expr, depth, mpl::long_< I + 1 >() );
+		}
+
+		static void children( Expr const &, int, mpl::long_< Arity > ) {}
+
+		static void print( Expr const & expr, int depth, bool operand)
+		{
+			typedef VecElmCost< Expr > cost;
+			std::cout << std::string( 2 * depth, ' ')
+				<< typename proto::tag_of< Expr >::type()
+				<< " : " << cost::flops::value << " flops, "
+				<< cost::bytes::value << " bytes";
+			if ( IsMaterialized< Expr, Root >::value )
+				std::cout << ", materialized";
+			else if ( operand )
+				std::cout << ", inlined";
+			std::cout << std::endl;
+			children( expr, depth + 1, mpl::long_< 0 >() );
+		}
+	};
+
+	template < typename Root, typename Expr >
+	struct VecPlanNodePrinter< Root, Expr, 0 >
+	{
+		static void print( Expr const &, int depth, bool)
+		{
+			std::cout << std::string( 2 * depth, ' ')
+				<< typename proto::tag_of< Expr >::type() << std::endl;
+		}
+	};
+
+	// Debug printer of the evaluation plan of a vector expression,
+	// showing the estimated cost of an element of every node,
+	// evaluated lazily, and which operands of the matrix vector
+	// products are materialized or inlined
+	struct VecPlanPrinter
+	{
+		template < class Expr >
+		void operator ()( Expr const & expr ) const {
+			static_assert(
+					proto::matches< Expr, VecExprGrammar >::value,
+					"The expression does not match to the grammar!"
+			);
+			VecPlanNodePrinter< Expr, Expr >::print( expr, 0, false);
+		}
+	};
+
+}
+
+
+#endif /* DENSELINALG_COSTMODEL_HPP_ */
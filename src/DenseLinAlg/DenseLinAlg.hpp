@@ -13,7 +13,14 @@
 
 #include <DenseLinAlg/Grammar.hpp>
 #include <DenseLinAlg/MatrixVector.hpp>
+#include <DenseLinAlg/View.hpp>
+#include <DenseLinAlg/MultiVector.hpp>
 #include <DenseLinAlg/LazyEvaluator.hpp>
+#include <DenseLinAlg/Gemm.hpp>
+#include <DenseLinAlg/TiledMatVec.hpp>
+#include <DenseLinAlg/Transpose.hpp>
+#include <DenseLinAlg/Reduction.hpp>
+#include <DenseLinAlg/Fusion.hpp>
 
 
 namespace DenseLinAlg {
@@ -26,13 +33,45 @@ namespace DenseLinAlg {
 	// by the BOOST_PROTO_DEFINE_OPERATORS macro below.
 	template<typename> struct IsExpr  : mpl::false_ {};
 
-	template<> struct IsExpr< Vector > : mpl::true_  {};
-	template<> struct IsExpr< Matrix > : mpl::true_  {};
-	template<> struct IsExpr< DiagonalMatrix > : mpl::true_  {};
+	template< typename Scalar >
+	struct IsExpr< BasicVector< Scalar > > : mpl::true_  {};
+	template< typename Layout, typename Scalar >
+	struct IsExpr< BasicMatrix< Layout, Scalar > > : mpl::true_  {};
+	template< typename Scalar >
+	struct IsExpr< BasicDiagonalMatrix< Scalar > > : mpl::true_  {};
 
-	template<> struct IsExpr< LazyMatVecMult > : mpl::true_  {};
+	template<> struct IsExpr< VectorView > : mpl::true_  {};
+	template<> struct IsExpr< MatrixView > : mpl::true_  {};
 
-	template<> struct IsExpr< LazyMatDiagmatMatMult > : mpl::true_  {};
+	template<> struct IsExpr< MultiVector > : mpl::true_  {};
+
+	template< typename MatType, typename VecType >
+	struct IsExpr< LazyMatVecMult< MatType, VecType > > : mpl::true_  {};
+
+	template< typename MatType, typename MultiVecType >
+	struct IsExpr< LazyMatMultiVecMult< MatType, MultiVecType > >
+		: mpl::true_  {};
+
+	template< typename PreType, typename PostType, typename DiagType >
+	struct IsExpr< LazyMatDiagmatMatMult< PreType, PostType, DiagType > >
+		: mpl::true_  {};
+
+	template< typename PreType, typename PostType, typename DiagType >
+	struct IsExpr< LazyTiledMatDiagmatMatMult< PreType, PostType, DiagType > >
+		: mpl::true_  {};
+
+	template< typename PreType, typename PostType, typename SimdTag >
+	struct IsExpr< LazyMatMatMult< PreType, PostType, SimdTag > >
+		: mpl::true_  {};
+
+	template< typename MatType, typename VecType >
+	struct IsExpr< LazyTiledMatVecMult< MatType, VecType > > : mpl::true_  {};
+
+	template< typename MatType >
+	struct IsExpr< TransposedMatrix< MatType > > : mpl::true_  {};
+
+	template< typename MatType, typename VecType >
+	struct IsExpr< LazyTransMatVecMult< MatType, VecType > > : mpl::true_  {};
 
 	// template<> struct IsExpr< LazyVectorMaker > : mpl::true_  {};
 	// template<> struct IsExpr< LazyMatrixMaker > : mpl::true_  {};
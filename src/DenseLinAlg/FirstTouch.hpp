@@ -0,0 +1,170 @@
+/*
+ * FirstTouch.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef DENSELINALG_FIRSTTOUCH_HPP_
+#define DENSELINALG_FIRSTTOUCH_HPP_
+
+#include <algorithm>
+#include <cstddef>
+
+#include <ParallelizationTypeTag/ParallelizationTypeTag.hpp>
+#include <ParallelizationTypeTag/Dispatch.hpp>
+#include <ParallelizationTypeTag/WorkStealingPool.hpp>
+
+#include <DenseLinAlg/Simd.hpp>
+
+//
+// Initializing the element buffers by the threads using them
+//
+// The operating system places a page on the NUMA node of the thread
+// writing it first. The buffers are thus initialized by the threads
+// which evaluate their elements in the kernels afterward.
+//
+// A buffer is regarded as numLines lines of lineSz elements,
+// like the major lines of a matrix, or the elements of a vector
+// for lineSz = 1 . The lines are divided among the threads
+// in the same way as the elements of a vector are in the kernels of
+// AssignVecExpr and AssignVector .
+//
+namespace DenseLinAlg {
+
+	namespace PTT = ParallelizationTypeTag;
+
+	// Calling body( first, last) on the ranges [ first, last ) of
+	// the lines of the threads of the parallelization type
+	struct ForEachLineBlock
+	{
+		template < typename Body, typename SimdTag >
+		void operator()( int numLines, const Body& body,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& ) const
+		{
+			body( 0, numLines);
+		}
+
+		// statically scheduled like the scalar kernels
+		template < typename Body >
+		void operator()( int numLines, const Body& body,
+			const PTT::SingleProcess< PTT::OpenMP< PTT::NoSIMD > >& ) const
+		{
+			#pragma omp parallel for schedule( static)
+			for (int l = 0; l < numLines; l++)
+				body( l, l + 1);
+		}
+
+		// the blocks of SimdBlockSize lines statically scheduled
+		// like the SIMD kernels
+		template < typename Body, typename SimdTag >
+		void operator()( int numLines, const Body& body,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >& ) const
+		{
+			const int numBlocks = ( numLines + SimdBlockSize - 1 ) / SimdBlockSize;
+			#pragma omp parallel for schedule( static)
+			for (int b = 0; b < numBlocks; b++)
+				body( b * SimdBlockSize,
+					std::min( ( b + 1 ) * SimdBlockSize, numLines) );
+		}
+
+		template < typename Body, typename SimdTag >
+		void operator()( int numLines, const Body& body,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >& ) const
+		{
+			PTT::WorkStealingPool::local().parallelForBlocks(
+				numLines, SimdBlockSize, body);
+		}
+
+		template < typename Body >
+		void operator()( int numLines, const Body& body,
+			const PTT::SingleProcess< PTT::Runtime >& ) const
+		{
+			PTT::dispatch( *this, numLines, body);
+		}
+
+		// the lines of this process
+		template < typename Body, typename Multithreading >
+		void operator()( int numLines, const Body& body,
+			const PTT::MPI< Multithreading >& ) const
+		{
+			(*this)( numLines, body, PTT::SingleProcess< Multithreading >() );
+		}
+	};
+
+
+	// filling the buffer data by val
+	struct FillLines
+	{
+		template < typename Scalar, typename ParallelizationType >
+		void operator()( Scalar* data, int numLines, int lineSz,
+				const Scalar& val, const ParallelizationType& pt) const
+		{
+			const std::size_t n = lineSz;
+			ForEachLineBlock()( numLines,
+				[data, n, &val]( int first, int last) {
+					std::fill( data + first * n, data + last * n, val);
+				}, pt);
+		}
+	};
+
+	// copying the buffer src into dst
+	struct CopyLines
+	{
+		template < typename Scalar, typename ParallelizationType >
+		void operator()( Scalar* dst, const Scalar* src,
+				int numLines, int lineSz, const ParallelizationType& pt) const
+		{
+			const std::size_t n = lineSz;
+			ForEachLineBlock()( numLines,
+				[dst, src, n]( int first, int last) {
+					std::copy( src + first * n, src + last * n, dst + first * n);
+				}, pt);
+		}
+	};
+
+	// Writing an element per page of the buffer data ,
+	// whose values are left unspecified.
+	// A single thread leaves the pages to the kernels.
+	struct TouchLines
+	{
+		static const std::size_t PageSize = 4096;
+
+		template < typename Scalar, typename SimdTag >
+		void operator()( Scalar*, int, int,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& ) const
+		{}
+
+		template < typename Scalar >
+		void operator()( Scalar* data, int numLines, int lineSz,
+			const PTT::SingleProcess< PTT::Runtime >& ) const
+		{
+			PTT::dispatch( *this, data, numLines, lineSz);
+		}
+
+		template < typename Scalar, typename Multithreading >
+		void operator()( Scalar* data, int numLines, int lineSz,
+			const PTT::MPI< Multithreading >& ) const
+		{
+			(*this)( data, numLines, lineSz,
+					PTT::SingleProcess< Multithreading >() );
+		}
+
+		template < typename Scalar, typename ParallelizationType >
+		void operator()( Scalar* data, int numLines, int lineSz,
+				const ParallelizationType& pt) const
+		{
+			const std::size_t n = lineSz,
+				stride = std::max< std::size_t >( PageSize / sizeof( Scalar), 1);
+			ForEachLineBlock()( numLines,
+				[data, n, stride]( int first, int last) {
+					for (std::size_t i = first * n; i < last * n; i += stride)
+						data[i] = Scalar();
+				}, pt);
+		}
+	};
+
+}
+
+
+#endif /* DENSELINALG_FIRSTTOUCH_HPP_ */
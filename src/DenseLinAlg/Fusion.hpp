@@ -0,0 +1,429 @@
+/*
+ * Fusion.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef DENSELINALG_FUSION_HPP_
+#define DENSELINALG_FUSION_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include <boost/proto/proto.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <ParallelizationTypeTag/Default.hpp>
+
+#include <DenseLinAlg/Grammar.hpp>
+#include <DenseLinAlg/MatrixVector.hpp>
+#include <DenseLinAlg/Reduction.hpp>
+
+
+namespace DenseLinAlg {
+
+	namespace proto = boost::proto;
+
+	namespace PTT = ParallelizationTypeTag;
+
+
+	// Meta function telling whether T is a vector or
+	// an elementwise vector expression, whose i'th element depends only on
+	// the i'th elements of the vectors in it
+	template < typename T >
+	struct IsVecMapOperand : proto::matches<
+		typename std::remove_reference<
+			typename proto::result_of::as_child< const T, Domain >::type
+		>::type,
+		VecMapGrammar > {};
+
+
+	// Vector assignment deferred until it is evaluated by fuse( )
+	template < typename AssignType, typename LhsType, typename Rhs >
+	class DeferredVecAssign
+	{
+		static_assert( IsVecMapOperand< Rhs >::value,
+			"Only elementwise vector expressions can be fused." );
+
+	private:
+		typedef VecReductionOperand< Rhs > RhsTraits;
+
+		LhsType& lhs;
+		typename RhsTraits::type rhs;
+
+	public:
+		// The rhs should be of the size of the lhs.
+		explicit DeferredVecAssign( LhsType& l, const Rhs& r) :
+			lhs( l), rhs( proto::as_child< Domain >( r) )
+		{
+			assert( lhs.size() == VecSizeGrammar()( rhs) );
+		}
+
+		int size() const { return lhs.size(); }
+
+		// exchanging the halos of the distributed matrix vector products,
+		// and releasing them after the evaluation
+		void exchangeHalos() const { HaloExchangeGrammar()( rhs, 0); }
+		void releaseHalos() const { HaloReleaseGrammar()( rhs, 0); }
+
+		// Every thread makes its own evaluator
+		// for the SIMD extension SimdTag .
+		template < typename SimdTag >
+		class Evaluator
+		{
+		private:
+			LhsType& lhs;
+			VecExprMemo memo;
+			typename RhsTraits::template lazy_type< SimdTag >::type lazy;
+
+		public:
+			explicit Evaluator( const DeferredVecAssign& a) :
+				lhs( a.lhs),
+				lazy( VecLazyGrammar< SimdTag >()( a.rhs, a.rhs, memo) ) {}
+
+			void operator()( int i) {
+				AssignType()( lhs(i), VecExprGrammar()( lazy( i) ) );
+			}
+		};
+	};
+
+	// Left hand side of a vector assignment deferred until fuse( )
+	template < typename LhsType >
+	class DeferredVec
+	{
+	private:
+		LhsType& lhs;
+
+	public:
+		explicit DeferredVec( LhsType& v) : lhs( v) {}
+
+		template < typename Rhs >
+		DeferredVecAssign< AssignFunctor, LhsType, Rhs >
+		operator=( const Rhs& rhs ) const {
+			return DeferredVecAssign< AssignFunctor, LhsType, Rhs >( lhs, rhs);
+		}
+
+		template < typename Rhs >
+		DeferredVecAssign< PlusAssignFunctor, LhsType, Rhs >
+		operator+=( const Rhs& rhs ) const {
+			return DeferredVecAssign< PlusAssignFunctor, LhsType, Rhs >(
+																lhs, rhs);
+		}
+
+		template < typename Rhs >
+		DeferredVecAssign< MinusAssignFunctor, LhsType, Rhs >
+		operator-=( const Rhs& rhs ) const {
+			return DeferredVecAssign< MinusAssignFunctor, LhsType, Rhs >(
+																lhs, rhs);
+		}
+	};
+
+	// deferring an assignment into a vector, like
+	// DLA::deferred( resid ) -= alpha * q
+	template < typename LhsType >
+	DeferredVec< LhsType > deferred( LhsType& v)
+	{
+		return DeferredVec< LhsType >( v);
+	}
+
+
+	// The result of a deferred assignment in fuse( )
+	struct NoResult {};
+
+	// Traits of the items of fuse( ) for
+	// accumulating the i'th elements of them in a thread,
+	// and combining the partial results of the threads
+	template < typename Item > struct FusedItem;
+
+	template < typename AssignType, typename LhsType, typename Rhs >
+	struct FusedItem< DeferredVecAssign< AssignType, LhsType, Rhs > >
+	{
+		typedef NoResult result_type;
+		template < typename SimdTag >
+		struct Evaluator
+		{
+			typedef typename DeferredVecAssign< AssignType, LhsType, Rhs
+									>::template Evaluator< SimdTag > type;
+		};
+
+		template < typename EvaluatorType >
+		static void accumulate( EvaluatorType& e, NoResult&, int i) { e( i); }
+		static void combine( NoResult&, const NoResult&) {}
+		template < typename ParallelizationType >
+		static void combineProcesses( NoResult&, const ParallelizationType&) {}
+		static NoResult finish( NoResult r) { return r; }
+	};
+
+	template < typename Reduction, typename Op >
+	struct FusedReductionItem
+	{
+		typedef typename Reduction::result_type result_type;
+		template < typename SimdTag >
+		struct Evaluator
+		{
+			typedef typename Reduction::template Evaluator< SimdTag > type;
+		};
+
+		template < typename EvaluatorType >
+		static void accumulate( EvaluatorType& e, result_type& acc, int i) {
+			Op::Combination::combine( acc, e( i) );
+		}
+		static void combine( result_type& total, const result_type& partial) {
+			Op::Combination::combine( total, partial);
+		}
+		template < typename ParallelizationType >
+		static void combineProcesses( result_type& total,
+									const ParallelizationType& pt) {
+			Op::Combination::combineProcesses( total, pt);
+		}
+		static result_type finish( result_type acc) {
+			return Op::finish( acc);
+		}
+	};
+
+	template < typename Op, typename E >
+	struct FusedItem< UnaryVecReduction< Op, E > >
+		: FusedReductionItem< UnaryVecReduction< Op, E >, Op >
+	{
+		static_assert( IsVecMapOperand< E >::value,
+			"Only elementwise vector expressions can be fused." );
+	};
+
+	template < typename Op, typename E1, typename E2 >
+	struct FusedItem< BinaryVecReduction< Op, E1, E2 > >
+		: FusedReductionItem< BinaryVecReduction< Op, E1, E2 >, Op >
+	{
+		static_assert( IsVecMapOperand< E1 >::value &&
+						IsVecMapOperand< E2 >::value,
+			"Only elementwise vector expressions can be fused." );
+	};
+
+
+	// Compile-time sequence of the indices of the items
+	template < std::size_t... I > struct IndexSequence {};
+
+	template < std::size_t N, std::size_t... I >
+	struct MakeIndexSequence : MakeIndexSequence< N - 1, N - 1, I... > {};
+
+	template < std::size_t... I >
+	struct MakeIndexSequence< 0, I... > { typedef IndexSequence< I... > type; };
+
+
+	// Function object evaluating the items of fuse( ) in a single loop.
+	// The i'th elements of the items are evaluated in the order of
+	// the items, so that a reduction after an assignment
+	// reads the assigned element.
+	struct FuseVecExprs
+	{
+		// The combined results of the reductions are finished
+		// after accumulated by the multithreading type,
+		// which is specified at run time by PTT::Runtime .
+		template < typename Multithreading, typename... Items,
+					std::size_t... I >
+		typename std::enable_if<
+			! std::is_same< Multithreading, PTT::Runtime >::value,
+			std::tuple< typename FusedItem< Items >::result_type... >
+		>::type
+		operator()( const std::tuple< const Items&... >& items,
+			IndexSequence< I... > indices,
+			const PTT::SingleProcess< Multithreading >& pt)
+		const
+		{
+			const std::tuple< typename FusedItem< Items >::result_type... >
+				total = accumulate( items, indices, pt);
+			return std::tuple< typename FusedItem< Items >::result_type... >(
+				FusedItem< Items >::finish( std::get< I >( total) )... );
+		}
+
+		template < typename... Items, std::size_t... I >
+		std::tuple< typename FusedItem< Items >::result_type... >
+		operator()( const std::tuple< const Items&... >& items,
+			IndexSequence< I... > indices,
+			const PTT::SingleProcess< PTT::Runtime >& )
+		const
+		{
+			return PTT::dispatch( *this, items, indices);
+		}
+
+		// The rows of every process are accumulated by the kernels of
+		// the multithreading type, and the results of the processes
+		// are combined.
+		template < typename Multithreading, typename... Items,
+					std::size_t... I >
+		std::tuple< typename FusedItem< Items >::result_type... >
+		operator()( const std::tuple< const Items&... >& items,
+			IndexSequence< I... > indices, const PTT::MPI< Multithreading >& pt)
+		const
+		{
+			const int exchanged[] = {
+				( std::get< I >( items).exchangeHalos(), 0 )... };
+			(void) exchanged;
+			std::tuple< typename FusedItem< Items >::result_type... > total =
+				accumulate( items, indices,
+							PTT::SingleProcess< Multithreading >() );
+			const int released[] = {
+				( std::get< I >( items).releaseHalos(), 0 )... };
+			(void) released;
+			const int inOrder[] = { ( FusedItem< Items >::combineProcesses(
+				std::get< I >( total), pt), 0 )... };
+			(void) inOrder;
+			return std::tuple< typename FusedItem< Items >::result_type... >(
+				FusedItem< Items >::finish( std::get< I >( total) )... );
+		}
+
+	private:
+		template < typename SimdTag, typename... Items, std::size_t... I >
+		std::tuple< typename FusedItem< Items >::result_type... >
+		accumulate( const std::tuple< const Items&... >& items,
+			IndexSequence< I... >,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& )
+		const
+		{
+			std::tuple< typename FusedItem< Items >::template Evaluator<
+							SimdTag >::type... > evals( std::get< I >( items)... );
+			std::tuple< typename FusedItem< Items >::result_type... > accs;
+
+			const int sz = std::get< 0 >( items).size();
+			for (int i = 0; i < sz; i++) {
+				const int inOrder[] = { ( FusedItem< Items >::accumulate(
+						std::get< I >( evals), std::get< I >( accs), i), 0 )... };
+				(void) inOrder;
+			}
+			return accs;
+		}
+
+		// Every thread stores its partial results into its own slot,
+		// and the slots are combined once after the parallel region
+		// in the order of the threads.
+		template < typename SimdTag, typename... Items, std::size_t... I >
+		std::tuple< typename FusedItem< Items >::result_type... >
+		accumulate( const std::tuple< const Items&... >& items,
+			IndexSequence< I... >,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >& )
+		const
+		{
+			typedef std::tuple< typename FusedItem< Items >::result_type... >
+				Results;
+
+#ifdef _OPENMP
+			std::vector< Results > partials( omp_get_max_threads() );
+#else
+			std::vector< Results > partials( 1);
+#endif
+
+			const int sz = std::get< 0 >( items).size();
+			#pragma omp parallel
+			{
+#ifdef _OPENMP
+				const int t = omp_get_thread_num();
+#else
+				const int t = 0;
+#endif
+				std::tuple< typename FusedItem< Items >::template Evaluator<
+							SimdTag >::type... > evals( std::get< I >( items)... );
+				Results accs;
+
+				#pragma omp for
+				for (int i = 0; i < sz; i++) {
+					const int inOrder[] = { ( FusedItem< Items >::accumulate(
+						std::get< I >( evals), std::get< I >( accs), i), 0 )... };
+					(void) inOrder;
+				}
+				partials[t] = accs;
+			}
+
+			Results total;
+			for (const Results& partial : partials) {
+				const int inOrder[] = { ( FusedItem< Items >::combine(
+					std::get< I >( total), std::get< I >( partial) ), 0 )... };
+				(void) inOrder;
+			}
+			return total;
+		}
+
+		// The partial results of the blocks are combined in order,
+		// so that the reductions do not depend on the threads.
+		// Every worker makes its own evaluators used by the tasks it runs.
+		template < typename SimdTag, typename... Items, std::size_t... I >
+		std::tuple< typename FusedItem< Items >::result_type... >
+		accumulate( const std::tuple< const Items&... >& items,
+			IndexSequence< I... >,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >& )
+		const
+		{
+			typedef std::tuple< typename FusedItem< Items >::result_type... >
+				Results;
+
+			typedef std::tuple< typename FusedItem< Items >::template Evaluator<
+							SimdTag >::type... > Evaluators;
+
+			PTT::WorkStealingPool& pool = PTT::WorkStealingPool::local();
+			PTT::WorkerStates< Evaluators > evaluators( pool);
+			return pool.reduceBlocks(
+				std::get< 0 >( items).size(), SimdBlockSize, Results(),
+				[&items, &evaluators]( int first, int last, Results* partials) {
+					evaluators.run(
+						[&items]() {
+							return new Evaluators( std::get< I >( items)... ); },
+						[first, last, partials]( Evaluators& evals) {
+							Results* p = partials;
+							for (int b = first; b < last; b += SimdBlockSize) {
+								const int end = std::min( b + SimdBlockSize, last);
+								Results accs;
+								for (int i = b; i < end; i++) {
+									const int inOrder[] = {
+										( FusedItem< Items >::accumulate(
+											std::get< I >( evals),
+											std::get< I >( accs), i), 0 )... };
+									(void) inOrder;
+								}
+								*p++ = accs;
+							}
+						} );
+				},
+				[]( Results& acc, const Results& partial) {
+					const int inOrder[] = { ( FusedItem< Items >::combine(
+						std::get< I >( acc), std::get< I >( partial) ), 0 )... };
+					(void) inOrder;
+				} );
+		}
+	};
+
+
+	// Evaluating the deferred assignments and the reductions of
+	// elementwise vector expressions in a single loop, like
+	//
+	//   residAbs = std::get< 2 >( DLA::fuse( DLA::deferred( x ) += alpha * p,
+	//                        DLA::deferred( resid ) -= alpha * q,
+	//                        DLA::norm2( resid ) ) );
+	//
+	// All the items should have the same size.
+	// The results of the items are returned in a tuple, where
+	// those of the assignments are NoResult .
+	template < typename Item, typename... Items >
+	std::tuple< typename FusedItem< Item >::result_type,
+				typename FusedItem< Items >::result_type... >
+	fuse( const Item& item, const Items&... items )
+	{
+#ifndef NDEBUG
+		const int sizes[] = { item.size(), items.size()... };
+		for (int size : sizes) assert( size == sizes[0] );
+#endif
+
+		return FuseVecExprs()(
+			std::tuple< const Item&, const Items&... >( item, items... ),
+			typename MakeIndexSequence< 1 + sizeof...( Items ) >::type(),
+			PTT::Specified() );
+	}
+
+}
+
+
+#endif /* DENSELINALG_FUSION_HPP_ */
@@ -0,0 +1,266 @@
+/*
+ * Gemm.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef DENSELINALG_GEMM_HPP_
+#define DENSELINALG_GEMM_HPP_
+
+#include <algorithm>
+#include <type_traits>
+
+#include <boost/proto/proto.hpp>
+#include <boost/type_traits/remove_const.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+
+#include <ParallelizationTypeTag/ParallelizationTypeTag.hpp>
+
+#include <DenseLinAlg/MatrixVector.hpp>
+
+
+namespace DenseLinAlg {
+
+	namespace proto = boost::proto;
+
+	namespace PTT = ParallelizationTypeTag;
+
+
+	// Blocking of the matrix matrix multiplication by the kernel Ops ,
+	// SimdDoubleOps or void for the scalar code.
+	// A micro kernel computes mr x nr elements in the registers,
+	// reading the packed panels of mr rows of the left matrix and
+	// nr columns of the right matrix over depth elements.
+	// MatTileSize should be a multiple of mr and nr .
+	template < typename Ops >
+	struct GemmBlocking
+	{
+		static const int mr = 4, nr = 8, depth = 256;
+	};
+
+	template < typename SimdTag >
+	struct GemmBlocking< SimdDoubleOps< SimdTag > >
+	{
+		static const int mr = SimdDoubleOps< SimdTag >::panelRows,
+						nr = 2 * SimdDoubleOps< SimdTag >::width,
+						depth = 256;
+	};
+
+
+	// Micro kernels adding the product of the packed panels a and b
+	// into the mr x nr block of c, whose rows are ldc apart.
+	// The rows of a and b are packed k by k,
+	// a[ k * mr + r ] and b[ k * nr + l ] .
+	template < typename Scalar >
+	inline void gemmMicroKernel( int depth, const Scalar* a, const Scalar* b,
+								Scalar* c, int ldc, void* )
+	{
+		typedef GemmBlocking< void > Blocking;
+		Scalar acc[ Blocking::mr ][ Blocking::nr ] = {};
+		for (int k = 0; k < depth; k++) {
+			const Scalar* const ak = a + k * Blocking::mr;
+			const Scalar* const bk = b + k * Blocking::nr;
+			for (int r = 0; r < Blocking::mr; r++)
+				for (int l = 0; l < Blocking::nr; l++)
+					acc[r][l] += ak[r] * bk[l];
+		}
+		for (int r = 0; r < Blocking::mr; r++)
+			for (int l = 0; l < Blocking::nr; l++)
+				c[ r * ldc + l] += acc[r][l];
+	}
+
+	// The kernel of the SIMD extension, compiled for it in Simd.hpp
+	template < typename SimdTag >
+	inline void gemmMicroKernel( int depth, const double* a, const double* b,
+						double* c, int ldc, SimdDoubleOps< SimdTag >* )
+	{
+		SimdDoubleOps< SimdTag >::multiplyPanels( depth, a, b, c, ldc);
+	}
+
+
+	// Lazy function object for evaluating an element of
+	// the resultant matrix from the multiplication of two matrices,
+	// a tile at a time.
+	//
+	// The whole MatTileSize x MatTileSize tile containing
+	// the requested element is computed, and kept until an element of
+	// another tile is requested.
+	// For every depth elements of the inner index, the rows of the tile
+	// in pre and its columns in post are packed into contiguous panels,
+	// whose products are accumulated by the micro kernel of
+	// the SIMD extension SimdTag .
+	// Every thread should make its own object.
+	template < typename PreType, typename PostType, typename SimdTag >
+	struct LazyMatMatMult
+	{
+		PreType const & pre;
+		PostType const & post;
+		const int sz;
+
+		typedef typename PromotedScalar< typename PreType::value_type,
+					typename PostType::value_type >::type result_type;
+
+		typedef typename SimdOpsOf< result_type, SimdTag >::type Ops;
+		typedef GemmBlocking< Ops > Blocking;
+
+		// the first row and column of the cached tile
+		mutable int cachedRow, cachedCol;
+		mutable BasicVector< result_type > tileCache;
+		// the packed panels of the rows of the cached tile in pre and
+		// those of its columns in post, for all the inner indices.
+		// The panels are kept while the next tile is in the same rows
+		// or columns, since AssignMatExpr visits the tiles
+		// in a column of tiles one after another.
+		mutable int packedRow, packedCol;
+		mutable BasicVector< result_type > prePanels, postPanels;
+
+		explicit LazyMatMatMult(PreType const & pre_, PostType const & post_) :
+			pre( pre_), post( post_), sz( pre_.columnSize()),
+			cachedRow( - MatTileSize), cachedCol( - MatTileSize),
+			tileCache( MatTileSize * MatTileSize),
+			packedRow( - MatTileSize), packedCol( - MatTileSize),
+			prePanels( MatTileSize * sz), postPanels( MatTileSize * sz)
+		{}
+
+		LazyMatMatMult( LazyMatMatMult const & lazy) :
+			pre( lazy.pre), post( lazy.post), sz( lazy.sz),
+			cachedRow( - MatTileSize), cachedCol( - MatTileSize),
+			tileCache( MatTileSize * MatTileSize),
+			packedRow( - MatTileSize), packedCol( - MatTileSize),
+			prePanels( MatTileSize * sz), postPanels( MatTileSize * sz)
+		{}
+
+		~LazyMatMatMult();
+
+		// packing the rows of the tile, padded with zeros
+		// to a multiple of mr . The panels for depth inner indices
+		// from kBegin start at prePanels( kBegin * MatTileSize ) .
+		void packPrePanels( int tileRow, int rowSz) const
+		{
+			for (int kBegin = 0; kBegin < sz; kBegin += Blocking::depth) {
+				const int depth = std::min( int( Blocking::depth), sz - kBegin);
+				result_type* const a = &prePanels( kBegin * MatTileSize);
+				for (int ir = 0; ir < rowSz; ir += Blocking::mr)
+					for (int k = 0; k < depth; k++)
+						for (int r = 0; r < Blocking::mr; r++)
+							a[ ir * depth + k * Blocking::mr + r] =
+								ir + r < rowSz ?
+									result_type( pre( tileRow + ir + r,
+														kBegin + k) ) :
+									result_type( 0);
+			}
+			packedRow = tileRow;
+		}
+
+		// packing the columns of the tile, padded with zeros
+		// to a multiple of nr , in the same way as the rows
+		void packPostPanels( int tileCol, int colSz) const
+		{
+			const int fullSz = colSz - colSz % Blocking::nr;
+			for (int kBegin = 0; kBegin < sz; kBegin += Blocking::depth) {
+				const int depth = std::min( int( Blocking::depth), sz - kBegin);
+				result_type* const b = &postPanels( kBegin * MatTileSize);
+				for (int k = 0; k < depth; k++) {
+					for (int jr = 0; jr < fullSz; jr += Blocking::nr) {
+						result_type* const bk = b + jr * depth + k * Blocking::nr;
+						for (int l = 0; l < Blocking::nr; l++)
+							bk[l] = post( kBegin + k, tileCol + jr + l);
+					}
+					if ( fullSz < colSz ) {
+						result_type* const bk =
+							b + fullSz * depth + k * Blocking::nr;
+						for (int l = 0; l < Blocking::nr; l++)
+							bk[l] = fullSz + l < colSz ?
+								result_type( post( kBegin + k,
+												tileCol + fullSz + l) ) :
+								result_type( 0);
+					}
+				}
+			}
+			packedCol = tileCol;
+		}
+
+		void computeTile( int tileRow, int tileCol) const
+		{
+			const int rowSz = std::min( MatTileSize, pre.rowSize() - tileRow),
+					colSz = std::min( MatTileSize,
+										post.columnSize() - tileCol);
+			result_type* const tile = &tileCache( 0);
+			for (int i = 0; i < MatTileSize * MatTileSize; i++)
+				tile[i] = 0.0;
+
+			if ( tileRow != packedRow ) packPrePanels( tileRow, rowSz);
+			if ( tileCol != packedCol ) packPostPanels( tileCol, colSz);
+
+			for (int kBegin = 0; kBegin < sz; kBegin += Blocking::depth) {
+				const int depth = std::min( int( Blocking::depth), sz - kBegin);
+				const result_type* const a = &prePanels( kBegin * MatTileSize);
+				const result_type* const b = &postPanels( kBegin * MatTileSize);
+				// A panel of post is reused by all the panels of pre.
+				for (int jr = 0; jr < colSz; jr += Blocking::nr)
+					for (int ir = 0; ir < rowSz; ir += Blocking::mr)
+						gemmMicroKernel( depth, a + ir * depth, b + jr * depth,
+							tile + ir * MatTileSize + jr, MatTileSize,
+							(Ops*)nullptr );
+			}
+
+			cachedRow = tileRow;
+			cachedCol = tileCol;
+		}
+
+		result_type operator()(int ri, int ci) const
+		{
+			if ( ri < cachedRow || ri >= cachedRow + MatTileSize ||
+					ci < cachedCol || ci >= cachedCol + MatTileSize )
+				computeTile( ri - ri % MatTileSize, ci - ci % MatTileSize);
+			return tileCache( ( ri - cachedRow) * MatTileSize +
+								ci - cachedCol);
+		}
+	};
+
+
+	// out of the class, since it is called on the unlikely paths
+	// of the exceptions, where it is not inlined
+	template < typename PreType, typename PostType, typename SimdTag >
+	LazyMatMatMult< PreType, PostType, SimdTag >::~LazyMatMatMult() = default;
+
+
+	// Callable transform object to make the lazy functor
+	// a proto exression for evaluationg the multiplication
+	// of two matrices a tile at a time
+	// by the kernel of the SIMD extension given last
+	struct MatMatMult : proto::callable
+	{
+		template < typename Sig > struct result;
+
+		template < typename This, typename PreType, typename PostType,
+					typename SimdTag >
+		struct result< This( PreType, PostType, SimdTag) >
+		{
+			typedef typename proto::terminal< LazyMatMatMult<
+				typename boost::remove_const<
+					typename boost::remove_reference< PreType >::type
+				>::type,
+				typename boost::remove_const<
+					typename boost::remove_reference< PostType >::type
+				>::type,
+				typename std::decay< SimdTag >::type
+			> >::type type;
+		};
+
+		template < typename PreType, typename PostType, typename SimdTag >
+		typename proto::terminal<
+			LazyMatMatMult< PreType, PostType, SimdTag > >::type
+		operator()( PreType const& pre, PostType const& post,
+					const SimdTag& ) const
+		{
+			return proto::as_expr(
+					LazyMatMatMult< PreType, PostType, SimdTag >(pre, post) );
+		}
+	};
+
+}
+
+
+#endif /* DENSELINALG_GEMM_HPP_ */
@@ -12,28 +12,238 @@
 #include <boost/proto/proto.hpp>
 
 
+namespace SparseLinAlg {
+
+	class CsrMatrix;
+	class BandedMatrix;
+	class SellMatrix;
+	class DistCsrMatrix;
+
+	// Callable transform objects to make a proto exression
+	// for lazily evaluating sparse matrix vector multiplication
+	struct CsrMatVecMult;
+	struct BandedMatVecMult;
+	struct SellMatVecMult;
+	struct DistCsrMatVecMult;
+
+	// Callable transform object exchanging the halo of a vector
+	// multiplied by a distributed CSR matrix
+	struct DistCsrExchangeHalo;
+	struct DistCsrReleaseHalo;
+
+	// Callable transform object to make a proto expression
+	// evaluating SELL sparse matrix vector multiplication a window at a time
+	struct SellWindowMatVecMult;
+	template < typename VecType, typename SimdTag >
+	struct LazySellWindowMatVecMult;
+
+	// Callable transform object to make a proto expression
+	// for lazily evaluating CSR sparse matrix multivector multiplication
+	struct CsrMatMultiVecMult;
+}
+
 namespace DenseLinAlg {
 
 	namespace mpl = boost::mpl;
 	namespace proto = boost::proto;
 
-	class Vector;
-	class Matrix;
-	class DiagonalMatrix;
+	// The containers are templated on the type of their elements, and
+	// those of any scalar type are matched by the grammars below.
+	// The elements of different types are promoted in the evaluation,
+	// e.g. float matrix * double vector is accumulated in double.
+	template < typename Scalar > class BasicVector;
+	typedef BasicVector< double > Vector;
+
+	template < typename Scalar > class BasicDiagonalMatrix;
+	typedef BasicDiagonalMatrix< double > DiagonalMatrix;
+
+	// Dense matrices in any layout are matched by
+	// BasicMatrix< proto::_, proto::_ > .
+	struct RowMajor;
+	template < typename Layout, typename Scalar = double > class BasicMatrix;
+	typedef BasicMatrix< RowMajor > Matrix;
+
+	// Non-owning views of external arrays
+	class VectorView;
+	class MatrixView;
+
+	// Set of vectors of the same size stored interleaved
+	class MultiVector;
+
+
+	// The grammar for scalar terminals
+	struct ScalarTermGrammar : proto::or_<
+		proto::terminal< float >,
+		proto::terminal< double >,
+		proto::terminal< long double >
+	> {};
+
+	// The grammar for diagonal matrix terminals
+	struct DiagMatTermGrammar :
+		proto::terminal< BasicDiagonalMatrix< proto::_ > > {};
+
+	template < typename Expr > struct LazyMemoVecExpr;
+	struct MemoVecExpr;
+	template < typename Scalar > class TempVector;
+	template < typename MatType, typename VecType >
+	struct LazyTiledMatVecMult;
+	struct TiledMatVecMult;
+
+	// The grammar for vector terminals, owning their buffers or not,
+	// for the temporaries made by VecPlanGrammar , and
+	// for the tiled dense and the windowed SELL matrix vector products and
+	// the memorized subexpressions made by VecLazyGrammar
+	struct VecTermGrammar : proto::or_<
+		proto::terminal< BasicVector< proto::_ > >,
+		proto::terminal< VectorView >,
+		proto::terminal< TempVector< proto::_ > >,
+		proto::terminal< LazyTiledMatVecMult< proto::_, proto::_ > >,
+		proto::terminal<
+			SparseLinAlg::LazySellWindowMatVecMult< proto::_, proto::_ > >,
+		proto::terminal< LazyMemoVecExpr< proto::_ > >
+	> {};
+
+	// The grammar for dense matrix terminals, owning their buffers or not
+	struct MatTermGrammar : proto::or_<
+		proto::terminal< BasicMatrix< proto::_, proto::_ > >,
+		proto::terminal< MatrixView >
+	> {};
 
 
 	// Callable transform object to make a proto exression
 	// for lazily evaluating multiplication
 	struct MatVecMult;
 	// struct MatVecMultOmp;
+	struct MatVecExprMult;
+	struct TransMatVecMult;
+
+	// Transpose of a matrix, made by trans( )
+	template < typename MatType > class TransposedMatrix;
+
+	// The grammar for the multiplication of a CSR sparse matrix and a vector
+	struct CsrMatVecMultGrammar : proto::or_<
+		proto::when<
+			proto::multiplies< proto::terminal< SparseLinAlg::CsrMatrix > ,
+								VecTermGrammar >,
+			SparseLinAlg::CsrMatVecMult( proto::_value( proto::_left),
+										proto::_value( proto::_right) )
+		>
+	> {};
+
+	// The grammar for the multiplication of a banded matrix and a vector
+	struct BandedMatVecMultGrammar : proto::or_<
+		proto::when<
+			proto::multiplies< proto::terminal< SparseLinAlg::BandedMatrix > ,
+								VecTermGrammar >,
+			SparseLinAlg::BandedMatVecMult( proto::_value( proto::_left),
+											proto::_value( proto::_right) )
+		>
+	> {};
+
+	// The grammar for the multiplication of a SELL matrix and a vector
+	struct SellMatVecMultGrammar : proto::or_<
+		proto::when<
+			proto::multiplies< proto::terminal< SparseLinAlg::SellMatrix > ,
+								VecTermGrammar >,
+			SparseLinAlg::SellMatVecMult( proto::_value( proto::_left),
+										proto::_value( proto::_right) )
+		>
+	> {};
+
+	// The grammar for the multiplication of
+	// a distributed CSR matrix and a vector
+	struct DistCsrMatVecMultGrammar : proto::or_<
+		proto::when<
+			proto::multiplies< proto::terminal< SparseLinAlg::DistCsrMatrix > ,
+								VecTermGrammar >,
+			SparseLinAlg::DistCsrMatVecMult( proto::_value( proto::_left),
+											proto::_value( proto::_right) )
+		>
+	> {};
 
 	// The grammar for the multiplication of a matrix and a vector
 	struct MatVecMultGrammar : proto::or_<
 		proto::when<
-			proto::multiplies< proto::terminal< Matrix> ,
-								proto::terminal< Vector> >,
+			proto::multiplies< MatTermGrammar ,
+								VecTermGrammar >,
 			MatVecMult( proto::_value( proto::_left),
 						proto::_value( proto::_right) )
+		>,
+
+		// CsrMatrix * Vector
+		CsrMatVecMultGrammar,
+
+		// BandedMatrix * Vector
+		BandedMatVecMultGrammar,
+
+		// SellMatrix * Vector
+		SellMatVecMultGrammar,
+
+		// DistCsrMatrix * Vector
+		DistCsrMatVecMultGrammar
+	> {};
+
+	// The transformation rule exchanging the halos of the vectors
+	// multiplied by the distributed matrices in an expression,
+	// before its rows are evaluated by the threads.
+	// The state is returned as it is.
+	struct HaloExchangeGrammar : proto::or_<
+		proto::when<
+			proto::multiplies< proto::terminal< SparseLinAlg::DistCsrMatrix > ,
+								VecTermGrammar >,
+			SparseLinAlg::DistCsrExchangeHalo( proto::_value( proto::_left),
+										proto::_value( proto::_right),
+										proto::_state )
+		>,
+		proto::when< proto::terminal< proto::_ >, proto::_state >,
+		proto::when<
+			proto::nary_expr< proto::_, proto::vararg< HaloExchangeGrammar > >,
+			proto::fold< proto::_, proto::_state, HaloExchangeGrammar >
+		>
+	> {};
+
+	// The transformation rule releasing the halos exchanged by
+	// HaloExchangeGrammar after the expression is evaluated.
+	// The state is returned as it is.
+	struct HaloReleaseGrammar : proto::or_<
+		proto::when<
+			proto::multiplies< proto::terminal< SparseLinAlg::DistCsrMatrix > ,
+								VecTermGrammar >,
+			SparseLinAlg::DistCsrReleaseHalo( proto::_value( proto::_left),
+										proto::_value( proto::_right),
+										proto::_state )
+		>,
+		proto::when< proto::terminal< proto::_ >, proto::_state >,
+		proto::when<
+			proto::nary_expr< proto::_, proto::vararg< HaloReleaseGrammar > >,
+			proto::fold< proto::_, proto::_state, HaloReleaseGrammar >
+		>
+	> {};
+
+	// The grammar for the multiplication of the transpose of
+	// a matrix of any type and a vector
+	struct TransMatVecMultGrammar : proto::multiplies<
+		proto::terminal< TransposedMatrix< proto::_ > >,
+		VecTermGrammar
+	> {};
+
+	struct ComputeTransProduct;
+
+	// The transformation rule computing the products of the transposes of
+	// the matrices and the vectors in an expression at once,
+	// by the threads given as the data,
+	// before its elements are evaluated by the threads.
+	// The state is returned as it is.
+	struct TransProductGrammar : proto::or_<
+		proto::when< TransMatVecMultGrammar,
+			ComputeTransProduct( proto::_value( proto::_left),
+								proto::_value( proto::_right),
+								proto::_state, proto::_data )
+		>,
+		proto::when< proto::terminal< proto::_ >, proto::_state >,
+		proto::when<
+			proto::nary_expr< proto::_, proto::vararg< TransProductGrammar > >,
+			proto::fold< proto::_, proto::_state, TransProductGrammar >
 		>
 	> {};
 
@@ -45,14 +255,14 @@ namespace DenseLinAlg {
 	// Elemenetwise type expression
 	struct VecMapElmGrammar : proto::or_<
 		// Vector
-		proto::when< proto::terminal< Vector >,
+		proto::when< VecTermGrammar,
 					proto::_make_function( proto::_, proto::_state) >,
 
 
 		// Vector * double
 		proto::when<
-			proto::multiplies< proto::terminal< Vector > ,
-							proto::terminal< double > >,
+			proto::multiplies< VecTermGrammar ,
+							ScalarTermGrammar >,
 			proto::_make_multiplies(
 				proto::_make_function( proto::_left, proto::_state),
 				proto::_right
@@ -60,8 +270,8 @@ namespace DenseLinAlg {
 		>,
 		// double * Vector
 		proto::when<
-			proto::multiplies< proto::terminal< double >,
-							proto::terminal< Vector > >,
+			proto::multiplies< ScalarTermGrammar,
+							VecTermGrammar >,
 			proto::_make_multiplies(
 				proto::_left,
 				proto::_make_function( proto::_right, proto::_state)
@@ -70,8 +280,8 @@ namespace DenseLinAlg {
 
 		// DiagonalMatrix * Vector
 		proto::when<
-			proto::multiplies< proto::terminal< DiagonalMatrix >,
-						   	   proto::terminal< Vector > >,
+			proto::multiplies< DiagMatTermGrammar,
+						   	   VecTermGrammar >,
 			proto::_make_multiplies(
 				proto::_make_function( proto::_left, proto::_state),
 				proto::_make_function( proto::_right, proto::_state)
@@ -84,13 +294,54 @@ namespace DenseLinAlg {
 	> {};
 
 
-	// Reduction type expression
-	struct VecMapReduceElmGrammar : proto::or_<
+	struct VecExprGrammar;
+	struct VecMapReduceElmGrammar;
+
+	// Reduction type expression multiplied by a matrix
+	struct VecMatMultElmGrammar : proto::or_<
 		// Matrix * Vector
 		proto::when< MatVecMultGrammar,
 					proto::_make_function( MatVecMultGrammar( proto::_),
 											proto::_state) >,
 
+		// Matrix * VecExprGrammar , inlining the elements of the operand
+		proto::when<
+			proto::multiplies< MatTermGrammar, VecExprGrammar >,
+			proto::_make_function(
+				MatVecExprMult( proto::_value( proto::_left), proto::_right),
+				proto::_state)
+		>,
+
+		// trans( Matrix ) * Vector , scattering the whole product at once
+		proto::when< TransMatVecMultGrammar,
+			proto::_make_function(
+				TransMatVecMult( proto::_value( proto::_left),
+								proto::_value( proto::_right) ),
+				proto::_state)
+		>,
+
+		// DiagonalMatrix * VecMapReduceElmGrammar
+		proto::when<
+			proto::multiplies< DiagMatTermGrammar,
+								VecMapReduceElmGrammar >,
+			proto::_make_multiplies(
+				proto::_make_function( proto::_left, proto::_state),
+				VecMapReduceElmGrammar( proto::_right)
+			)
+		>
+	> {};
+
+	// Reduction type expression
+	struct VecMapReduceElmGrammar : proto::or_<
+		// Matrix * Vector , Matrix * VecExprGrammar ,
+		// trans( Matrix ) * Vector ,
+		// DiagonalMatrix * VecMapReduceElmGrammar
+		VecMatMultElmGrammar,
+
+		// double * VecMapReduceElmGrammar , VecMapReduceElmGrammar * double
+		proto::multiplies< ScalarTermGrammar, VecMapReduceElmGrammar > ,
+		proto::multiplies< VecMapReduceElmGrammar, ScalarTermGrammar > ,
+
 		// VecMapReduceElmGrammar +(-) VecMapReduceElmGrammar
 		proto::plus< VecMapReduceElmGrammar, VecMapReduceElmGrammar > ,
 		proto::minus< VecMapReduceElmGrammar, VecMapReduceElmGrammar > ,
@@ -116,20 +367,20 @@ namespace DenseLinAlg {
 		>,
 
 		// Vector
-		proto::terminal< Vector >,
+		VecTermGrammar,
 
 		// VecElementwiseGrammar +(-) VecMapGrammar
 		proto::plus< VecMapGrammar, VecMapGrammar > ,
 		proto::minus< VecMapGrammar, VecMapGrammar >,
 
 		// Vector * double , or double * Vector
-		proto::multiplies< proto::terminal< Vector > ,
-						proto::terminal< double > >,
-		proto::multiplies< proto::terminal< double >,
-						proto::terminal< Vector > >,
+		proto::multiplies< VecTermGrammar ,
+						ScalarTermGrammar >,
+		proto::multiplies< ScalarTermGrammar,
+						VecTermGrammar >,
 
 		// DiagonalMatrix * VecExprGrammar
-		proto::multiplies< proto::terminal< DiagonalMatrix >,
+		proto::multiplies< DiagMatTermGrammar,
 							VecMapGrammar >
 	> {};
 
@@ -155,8 +406,20 @@ namespace DenseLinAlg {
 		proto::plus< VecMapGrammar, VecMapReduceGrammar > ,
 		proto::minus< VecMapGrammar, VecMapReduceGrammar >,
 
-		// Matrix * Vector
-		MatVecMultGrammar //,
+		// double * VecMapReduceGrammar , VecMapReduceGrammar * double
+		proto::multiplies< ScalarTermGrammar, VecMapReduceGrammar > ,
+		proto::multiplies< VecMapReduceGrammar, ScalarTermGrammar > ,
+
+		proto::or_<
+			// Matrix * Vector
+			MatVecMultGrammar,
+			// DiagonalMatrix * VecMapReduceGrammar
+			proto::multiplies< DiagMatTermGrammar, VecMapReduceGrammar > ,
+			// Matrix * VecExprGrammar
+			proto::multiplies< MatTermGrammar, VecExprGrammar >,
+			// trans( Matrix ) * Vector
+			TransMatVecMultGrammar
+		>
 	> {};
 
 
@@ -167,15 +430,109 @@ namespace DenseLinAlg {
 		// VecReductionOmpGrammar
 	> {};
 
+	// Callable transform objects returning the size of a vector and
+	// the number of the rows of a matrix
+	struct VecSize;
+	struct MatRowSize;
+
+	// The transformation rule for the size of a vector expression,
+	// which is that of its leftmost vector or the row size of
+	// its leftmost matrix.
+	// The operands of the reductions dot( ), norm2( ), sum( ) and max_abs( )
+	// are sized by this rule.
+	struct VecSizeGrammar : proto::or_<
+		proto::when< VecTermGrammar, VecSize( proto::_value) >,
+
+		// Scalar * VecSizeGrammar , VecSizeGrammar * Scalar
+		proto::when< proto::multiplies< ScalarTermGrammar, VecSizeGrammar >,
+					VecSizeGrammar( proto::_right) >,
+		proto::when< proto::multiplies< VecSizeGrammar, ScalarTermGrammar >,
+					VecSizeGrammar( proto::_left) >,
+
+		// DiagonalMatrix * VecSizeGrammar
+		proto::when< proto::multiplies< DiagMatTermGrammar, proto::_ >,
+					VecSize( proto::_value( proto::_left) ) >,
+
+		// Matrix * Vector for any matrix type
+		proto::when< proto::multiplies< proto::terminal< proto::_ >,
+										VecTermGrammar >,
+					MatRowSize( proto::_value( proto::_left) ) >,
+
+		// Matrix * VecExprGrammar
+		proto::when< proto::multiplies< MatTermGrammar, proto::_ >,
+					MatRowSize( proto::_value( proto::_left) ) >,
+
+		// VecSizeGrammar +(-) VecExprGrammar
+		proto::when< proto::plus< VecSizeGrammar, proto::_ >,
+					VecSizeGrammar( proto::_left) >,
+		proto::when< proto::minus< VecSizeGrammar, proto::_ >,
+					VecSizeGrammar( proto::_left) >
+	> {};
+
+	// The transformation rule replacing the dense and SELL matrix vector
+	// multiplications in a vector expression by terminals of
+	// lazy function objects, which compute a strip of rows at once
+	// tile by tile of the columns, and a window of rows at once
+	// by the kernels of the SIMD extension SimdTag , respectively.
+	// The matrix vector multiplications repeated in the expression,
+	// like b - A * x + 0.5 * ( A * x ) , are also replaced by terminals
+	// evaluating each element only once.
+	// This transform accepts the whole expression as the state variable
+	// for finding the repeated subexpressions, and VecExprMemo as the data.
+	// The output is evaluated element by element with VecExprGrammar .
+	template < typename SimdTag >
+	struct VecLazyGrammar : proto::or_<
+		proto::when<
+			proto::multiplies< MatTermGrammar, VecTermGrammar >,
+			MemoVecExpr( proto::_, proto::_state, proto::_data,
+				TiledMatVecMult( proto::_value( proto::_left),
+								proto::_value( proto::_right) ) )
+		>,
+		proto::when<
+			proto::multiplies< proto::terminal< SparseLinAlg::SellMatrix >,
+								VecTermGrammar >,
+			MemoVecExpr( proto::_, proto::_state, proto::_data,
+				SparseLinAlg::SellWindowMatVecMult(
+					proto::_value( proto::_left),
+					proto::_value( proto::_right), SimdTag() ) )
+		>,
+		proto::when< MatVecMultGrammar,
+			MemoVecExpr( proto::_, proto::_state, proto::_data, proto::_ )
+		>,
+		proto::terminal< proto::_ >,
+		proto::nary_expr< proto::_, proto::vararg< VecLazyGrammar< SimdTag > > >
+	> {};
+
 
 	struct MatDiagmatMatMult;
 	// struct LazyMatDiagmatMatMult;
+	struct TiledMatDiagmatMatMult;
+	template < typename PreType, typename PostType, typename DiagType >
+	struct LazyTiledMatDiagmatMatMult;
+	struct MatMatMult;
+	template < typename PreType, typename PostType, typename SimdTag >
+	struct LazyMatMatMult;
 
 	// The transformation rule for matrix element expressions
 	struct MatElmGrammar : proto::or_<
 		// Matrix
 		proto::when<
-			proto::terminal< Matrix >,
+			MatTermGrammar,
+			proto::_make_function( proto::_,
+										proto::_state, proto::_data)
+		>,
+
+		// the tiled Matrix * DiagonalMatrix * Matrix made by MatLazyGrammar
+		proto::when<
+			proto::terminal< LazyTiledMatDiagmatMatMult<
+									proto::_, proto::_, proto::_ > >,
+			proto::_make_function( proto::_,
+										proto::_state, proto::_data)
+		>,
+
+		// the tiled Matrix * Matrix made by MatLazyGrammar
+		proto::when<
+			proto::terminal< LazyMatMatMult< proto::_, proto::_, proto::_ > >,
 			proto::_make_function( proto::_,
 										proto::_state, proto::_data)
 		>,
@@ -184,10 +541,10 @@ namespace DenseLinAlg {
 		proto::when<
 			proto::multiplies<
 				proto::multiplies<
-					proto::terminal< Matrix >,
-					proto::terminal< DiagonalMatrix >
+					MatTermGrammar,
+					DiagMatTermGrammar
 				>,
-				proto::terminal< Matrix >
+				MatTermGrammar
 			>,
 			proto::_make_function(
 				MatDiagmatMatMult(
@@ -208,7 +565,7 @@ namespace DenseLinAlg {
 	// with two indices
 	struct DiagMatElmTwoIdxGrammar : proto::or_<
 		// DiagonalMatrix
-		proto::when< proto::terminal< DiagonalMatrix>,
+		proto::when< DiagMatTermGrammar,
 					proto::_make_function( proto::_,
 											proto::_state, proto::_data) >,
 		// DiagMatElmTwoIdxGrammar +(-) DiagMatElmTwoIdxGrammar
@@ -220,7 +577,7 @@ namespace DenseLinAlg {
 	// with one index
 	struct DiagMatElmOneIdxGrammar : proto::or_<
 		// DiagonalMatrix
-		proto::when< proto::terminal< DiagonalMatrix>,
+		proto::when< DiagMatTermGrammar,
 					proto::_make_function( proto::_, proto::_state) >,
 		// DiagMatElmOneIdxGrammar +(-) DiagMatElmOneIdxGrammar
 		proto::plus< DiagMatElmOneIdxGrammar, DiagMatElmOneIdxGrammar >,
@@ -245,7 +602,7 @@ namespace DenseLinAlg {
 			)
 		>,
 		// DiagonalMatrix
-		proto::terminal< DiagonalMatrix >,
+		DiagMatTermGrammar,
 		// DiagMatExprGrammar +(-) DiagMatExprGrammar
 		proto::plus< DiagMatExprGrammar, DiagMatExprGrammar >,
 		proto::minus< DiagMatExprGrammar, DiagMatExprGrammar>
@@ -262,7 +619,7 @@ namespace DenseLinAlg {
 				)
 			>,
 		// Matrix
-		proto::terminal< Matrix >,
+		MatTermGrammar,
 		// MatExprGrammar * MatExprGrammar
 		proto::multiplies< MatExprGrammar, MatExprGrammar >,
 		// MatExprGrammar * DiagMatExprGrammar
@@ -274,11 +631,130 @@ namespace DenseLinAlg {
 		proto::minus< MatExprGrammar, MatExprGrammar>
 	> {};
 
+	// The grammar for the multiplication of two matrices,
+	// which is replaced by a terminal of the lazy function object
+	// computing a tile of the product at once by the blocked kernel
+	// of the SIMD extension SimdTag
+	template < typename SimdTag >
+	struct MatMatMultGrammar : proto::when<
+		proto::multiplies< MatTermGrammar, MatTermGrammar >,
+		MatMatMult( proto::_value( proto::_left),
+					proto::_value( proto::_right), SimdTag() )
+	> {};
+
+	// The transformation rule replacing the products of two matrices,
+	// and of a matrix and a diagonal matrix and a matrix
+	// in a matrix expression
+	// by terminals of lazy function objects, which compute
+	// a square tile of the product at once.
+	// The output is evaluated element by element with MatExprGrammar .
+	template < typename SimdTag >
+	struct MatLazyGrammar : proto::or_<
+		proto::when<
+			proto::multiplies<
+				proto::multiplies< MatTermGrammar, DiagMatTermGrammar >,
+				MatTermGrammar
+			>,
+			TiledMatDiagmatMatMult(
+					proto::_value( proto::_left( proto::_left ) ),
+					proto::_value( proto::_right( proto::_left) ),
+					proto::_value( proto::_right )
+			)
+		>,
+		MatMatMultGrammar< SimdTag >,
+		proto::terminal< proto::_ >,
+		proto::nary_expr< proto::_,
+							proto::vararg< MatLazyGrammar< SimdTag > > >
+	> {};
+
+	// Callable transform objects for evaluating multivector expressions
+	struct MatMultiVecMult;
+	struct MultiVecElement;
+	struct ScalarMult;
+
+	// The grammar for multivector expressions
+	struct MultiVecExprGrammar : proto::or_<
+		// MultiVector
+		proto::terminal< MultiVector >,
+		// Matrix * MultiVector
+		proto::multiplies< MatTermGrammar, proto::terminal< MultiVector > >,
+		// CsrMatrix * MultiVector
+		proto::multiplies< proto::terminal< SparseLinAlg::CsrMatrix >,
+							proto::terminal< MultiVector > >,
+		// DiagonalMatrix * MultiVecExprGrammar, scaling each row
+		proto::multiplies< DiagMatTermGrammar,
+							MultiVecExprGrammar >,
+		// MultiVecExprGrammar * DiagonalMatrix, scaling each vector
+		proto::multiplies< MultiVecExprGrammar,
+							DiagMatTermGrammar >,
+		// double * MultiVecExprGrammar, MultiVecExprGrammar * double
+		proto::multiplies< ScalarTermGrammar, MultiVecExprGrammar >,
+		proto::multiplies< MultiVecExprGrammar, ScalarTermGrammar >,
+		// MultiVecExprGrammar +(-) MultiVecExprGrammar
+		proto::plus< MultiVecExprGrammar, MultiVecExprGrammar >,
+		proto::minus< MultiVecExprGrammar, MultiVecExprGrammar >
+	> {};
+
+	// The transformation rule replacing matrix multivector multiplications
+	// by terminals of lazy function objects.
+	// Each of those objects computes all the vectors of a row at once,
+	// so that the matrix is read only once for the whole multivector.
+	struct MultiVecLazyGrammar : proto::or_<
+		proto::when<
+			proto::multiplies< MatTermGrammar,
+								proto::terminal< MultiVector > >,
+			MatMultiVecMult( proto::_value( proto::_left),
+							proto::_value( proto::_right) )
+		>,
+		proto::when<
+			proto::multiplies< proto::terminal< SparseLinAlg::CsrMatrix >,
+								proto::terminal< MultiVector > >,
+			SparseLinAlg::CsrMatMultiVecMult( proto::_value( proto::_left),
+											proto::_value( proto::_right) )
+		>,
+		proto::terminal< proto::_ >,
+		proto::nary_expr< proto::_, proto::vararg< MultiVecLazyGrammar > >
+	> {};
+
+	// The transformation rule evaluating an element of
+	// the output of MultiVecLazyGrammar .
+	// The row index and the vector index are passed
+	// as the state and the data variable respectively.
+	struct MultiVecElmGrammar : proto::or_<
+		proto::when< ScalarTermGrammar, proto::_value >,
+		// DiagonalMatrix * MultiVecElmGrammar
+		proto::when<
+			proto::multiplies< DiagMatTermGrammar,
+								MultiVecElmGrammar >,
+			ScalarMult( MultiVecElement( proto::_value( proto::_left),
+										proto::_state ),
+						MultiVecElmGrammar( proto::_right) )
+		>,
+		// MultiVecElmGrammar * DiagonalMatrix
+		proto::when<
+			proto::multiplies< MultiVecElmGrammar,
+								DiagMatTermGrammar >,
+			ScalarMult( MultiVecElmGrammar( proto::_left),
+						MultiVecElement( proto::_value( proto::_right),
+										proto::_data ) )
+		>,
+		// MultiVector and lazy function objects
+		proto::when< proto::terminal< proto::_ >,
+			MultiVecElement( proto::_value, proto::_state, proto::_data )
+		>,
+		proto::when<
+			proto::nary_expr< proto::_,
+								proto::vararg< MultiVecElmGrammar > >,
+			proto::_default< MultiVecElmGrammar >
+		>
+	> {};
+
 	// The tranformation rule for linear algebraic expressions
 	struct ExprGrammar : proto::or_<
 		VecExprGrammar,
 		MatExprGrammar,
-		DiagMatExprGrammar
+		DiagMatExprGrammar,
+		MultiVecExprGrammar
 	> {};
 
 	//
@@ -288,9 +764,26 @@ namespace DenseLinAlg {
 	struct VecMapTag : VecExprTag {};
 	// struct VecTermTag : VecMapTag {};
 	struct VecMapReduceTag : VecMapTag {};
+	// reduction type expressions with the subexpressions
+	// to be materialized by the cost model
+	struct VecMaterializeTag : VecMapReduceTag {};
+	// products of the transposed matrices and vectors
+	struct VecTransMultTag : VecMapReduceTag {};
+
+	// Meta function telling whether any subexpression of
+	// the expression is materialized
+	template < typename Expr > struct HasMaterialized;
 
 	// Meta function returning an instance of Vector expression type tag
 	struct VecExprTagGrammar : proto::or_<
+		proto::when< TransMatVecMultGrammar, VecTransMultTag() >,
+
+		proto::when<
+			proto::and_< VecMapReduceGrammar,
+						proto::if_< HasMaterialized< proto::_ >() > >,
+			VecMaterializeTag()
+		>,
+
 		proto::when<
 			VecMapReduceGrammar,
 			// proto::_make_function( VecMapReduceTag)
@@ -11,8 +11,12 @@
 
 #include <math.h>
 
+#include <algorithm>
 #include <iostream>
+#include <type_traits>
 #include <boost/proto/proto.hpp>
+#include <boost/type_traits/remove_const.hpp>
+#include <boost/type_traits/remove_reference.hpp>
 
 #include <ParallelizationTypeTag/Default.hpp>
 
@@ -28,6 +32,16 @@ namespace DenseLinAlg {
 
 
 
+	// The scalar type of the result of an arithmetic operation
+	// between the elements of the types A and B ,
+	// e.g. double for float and double
+	template < typename A, typename B >
+	struct PromotedScalar
+	{
+		typedef typename std::common_type< A, B >::type type;
+	};
+
+
 	// Lazy function object for evaluating an element of
 	// the resultant vector from the multiplication of
 	// matrix and vector objects.
@@ -35,17 +49,19 @@ namespace DenseLinAlg {
 	// An expression like ( matrix * vector )(index) is transformed
 	// into the loop for calculating the dot product between
 	// the index'th row of the matrix and the vector.
+	template < typename MatType, typename VecType >
 	struct LazyMatVecMult
 	{
-		Matrix const& m;
-		Vector const& v;
+		MatType const& m;
+		VecType const& v;
 		const int mColSz;
 
-		typedef double result_type;
+		typedef typename PromotedScalar< typename MatType::value_type,
+				typename VecType::value_type >::type result_type;
 		// typedef mpl::int_<1> proto_arity;
 
-		explicit LazyMatVecMult(Matrix const& mat, Vector const& vec) :
-			m( mat), v( vec), mColSz(mat.rowSize()) {}
+		explicit LazyMatVecMult(MatType const& mat, VecType const& vec) :
+			m( mat), v( vec), mColSz(mat.columnSize()) {}
 
 		LazyMatVecMult( LazyMatVecMult const& lazy) :
 			m(lazy.m), v(lazy.v), mColSz(lazy.mColSz) {}
@@ -65,12 +81,84 @@ namespace DenseLinAlg {
 	// of a matrix and a vector .
 	struct MatVecMult : proto::callable
 	{
-		typedef proto::terminal< LazyMatVecMult >::type result_type;
+		template < typename Sig > struct result;
 
-		result_type
-		operator()( Matrix const& mat, Vector const& vec) const
+		template < typename This, typename MatType, typename VecType >
+		struct result< This( MatType, VecType) >
+		{
+			typedef typename proto::terminal< LazyMatVecMult<
+				typename boost::remove_const<
+					typename boost::remove_reference< MatType >::type
+				>::type,
+				typename boost::remove_const<
+					typename boost::remove_reference< VecType >::type
+				>::type
+			> >::type type;
+		};
+
+		template < typename MatType, typename VecType >
+		typename proto::terminal< LazyMatVecMult< MatType, VecType > >::type
+		operator()( MatType const& mat, VecType const& vec) const
 		{
-			return proto::as_expr( LazyMatVecMult(mat, vec) );
+			return proto::as_expr(
+					LazyMatVecMult< MatType, VecType >(mat, vec) );
+		}
+	};
+
+
+	// Lazy function object for evaluating an element of
+	// the resultant vector from the multiplication of
+	// a matrix and a vector expression, whose elements are
+	// evaluated every time they are read.
+	// The cost model of VecPlanGrammar materializes the expensive
+	// operands before, so that only the cheap ones are inlined here.
+	template < typename MatType, typename Expr >
+	struct LazyMatVecExprMult
+	{
+		MatType const& m;
+		Expr expr;
+		const int mColSz;
+
+		typedef typename PromotedScalar< typename MatType::value_type,
+			typename std::decay< decltype(
+				VecExprGrammar()( std::declval< const Expr& >()( 0) )
+			) >::type >::type result_type;
+
+		explicit LazyMatVecExprMult(MatType const& mat, const Expr& e) :
+			m( mat), expr( e), mColSz(mat.columnSize()) {}
+
+		result_type operator()(int index) const
+		{
+			result_type elm = 0.0;
+			for (int ci =0;  ci < mColSz; ci++)
+				elm += m(index, ci) * VecExprGrammar()( expr( ci) );
+			return elm;
+		}
+	};
+
+
+	// Callable transform object to make the lazy functor
+	// a proto exression for lazily evaluationg the multiplication
+	// of a matrix and a vector expression
+	struct MatVecExprMult : proto::callable
+	{
+		template < typename Sig > struct result;
+
+		template < typename This, typename MatType, typename Expr >
+		struct result< This( MatType, Expr) >
+		{
+			typedef typename proto::terminal< LazyMatVecExprMult<
+				typename std::decay< MatType >::type,
+				typename std::decay< Expr >::type
+			> >::type type;
+		};
+
+		template < typename MatType, typename Expr >
+		typename proto::terminal< LazyMatVecExprMult< MatType, Expr > >::type
+		operator()( MatType const& mat, Expr const& expr) const
+		{
+			return proto::as_expr(
+					LazyMatVecExprMult< MatType, Expr >(mat, expr) );
 		}
 	};
 
@@ -78,17 +166,22 @@ namespace DenseLinAlg {
 	// Lazy function object for evaluating an element of
 	// the resultant vector from the multiplication of
 	// a matrix and a diagonal matrix and a matrix
+	template < typename PreType, typename PostType,
+				typename DiagType = DiagonalMatrix >
 	struct LazyMatDiagmatMatMult
 	{
-		Matrix const & pre;
-		DiagonalMatrix const & diag;
-		Matrix const & post;
+		PreType const & pre;
+		DiagType const & diag;
+		PostType const & post;
 		const int sz;
 
-		typedef double result_type;
+		typedef typename PromotedScalar<
+			typename PromotedScalar< typename PreType::value_type,
+				typename DiagType::value_type >::type,
+			typename PostType::value_type >::type result_type;
 
-		explicit LazyMatDiagmatMatMult(Matrix const & pre_,
-			DiagonalMatrix const & diag_, Matrix const & post_) :
+		explicit LazyMatDiagmatMatMult(PreType const & pre_,
+			DiagType const & diag_, PostType const & post_) :
 			pre( pre_), diag( diag_), post( post_), sz( diag_.size())
 		{}
 
@@ -111,13 +204,222 @@ namespace DenseLinAlg {
 	// of a matrix and a diagonal matrix and a matrix
 	struct MatDiagmatMatMult : proto::callable
 	{
-		typedef proto::terminal< LazyMatDiagmatMatMult >::type result_type;
+		template < typename Sig > struct result;
 
-		result_type
-		operator()( Matrix const& pre, DiagonalMatrix const & diag,
-				Matrix const& post) const
+		template < typename This,
+			typename PreType, typename DiagType, typename PostType >
+		struct result< This( PreType, DiagType, PostType) >
+		{
+			typedef typename proto::terminal< LazyMatDiagmatMatMult<
+				typename boost::remove_const<
+					typename boost::remove_reference< PreType >::type
+				>::type,
+				typename boost::remove_const<
+					typename boost::remove_reference< PostType >::type
+				>::type,
+				typename boost::remove_const<
+					typename boost::remove_reference< DiagType >::type
+				>::type
+			> >::type type;
+		};
+
+		template < typename PreType, typename DiagType, typename PostType >
+		typename proto::terminal< LazyMatDiagmatMatMult<
+			PreType, PostType, DiagType > >::type
+		operator()( PreType const& pre, DiagType const & diag,
+				PostType const& post) const
+		{
+			return proto::as_expr( LazyMatDiagmatMatMult<
+					PreType, PostType, DiagType >(pre, diag, post) );
+		}
+	};
+
+
+	// Lazy function object for evaluating an element of
+	// the resultant matrix from the multiplication of
+	// a matrix and a diagonal matrix and a matrix, a tile at a time.
+	//
+	// The whole MatTileSize x MatTileSize tile containing
+	// the requested element is computed, and kept until an element of
+	// another tile is requested. The rows of post are read contiguously
+	// for all the rows of the tile, instead of
+	// a column of post for every element.
+	// The products are summed up in the same order as
+	// LazyMatDiagmatMatMult .
+	// Every thread should make its own object.
+	template < typename PreType, typename PostType,
+				typename DiagType >
+	struct LazyTiledMatDiagmatMatMult
+	{
+		PreType const & pre;
+		DiagType const & diag;
+		PostType const & post;
+		const int sz;
+
+		typedef typename PromotedScalar<
+			typename PromotedScalar< typename PreType::value_type,
+				typename DiagType::value_type >::type,
+			typename PostType::value_type >::type result_type;
+
+		// the first row and column of the cached tile
+		mutable int cachedRow, cachedCol;
+		mutable BasicVector< result_type > tileCache;
+
+		explicit LazyTiledMatDiagmatMatMult(PreType const & pre_,
+			DiagType const & diag_, PostType const & post_) :
+			pre( pre_), diag( diag_), post( post_), sz( diag_.size()),
+			cachedRow( - MatTileSize), cachedCol( - MatTileSize),
+			tileCache( MatTileSize * MatTileSize)
+		{}
+
+		LazyTiledMatDiagmatMatMult( LazyTiledMatDiagmatMatMult const & lazy) :
+			pre( lazy.pre), diag( lazy.diag), post( lazy.post), sz( lazy.sz),
+			cachedRow( - MatTileSize), cachedCol( - MatTileSize),
+			tileCache( MatTileSize * MatTileSize)
+		{}
+
+		void computeTile( int tileRow, int tileCol) const
+		{
+			const int rowSz = std::min( MatTileSize, pre.rowSize() - tileRow),
+					colSz = std::min( MatTileSize,
+										post.columnSize() - tileCol);
+			result_type* const tile = &tileCache( 0);
+			for (int i = 0; i < MatTileSize * MatTileSize; i++)
+				tile[i] = 0.0;
+
+			for (int k = 0; k < sz; k++)
+				for (int r = 0; r < rowSz; r++) {
+					const auto scale = pre( tileRow + r, k) * diag( k);
+					result_type* const tileLine = tile + r * MatTileSize;
+					for (int c = 0; c < colSz; c++)
+						tileLine[c] += scale * post( k, tileCol + c);
+				}
+
+			cachedRow = tileRow;
+			cachedCol = tileCol;
+		}
+
+		result_type operator()(int ri, int ci) const
+		{
+			if ( ri < cachedRow || ri >= cachedRow + MatTileSize ||
+					ci < cachedCol || ci >= cachedCol + MatTileSize )
+				computeTile( ri - ri % MatTileSize, ci - ci % MatTileSize);
+			return tileCache( ( ri - cachedRow) * MatTileSize +
+								ci - cachedCol);
+		}
+	};
+
+
+	// Callable transform object to make the lazy functor
+	// a proto exression for evaluationg the multiplication
+	// of a matrix and a diagonal matrix and a matrix a tile at a time
+	struct TiledMatDiagmatMatMult : proto::callable
+	{
+		template < typename Sig > struct result;
+
+		template < typename This,
+			typename PreType, typename DiagType, typename PostType >
+		struct result< This( PreType, DiagType, PostType) >
+		{
+			typedef typename proto::terminal< LazyTiledMatDiagmatMatMult<
+				typename boost::remove_const<
+					typename boost::remove_reference< PreType >::type
+				>::type,
+				typename boost::remove_const<
+					typename boost::remove_reference< PostType >::type
+				>::type,
+				typename boost::remove_const<
+					typename boost::remove_reference< DiagType >::type
+				>::type
+			> >::type type;
+		};
+
+		template < typename PreType, typename DiagType, typename PostType >
+		typename proto::terminal< LazyTiledMatDiagmatMatMult<
+			PreType, PostType, DiagType > >::type
+		operator()( PreType const& pre, DiagType const & diag,
+				PostType const& post) const
+		{
+			return proto::as_expr( LazyTiledMatDiagmatMatMult<
+					PreType, PostType, DiagType >(pre, diag, post) );
+		}
+	};
+
+
+	// Lazy function object for evaluating an element of
+	// the resultant multivector from the multiplication of
+	// a matrix and a multivector.
+	//
+	// The whole row of the result is computed when an element of
+	// a new row is requested, so that the row of the matrix is read
+	// only once for all the vectors.
+	template < typename MatType, typename MultiVecType >
+	struct LazyMatMultiVecMult
+	{
+		MatType const& m;
+		MultiVecType const& x;
+		const int mColSz, numVecs;
+		typedef typename PromotedScalar< typename MatType::value_type,
+				typename MultiVecType::value_type >::type result_type;
+
+		mutable int cachedRow;
+		mutable BasicVector< result_type > rowCache;
+
+		explicit LazyMatMultiVecMult(MatType const& mat,
+									MultiVecType const& mv) :
+			m( mat), x( mv), mColSz( mat.columnSize()),
+			numVecs( mv.numVectors()), cachedRow( -1),
+			rowCache( mv.numVectors()) {}
+
+		LazyMatMultiVecMult( LazyMatMultiVecMult const& lazy) :
+			m( lazy.m), x( lazy.x), mColSz( lazy.mColSz),
+			numVecs( lazy.numVecs), cachedRow( -1),
+			rowCache( lazy.numVecs) {}
+
+		result_type operator()(int ri, int j) const
+		{
+			if ( ri != cachedRow ) {
+				result_type* const y = &rowCache(0);
+				for (int vi = 0; vi < numVecs; vi++) y[vi] = 0.0;
+				for (int ci = 0; ci < mColSz; ci++) {
+					const result_type a = m( ri, ci);
+					const double* const xRow = x.row( ci);
+					for (int vi = 0; vi < numVecs; vi++) y[vi] += a * xRow[vi];
+				}
+				cachedRow = ri;
+			}
+			return rowCache( j);
+		}
+	};
+
+
+	// Callable transform object to make the lazy functor
+	// a proto exression for lazily evaluationg the multiplication
+	// of a matrix and a multivector .
+	struct MatMultiVecMult : proto::callable
+	{
+		template < typename Sig > struct result;
+
+		template < typename This, typename MatType, typename MultiVecType >
+		struct result< This( MatType, MultiVecType) >
+		{
+			typedef typename proto::terminal< LazyMatMultiVecMult<
+				typename boost::remove_const<
+					typename boost::remove_reference< MatType >::type
+				>::type,
+				typename boost::remove_const<
+					typename boost::remove_reference< MultiVecType >::type
+				>::type
+			> >::type type;
+		};
+
+		template < typename MatType, typename MultiVecType >
+		typename proto::terminal<
+			LazyMatMultiVecMult< MatType, MultiVecType > >::type
+		operator()( MatType const& mat, MultiVecType const& mv) const
 		{
-			return proto::as_expr( LazyMatDiagmatMatMult(pre, diag, post) );
+			return proto::as_expr(
+				LazyMatMultiVecMult< MatType, MultiVecType >(mat, mv) );
 		}
 	};
 
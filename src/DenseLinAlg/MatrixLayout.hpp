@@ -0,0 +1,70 @@
+/*
+ * MatrixLayout.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef DENSELINALG_MATRIXLAYOUT_HPP_
+#define DENSELINALG_MATRIXLAYOUT_HPP_
+
+#include <cstddef>
+
+#include <DenseLinAlg/Allocator.hpp>
+
+
+namespace DenseLinAlg {
+
+	// Layout policies of the matrix elements in a contiguous buffer
+	//
+	// The elements along the major dimension are stored one after another
+	// with the stride of the leading dimension, and the elements along
+	// the minor dimension are stored sequentially.
+	// The leading dimension is padded so that every major line
+	// starts at an aligned address.
+
+	inline int paddedLeadingDimension( int minorSz,
+			std::size_t elmSize = sizeof( double) )
+	{
+		const int alignSz = int( DataAlignment / elmSize );
+		return ( minorSz + alignSz - 1 ) / alignSz * alignSz;
+	}
+
+	// Elements of a row are stored sequentially.
+	struct RowMajor
+	{
+		static int majorSize( int rowSz, int ) { return rowSz; }
+		static int minorSize( int , int colSz) { return colSz; }
+		static int leadingDimension( int , int colSz,
+				std::size_t elmSize = sizeof( double) ) {
+			return paddedLeadingDimension( colSz, elmSize);
+		}
+		static int index( int ri, int ci, int ld) { return ri * ld + ci; }
+
+		// the row and column indices of the element
+		// at ( major index, minor index )
+		static int rowIndex( int major, int ) { return major; }
+		static int columnIndex( int , int minor) { return minor; }
+	};
+
+	// Elements of a column are stored sequentially.
+	struct ColumnMajor
+	{
+		static int majorSize( int , int colSz) { return colSz; }
+		static int minorSize( int rowSz, int ) { return rowSz; }
+		static int leadingDimension( int rowSz, int ,
+				std::size_t elmSize = sizeof( double) ) {
+			return paddedLeadingDimension( rowSz, elmSize);
+		}
+		static int index( int ri, int ci, int ld) { return ci * ld + ri; }
+
+		// the row and column indices of the element
+		// at ( major index, minor index )
+		static int rowIndex( int , int minor) { return minor; }
+		static int columnIndex( int major, int ) { return major; }
+	};
+
+}
+
+
+#endif /* DENSELINALG_MATRIXLAYOUT_HPP_ */
@@ -10,12 +10,25 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
+#include <type_traits>
+#include <utility>
 #include <boost/proto/proto.hpp>
 
 #include <ParallelizationTypeTag/Default.hpp>
+#include <ParallelizationTypeTag/Dispatch.hpp>
+#include <ParallelizationTypeTag/WorkStealingPool.hpp>
 
 #include <DenseLinAlg/Grammar.hpp>
+#include <DenseLinAlg/CommonSubexpr.hpp>
+#include <DenseLinAlg/Aliasing.hpp>
+#include <DenseLinAlg/CostModel.hpp>
+#include <DenseLinAlg/Simd.hpp>
+#include <DenseLinAlg/Allocator.hpp>
+#include <DenseLinAlg/FirstTouch.hpp>
+#include <DenseLinAlg/MatrixLayout.hpp>
 
 
 namespace DenseLinAlg {
@@ -52,8 +65,6 @@ namespace DenseLinAlg {
 	};
 
 
-	class Vector;
-
 	template < typename Derived >
 	struct LazyVectorMaker
 	{
@@ -72,153 +83,370 @@ namespace DenseLinAlg {
 	};
 
 
-	class Matrix;
+	// Temporary arrays of diagPrecondConGrad( ),
+	// which can be kept between solves of the same problem size.
+	struct DiagPrecondConGradWorkspace
+	{
+		const int sz;
+		double *invDiag, *resid, *z, *q, *p;
+
+		explicit DiagPrecondConGradWorkspace( int problemSize) :
+			sz( problemSize),
+			invDiag( DefaultAllocator::allocate( sz)),
+			resid( DefaultAllocator::allocate( sz)),
+			z( DefaultAllocator::allocate( sz)),
+			q( DefaultAllocator::allocate( sz)),
+			p( DefaultAllocator::allocate( sz))
+		{}
+
+		DiagPrecondConGradWorkspace( const DiagPrecondConGradWorkspace & )
+			= delete;
+		DiagPrecondConGradWorkspace &
+		operator=( const DiagPrecondConGradWorkspace & ) = delete;
+
+		~DiagPrecondConGradWorkspace()
+		{
+			DefaultAllocator::deallocate( p);
+			DefaultAllocator::deallocate( q);
+			DefaultAllocator::deallocate( z);
+			DefaultAllocator::deallocate( resid);
+			DefaultAllocator::deallocate( invDiag);
+		}
+
+		// Peak memory of the workspace for the problem size
+		static std::size_t bytes( int problemSize)
+		{
+			return 5 * sizeof( double) * std::size_t( problemSize);
+		}
+	};
 
 	void diagPrecondConGrad( Vector & ansVec,
 			const Matrix & coeffMat, const Vector & rhsVec,
 			const Vector & initGuessVec,
 			double convergenceCriterion);
 
+	void diagPrecondConGrad( Vector & ansVec,
+			const Matrix & coeffMat, const Vector & rhsVec,
+			const Vector & initGuessVec,
+			double convergenceCriterion,
+			DiagPrecondConGradWorkspace & workspace);
+
 	// These classes are to be used as the template parameter
 	// for AssignType.
+	// The rhs is converted to the scalar type of the lhs
+	// after it is evaluated in the promoted type.
 	struct AssignFunctor {  // operator=()
-		void operator()( double& lhs, double rhs) const { lhs = rhs; }
+		template < typename L, typename R >
+		void operator()( L& lhs, R rhs) const { lhs = rhs; }
 	};
 	struct PlusAssignFunctor {  // operator+=()
-		void operator()( double& lhs, double rhs) const { lhs += rhs; }
+		template < typename L, typename R >
+		void operator()( L& lhs, R rhs) const { lhs += rhs; }
 	};
 	struct MinusAssignFunctor {  // operator-=()
-		void operator()( double& lhs, double rhs) const { lhs -= rhs; }
+		template < typename L, typename R >
+		void operator()( L& lhs, R rhs) const { lhs -= rhs; }
 	};
 
 	template < typename AssignType > struct AssignVecExpr;
+	template < typename AssignType > struct AssignMatExpr;
+	template < typename AssignType > struct AssignTransMatVecMult;
 
 	// Function object for lazily assigning
 	// an vector object (not expression temaplte) into a vector object
 	template < typename AssignType >
 	struct AssignVector {
+		template < typename Scalar >
 		void operator()(
-			const Vector& rhs, Vector& lhs,
+			const BasicVector< Scalar >& rhs, BasicVector< Scalar >& lhs,
 			const PTT::SingleProcess< PTT::SingleThread< PTT::NoSIMD > >& )
 		const;
 
+		template < typename Scalar >
 		void operator()(
-			const Vector& rhs, Vector& lhs,
+			const BasicVector< Scalar >& rhs, BasicVector< Scalar >& lhs,
 			const PTT::SingleProcess< PTT::OpenMP< PTT::NoSIMD > >& )
 		const;
+
+		// assigning a pack of the elements at a time
+		// by the SIMD extension SimdTag
+		template < typename Scalar, typename SimdTag >
+		void operator()(
+			const BasicVector< Scalar >& rhs, BasicVector< Scalar >& lhs,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& )
+		const;
+
+		template < typename Scalar, typename SimdTag >
+		void operator()(
+			const BasicVector< Scalar >& rhs, BasicVector< Scalar >& lhs,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >& )
+		const;
+
+		template < typename Scalar, typename SimdTag >
+		void operator()(
+			const BasicVector< Scalar >& rhs, BasicVector< Scalar >& lhs,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >& )
+		const;
+
+		// by the parallelization type selected at run time
+		template < typename Scalar >
+		void operator()(
+			const BasicVector< Scalar >& rhs, BasicVector< Scalar >& lhs,
+			const PTT::SingleProcess< PTT::Runtime >& )
+		const
+		{
+			PTT::dispatch( *this, rhs, lhs);
+		}
+
+		// assigning the rows of this process
+		template < typename Scalar, typename Multithreading >
+		void operator()(
+			const BasicVector< Scalar >& rhs, BasicVector< Scalar >& lhs,
+			const PTT::MPI< Multithreading >& )
+		const
+		{
+			(*this)( rhs, lhs, PTT::SingleProcess< Multithreading >() );
+		}
 	};
 
 
-	class Vector {
+	// Dense vector of the elements of the type Scalar
+	template < typename Scalar >
+	class BasicVector {
 	private:
-		const int sz;
-		double* data;
+		int sz;
+		Scalar* data;
 
-		double _dot( const Vector& vec,
+		Scalar _dot( const BasicVector& vec,
 			const PTT::SingleProcess< PTT::SingleThread< PTT::NoSIMD > >&)
 		const
 		{
-			double d = data[0] * vec.data[0];
-			for (int i = 1; i < sz; i++) d += data[i] * vec.data[i];
+			const Scalar* const x = assumeAligned( data);
+			const Scalar* const y = assumeAligned( vec.data);
+			Scalar d = 0.0;
+			for (int i = 0; i < sz; i++) d += x[i] * y[i];
 			return d;
 		}
 
-		double _dot( const Vector& vec,
+		Scalar _dot( const BasicVector& vec,
 				const PTT::SingleProcess< PTT::OpenMP< PTT::NoSIMD > >&)
 		const
 		{
-			double d = data[0] * vec.data[0];
+			const Scalar* const x = assumeAligned( data);
+			const Scalar* const y = assumeAligned( vec.data);
+			Scalar d = 0.0;
 			#pragma omp parallel for reduction (+:d)
-			for (int i = 1; i < sz; i++) d += data[i] * vec.data[i];
+			for (int i = 0; i < sz; i++) d += x[i] * y[i];
 
 			// std::cout << "OpenMP dot product" << std::endl;
 
 			return d;
 		}
 
-		double _abs(
+		Scalar _abs(
 			const PTT::SingleProcess< PTT::SingleThread< PTT::NoSIMD > >&)
 		const {
-			double aSqr = data[0] * data[0];
-			for (int i = 1; i < sz; i++) aSqr += data[i] * data[i];
+			const Scalar* const x = assumeAligned( data);
+			Scalar aSqr = 0.0;
+			for (int i = 0; i < sz; i++) aSqr += x[i] * x[i];
 			return sqrt( aSqr);
 		}
 
-		double _abs(
+		Scalar _abs(
 				const PTT::SingleProcess< PTT::OpenMP< PTT::NoSIMD > >&)
 		const {
-			double aSqr = data[0] * data[0];
+			const Scalar* const x = assumeAligned( data);
+			Scalar aSqr = 0.0;
 			#pragma omp parallel for reduction (+:aSqr)
-			for (int i = 1; i < sz; i++) aSqr += data[i] * data[i];
+			for (int i = 0; i < sz; i++) aSqr += x[i] * x[i];
 
 			// std::cout << "OpenMP vector abs" << std::endl;
 
 			return sqrt( aSqr);
 		}
 
+		// The SIMD extensions multiply and add a pack of the elements
+		// at a time, into the partial sums of the lanes.
+		template < typename SimdTag >
+		Scalar _dot( const BasicVector& vec,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >&)
+		const
+		{
+			return simdDot( assumeAligned( data), assumeAligned( vec.data),
+				0, sz, (typename SimdOpsOf< Scalar, SimdTag >::type*)nullptr );
+		}
+
+		template < typename SimdTag >
+		Scalar _dot( const BasicVector& vec,
+				const PTT::SingleProcess< PTT::OpenMP< SimdTag > >&)
+		const
+		{
+			const Scalar* const x = assumeAligned( data);
+			const Scalar* const y = assumeAligned( vec.data);
+			const int numBlocks = ( sz + SimdBlockSize - 1 ) / SimdBlockSize;
+			Scalar d = 0.0;
+			#pragma omp parallel for reduction (+:d)
+			for (int b = 0; b < numBlocks; b++)
+				d += simdDot( x, y, b * SimdBlockSize,
+					std::min( ( b + 1 ) * SimdBlockSize, sz),
+					(typename SimdOpsOf< Scalar, SimdTag >::type*)nullptr );
+			return d;
+		}
+
+		// The partial sums of the blocks are added in order,
+		// so that the result does not depend on the threads.
+		template < typename SimdTag >
+		Scalar _dot( const BasicVector& vec,
+				const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >&)
+		const
+		{
+			const Scalar* const x = assumeAligned( data);
+			const Scalar* const y = assumeAligned( vec.data);
+			return PTT::WorkStealingPool::local().reduceBlocks(
+				sz, SimdBlockSize, Scalar( 0),
+				[x, y]( int first, int last, Scalar* partials) {
+					for (int b = first; b < last; b += SimdBlockSize)
+						*partials++ = simdDot( x, y, b,
+							std::min( b + SimdBlockSize, last),
+							(typename SimdOpsOf< Scalar, SimdTag >::type*)nullptr );
+				},
+				[]( Scalar& acc, Scalar partial) { acc += partial; } );
+		}
+
+		// The kernel is selected at run time.
+		struct DotCall {
+			const BasicVector& self;
+
+			template < typename ParallelizationType >
+			Scalar operator()( const BasicVector& vec,
+							const ParallelizationType& pt) const {
+				return self._dot( vec, pt);
+			}
+		};
+
+		Scalar _dot( const BasicVector& vec,
+					const PTT::SingleProcess< PTT::Runtime >&) const {
+			return PTT::dispatch( DotCall{ *this }, vec);
+		}
+
+		// The dot products of the rows of the processes are summed.
+		template < typename Multithreading >
+		Scalar _dot( const BasicVector& vec,
+					const PTT::MPI< Multithreading >& pt) const {
+			return allreduceSum(
+				_dot( vec, PTT::SingleProcess< Multithreading >() ), pt);
+		}
+
+		template < typename ParallelizationType >
+		Scalar _abs( const ParallelizationType& pt) const {
+			return sqrt( _dot( *this, pt) );
+		}
+
 
 	public:
+		typedef Scalar value_type;
+
 		template <typename Sig> struct result;
 
 		template <typename This, typename T>
-		struct result< This(T) > { typedef double type; };
+		struct result< This(T) > { typedef Scalar type; };
 
-		explicit Vector(int sz_, double iniVal) :
-			sz( sz_), data( new double[sz] ) {
-			for (int i = 0; i < sz; i++) data[i] = iniVal;
+		explicit BasicVector(int sz_, Scalar iniVal) :
+			sz( sz_), data( DefaultAllocator::allocate< Scalar >( sz) ) {
+			FillLines()( data, sz, 1, iniVal, PTT::Specified() );
 		}
 
-		// No initialization
-		explicit Vector(int sz_ = 1) :
-			sz( sz_), data( new double[sz] ) {
+		// No initialization, though the pages are touched first
+		// by the threads evaluating their elements
+		explicit BasicVector(int sz_ = 1) :
+			sz( sz_), data( DefaultAllocator::allocate< Scalar >( sz) ) {
+			TouchLines()( data, sz, 1, PTT::Specified() );
 		}
 
-		Vector(const Vector& vec) :
-			sz( vec.sz), data( new double[sz] ) {
+		BasicVector(const BasicVector& vec) :
+			sz( vec.sz), data( DefaultAllocator::allocate< Scalar >( sz) ) {
 			AssignVector< AssignFunctor >()(
 				vec, *this, PTT::Specified()
 			);
 		}
 
+		// Taking over the buffer of vec, which becomes an empty vector
+		BasicVector(BasicVector&& vec) noexcept :
+			sz( vec.sz), data( vec.data) {
+			vec.sz = 0;
+			vec.data = nullptr;
+		}
+
 		template < typename Derived >
-		Vector( const LazyVectorMaker< Derived > & maker) :
-			sz( maker.columnSize()), data( new double[sz] )
+		BasicVector( const LazyVectorMaker< Derived > & maker) :
+			sz( maker.columnSize()), data( DefaultAllocator::allocate< Scalar >( sz) )
 		{
 			maker.assignDataTo( *this);
 		}
 
-		~Vector() {
-			delete [] data;
+		~BasicVector() {
+			DefaultAllocator::deallocate( data);
 		}
 
 		int size() const { return sz; }
 		int rowSize() const { return 1; }
 		int columnSize() const { return sz; }
 
-		double dot( const Vector& vec) const
+		// exchanging the buffers of two vectors
+		void swap( BasicVector& vec) noexcept {
+			std::swap( sz, vec.sz);
+			std::swap( data, vec.data);
+		}
+
+		Scalar dot( const BasicVector& vec) const
 		{
 			return _dot(vec, PTT::Specified());
 		}
 
-		double abs() const {
+		Scalar abs() const {
 			return _abs( PTT::Specified());
 		}
 
+		// the dot product and the norm by the parallelization type pt ,
+		// e.g. PTT::SingleProcess< PTT::SingleThread< PTT::AVX > >()
+		template < typename ParallelizationType >
+		Scalar dot( const BasicVector& vec,
+					const ParallelizationType& pt) const
+		{
+			return _dot(vec, pt);
+		}
+
+		template < typename ParallelizationType >
+		Scalar abs( const ParallelizationType& pt) const {
+			return _abs( pt);
+		}
+
 		// accessing to an element of this vector
-		double& operator()(int i) { return data[i]; }
-		const double& operator()(int i) const { return data[i]; }
+		Scalar& operator()(int i) { return data[i]; }
+		const Scalar& operator()(int i) const { return data[i]; }
 
 
-		Vector& operator=( const Vector& rhs ) {
-			AssignVector< AssignFunctor >()(
-				rhs, *this, PTT::Specified()
-			);
+		BasicVector& operator=( const BasicVector& rhs ) {
+			if ( sz != rhs.sz ) {
+				BasicVector copied( rhs);
+				swap( copied);
+			} else {
+				AssignVector< AssignFunctor >()(
+					rhs, *this, PTT::Specified()
+				);
+			}
+			return *this;
+		}
+
+		// The old buffer of this vector is released by rhs.
+		BasicVector& operator=( BasicVector&& rhs ) noexcept {
+			swap( rhs);
 			return *this;
 		}
 
 		// assigning the lhs of a vector expression into this vector
 		template < typename Expr >
-		Vector& operator=( const ExprWrapper< Expr >& expr ) {
+		BasicVector& operator=( const ExprWrapper< Expr >& expr ) {
 			// NOTE that this argument type should be ExprWrapper< >,
 			// otherwise the following operator=() cannot be
 			// instanciated for SparseLinAlg::LazyIterSolver
@@ -231,14 +459,14 @@ namespace DenseLinAlg {
 		}
 
 		template < typename Derived >
-		Vector& operator=( const LazyVectorMaker< Derived > & maker) {
+		BasicVector& operator=( const LazyVectorMaker< Derived > & maker) {
 			maker.assignDataTo( *this);
 			return *this;
 		}
 
 		// plus assigning the lhs of a vector expression into this vector
 		template <typename Expr>
-		Vector& operator+=( const ExprWrapper< Expr >& expr ) {
+		BasicVector& operator+=( const ExprWrapper< Expr >& expr ) {
 			// NOTE that this argument type should be ExprWrapper< >,
 			// otherwise the following operator=() cannot be
 			// instanciated for SparseLinAlg::LazyIterSolver
@@ -252,7 +480,7 @@ namespace DenseLinAlg {
 
 		// minus assigning the lhs of a vector expression into this vector
 		template <typename Expr>
-		Vector& operator-=( const ExprWrapper< Expr >&expr ) {
+		BasicVector& operator-=( const ExprWrapper< Expr >&expr ) {
 			// NOTE that this argument type should be ExprWrapper< >,
 			// otherwise the following operator=() cannot be
 			// instanciated for SparseLinAlg::LazyIterSolver
@@ -268,84 +496,567 @@ namespace DenseLinAlg {
 		friend void diagPrecondConGrad( Vector & ansVec,
 				const Matrix & coeffMat, const Vector & rhsVec,
 				const Vector & initGuessVec,
-				double convergenceCriterion);
+				double convergenceCriterion,
+				DiagPrecondConGradWorkspace & workspace);
+
+		template < typename AssignType > friend struct AssignVecExpr;
+		template < typename AssignType > friend struct AssignVector;
+	};
+
+
+	// A vector expression rewritten by VecLazyGrammar with its memo,
+	// made by every worker of a thread pool
+	template < typename Expr, typename SimdTag >
+	class LazyVecExpr
+	{
+	private:
+		VecExprMemo memo;
 
-		template < typename AssignType > friend class AssignVecExpr;
-		template < typename AssignType > friend class AssignVector;
+	public:
+		const typename std::decay< decltype(
+			VecLazyGrammar< SimdTag >()( std::declval< const Expr& >(),
+				std::declval< const Expr& >(),
+				std::declval< VecExprMemo& >() )
+		) >::type expr;
+
+		explicit LazyVecExpr( const Expr& e) :
+			expr( VecLazyGrammar< SimdTag >()( e, e, memo) ) {}
 	};
 
 
 	// Function object for lazily assigning
 	// an vector expresion into a vector object
+	//
+	// A reduction type expression gathering the elements of
+	// the left hand side, like A * x assigned into x ,
+	// is evaluated into a scratch vector first.
+	// The other expressions are evaluated in place.
 	template < typename AssignType >
 	struct AssignVecExpr
 	{
-		template < typename Expr >
+		// The subexpressions chosen by the cost model are evaluated
+		// into temporaries before the whole expression.
+		template < typename Expr, typename LhsType,
+					typename ParallelizationType >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecMaterializeTag&,
+			LhsType& lhs, const ParallelizationType& pt)
+		const
+		{
+			VecExprTemps temps;
+			const auto plannedExpr = VecPlanGrammar< ExprWrapper< Expr > >()(
+														expr, 0, temps);
+			(*this)( plannedExpr, VecMapReduceTag(), lhs, pt);
+		}
+
+		// The products of the transposed matrices and vectors are
+		// scattered at once by AssignTransMatVecMult .
+		template < typename Expr, typename LhsType,
+					typename ParallelizationType >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecTransMultTag&,
+			LhsType& lhs, const ParallelizationType& pt)
+		const
+		{
+			AssignTransMatVecMult< AssignType >()( expr, lhs, pt);
+		}
+
+		// The kernels of the parallelization type selected at run time
+		// evaluate the expressions of every tag.
+		template < typename Expr, typename TagType, typename LhsType >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const TagType& tag,
+			LhsType& lhs, const PTT::SingleProcess< PTT::Runtime >& )
+		const
+		{
+			PTT::dispatch( *this, expr, tag, lhs);
+		}
+
+		template < typename Expr, typename LhsType >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecMaterializeTag& tag,
+			LhsType& lhs, const PTT::SingleProcess< PTT::Runtime >& )
+		const
+		{
+			PTT::dispatch( *this, expr, tag, lhs);
+		}
+
+		template < typename Expr, typename LhsType >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecTransMultTag& tag,
+			LhsType& lhs, const PTT::SingleProcess< PTT::Runtime >& )
+		const
+		{
+			PTT::dispatch( *this, expr, tag, lhs);
+		}
+
+		// The rows of this process are evaluated by the kernels of
+		// the multithreading type, after the halos of the vectors
+		// multiplied by the distributed matrices are exchanged.
+		// They are released afterward.
+		template < typename Expr, typename TagType, typename LhsType,
+					typename Multithreading >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const TagType& tag,
+			LhsType& lhs, const PTT::MPI< Multithreading >& )
+		const
+		{
+			HaloExchangeGrammar()( expr, 0);
+			(*this)( expr, tag, lhs, PTT::SingleProcess< Multithreading >() );
+			HaloReleaseGrammar()( expr, 0);
+		}
+
+		template < typename Expr, typename LhsType, typename Multithreading >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecMaterializeTag& tag,
+			LhsType& lhs, const PTT::MPI< Multithreading >& )
+		const
+		{
+			HaloExchangeGrammar()( expr, 0);
+			(*this)( expr, tag, lhs, PTT::SingleProcess< Multithreading >() );
+			HaloReleaseGrammar()( expr, 0);
+		}
+
+		template < typename Expr, typename LhsType, typename Multithreading >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecTransMultTag& tag,
+			LhsType& lhs, const PTT::MPI< Multithreading >& )
+		const
+		{
+			HaloExchangeGrammar()( expr, 0);
+			(*this)( expr, tag, lhs, PTT::SingleProcess< Multithreading >() );
+			HaloReleaseGrammar()( expr, 0);
+		}
+
+		template < typename Expr, typename LhsType,
+					typename ParallelizationType >
+		void assignThroughScratch( const ExprWrapper< Expr >& expr,
+			LhsType& lhs, const ParallelizationType& pt)
+		const
+		{
+			ScratchVector< typename std::decay<
+				decltype( VecExprGrammar()( expr( 0) ) ) >::type
+			> scratch( lhs.size() );
+			AssignVecExpr< AssignFunctor >()(
+								expr, VecMapReduceTag(), scratch, pt);
+			copyScratch( scratch, lhs, pt);
+		}
+
+		template < typename Scalar, typename LhsType, typename SimdTag >
+		static void copyScratch( const ScratchVector< Scalar >& scratch,
+			LhsType& lhs,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& )
+		{
+			const int sz = lhs.size();
+			for(int i=0; i < sz; ++i)
+				AssignType()( lhs(i), scratch(i) );
+		}
+
+		template < typename Scalar, typename LhsType, typename SimdTag >
+		static void copyScratch( const ScratchVector< Scalar >& scratch,
+			LhsType& lhs,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >& )
+		{
+			const int sz = lhs.size();
+			#pragma omp parallel for
+			for(int i=0; i < sz; ++i)
+				AssignType()( lhs(i), scratch(i) );
+		}
+
+		template < typename Scalar, typename LhsType, typename SimdTag >
+		static void copyScratch( const ScratchVector< Scalar >& scratch,
+			LhsType& lhs,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >& )
+		{
+			PTT::WorkStealingPool::local().parallelForBlocks(
+				lhs.size(), SimdBlockSize,
+				[&scratch, &lhs]( int first, int last) {
+					for(int i=first; i < last; ++i)
+						AssignType()( lhs(i), scratch(i) );
+				} );
+		}
+
+		// Assigning the elements from first to last of expr into lhs .
+		// A pack of the elements at a time is evaluated
+		// by VecPackGrammar , unless the pack type is void.
+		template < typename Expr, typename Scalar >
+		static void assignElements( const Expr& expr, Scalar* lhs,
+									int first, int last, void* )
+		{
+			for(int i=first; i < last; ++i)
+				AssignType()( lhs[i], VecExprGrammar()( expr(i) ) );
+		}
+
+		template < typename Expr, typename SimdTag >
+		static void assignElements( const Expr& expr, double* lhs,
+									int first, int last, SimdPack< SimdTag >* )
+		{
+			typedef SimdPack< SimdTag > Pack;
+			const int w = Pack::width;
+			int i = first;
+			for (; i + w <= last; i += w) {
+				Pack l;
+				if ( ! std::is_same< AssignType, AssignFunctor >::value )
+					l = Pack::load( lhs + i);
+				AssignType()( l, VecPackGrammar< Pack >()( expr, i) );
+				l.store( lhs + i);
+			}
+			assignElements( expr, lhs, i, last, (void*)nullptr );
+		}
+
+		// assigning the elements of expr into lhs of the size sz
+		// by the threads of the enclosing parallel region,
+		// a block of the elements at a time
+		template < typename Expr, typename Scalar, typename SimdTag >
+		static void assignElementsInParallel( const Expr& expr, Scalar* lhs,
+											int sz, SimdPack< SimdTag >* pack)
+		{
+			const int numBlocks = ( sz + SimdBlockSize - 1 ) / SimdBlockSize;
+			#pragma omp for schedule( static)
+			for (int b = 0; b < numBlocks; b++)
+				assignElements( expr, lhs, b * SimdBlockSize,
+					std::min( ( b + 1 ) * SimdBlockSize, sz), pack);
+		}
+
+		template < typename Expr, typename Scalar >
+		static void assignElementsInParallel( const Expr& expr, Scalar* lhs,
+											int sz, void* )
+		{
+			#pragma omp for schedule( static)
+			for(int i=0; i < sz; ++i)
+				AssignType()( lhs[i], VecExprGrammar()( expr(i) ) );
+		}
+
+		template < typename Expr, typename Scalar, typename SimdTag >
 		void operator()(
 			const ExprWrapper< Expr >& expr, const VecExprTag&,
-			Vector& lhs,
-			const PTT::SingleProcess< PTT::SingleThread< PTT::NoSIMD > >& )
+			BasicVector< Scalar >& lhs,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& )
 		const
 		{
-			for(int i=0; i < lhs.sz; ++i)
-				AssignType()( lhs.data[i], VecExprGrammar()( expr(i) ) );
+			assignElements( expr, assumeAligned( lhs.data), 0, lhs.sz,
+							(void*)nullptr );
 		};
 
-		template < typename Expr >
+		// The elementwise type expressions are evaluated
+		// a pack of the elements at a time by the SIMD extensions.
+		template < typename Expr, typename Scalar, typename SimdTag >
 		void operator()(
 			const ExprWrapper< Expr >& expr, const VecMapTag&,
-			Vector& lhs,
-			const PTT::SingleProcess< PTT::OpenMP< PTT::NoSIMD > >& )
+			BasicVector< Scalar >& lhs,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& )
+		const
+		{
+			assignElements( expr, assumeAligned( lhs.data), 0, lhs.sz,
+				(typename VecExprPackOf< ExprWrapper< Expr >, Scalar, SimdTag
+				>::type*)nullptr );
+		};
+
+		// The reduction type expressions are evaluated
+		// after rewritten by VecLazyGrammar .
+		// Their matrix vector products are evaluated element by element,
+		// and gathering them into the packs costs more than
+		// the scalar code saves, so that they are evaluated
+		// by the scalar code, except for the windows of SELL matrices
+		// multiplied by the kernels of SimdTag .
+		template < typename Expr, typename Scalar, typename SimdTag >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecMapReduceTag&,
+			BasicVector< Scalar >& lhs,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& pt)
+		const
+		{
+			if ( GatherAliasGrammar()( expr, 0, lhs) ) {
+				assignThroughScratch( expr, lhs, pt);
+				return;
+			}
+
+			VecExprMemo memo;
+			auto lazyExpr = VecLazyGrammar< SimdTag >()( expr, expr, memo);
+			assignElements( lazyExpr, assumeAligned( lhs.data), 0, lhs.sz,
+							(void*)nullptr );
+		};
+
+		template < typename Expr, typename Scalar, typename SimdTag >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecMapTag&,
+			BasicVector< Scalar >& lhs,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >& )
+		const
+		{
+			Scalar* const lhsData = assumeAligned( lhs.data);
+			#pragma omp parallel
+			assignElementsInParallel( expr, lhsData, lhs.sz,
+				(typename VecExprPackOf< ExprWrapper< Expr >, Scalar, SimdTag
+				>::type*)nullptr );
+		};
+
+		template < typename Expr, typename Scalar, typename SimdTag >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecMapReduceTag&,
+			BasicVector< Scalar >& lhs,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >& pt)
+		const
+		{
+			if ( GatherAliasGrammar()( expr, 0, lhs) ) {
+				assignThroughScratch( expr, lhs, pt);
+				return;
+			}
+
+			Scalar* const lhsData = assumeAligned( lhs.data);
+			#pragma omp parallel shared( lhs)
+			{
+				VecExprMemo memo;
+				auto lazyExpr = VecLazyGrammar< SimdTag >()( expr, expr, memo);
+				assignElementsInParallel( lazyExpr, lhsData, lhs.sz,
+										(void*)nullptr );
+			}
+		};
+
+		// The tasks of the thread pool assign the chunks of the blocks.
+		template < typename Expr, typename Scalar, typename SimdTag >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecMapTag&,
+			BasicVector< Scalar >& lhs,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >& )
+		const
+		{
+			Scalar* const lhsData = assumeAligned( lhs.data);
+			PTT::WorkStealingPool::local().parallelForBlocks(
+				lhs.sz, SimdBlockSize,
+				[&expr, lhsData]( int first, int last) {
+					assignElements( expr, lhsData, first, last,
+						(typename VecExprPackOf< ExprWrapper< Expr >, Scalar,
+											SimdTag >::type*)nullptr );
+				} );
+		};
+
+		// Every worker makes its own lazy function objects
+		// used by the tasks it runs.
+		template < typename Expr, typename Scalar, typename SimdTag >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecMapReduceTag&,
+			BasicVector< Scalar >& lhs,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >& pt)
+		const
+		{
+			if ( GatherAliasGrammar()( expr, 0, lhs) ) {
+				assignThroughScratch( expr, lhs, pt);
+				return;
+			}
+
+			typedef LazyVecExpr< ExprWrapper< Expr >, SimdTag > Lazy;
+			PTT::WorkStealingPool& pool = PTT::WorkStealingPool::local();
+			PTT::WorkerStates< Lazy > lazyExprs( pool);
+			Scalar* const lhsData = assumeAligned( lhs.data);
+			pool.parallelForBlocks( lhs.sz, SimdBlockSize,
+				[&expr, &lazyExprs, lhsData]( int first, int last) {
+					lazyExprs.run( [&expr]() { return new Lazy( expr); },
+						[lhsData, first, last]( Lazy& lazy) {
+							assignElements( lazy.expr, lhsData, first, last,
+											(void*)nullptr );
+						} );
+				} );
+		};
+
+		// The overloads below are for the left hand side
+		// other than Vector, like VectorView, which is accessed
+		// through its operator()( index) .
+		template < typename Expr, typename LhsType, typename SimdTag >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecExprTag&,
+			LhsType& lhs,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& )
+		const
+		{
+			const int sz = lhs.size();
+			for(int i=0; i < sz; ++i)
+				AssignType()( lhs(i), VecExprGrammar()( expr(i) ) );
+		};
+
+		template < typename Expr, typename LhsType, typename SimdTag >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecMapReduceTag&,
+			LhsType& lhs,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& pt)
+		const
+		{
+			if ( GatherAliasGrammar()( expr, 0, lhs) ) {
+				assignThroughScratch( expr, lhs, pt);
+				return;
+			}
+
+			VecExprMemo memo;
+			auto lazyExpr = VecLazyGrammar< SimdTag >()( expr, expr, memo);
+			const int sz = lhs.size();
+			for(int i=0; i < sz; ++i)
+				AssignType()( lhs(i), VecExprGrammar()( lazyExpr(i) ) );
+		};
+
+		template < typename Expr, typename LhsType, typename SimdTag >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecMapTag&,
+			LhsType& lhs,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >& )
 		const
 		{
+			const int sz = lhs.size();
 			#pragma omp parallel for
-			for(int i=0; i < lhs.sz; ++i)
-				AssignType()( lhs.data[i], VecMapGrammar()( expr(i) ) );
-			// std::cout << "skelton for Map, OpenMP " << std::endl;
+			for(int i=0; i < sz; ++i)
+				AssignType()( lhs(i), VecMapGrammar()( expr(i) ) );
 		};
 
-		template < typename Expr >
+		template < typename Expr, typename LhsType, typename SimdTag >
 		void operator()(
 			const ExprWrapper< Expr >& expr, const VecMapReduceTag&,
-			Vector& lhs,
-			const PTT::SingleProcess< PTT::OpenMP< PTT::NoSIMD > >& )
+			LhsType& lhs,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >& pt)
+		const
+		{
+			if ( GatherAliasGrammar()( expr, 0, lhs) ) {
+				assignThroughScratch( expr, lhs, pt);
+				return;
+			}
+
+			const int sz = lhs.size();
+			#pragma omp parallel shared( lhs)
+			{
+				VecExprMemo memo;
+				auto lazyExpr = VecLazyGrammar< SimdTag >()( expr, expr, memo);
+				#pragma omp for
+				for(int i=0; i < sz; ++i)
+					AssignType()( lhs(i), VecExprGrammar()( lazyExpr(i) ) );
+			}
+		};
+
+		template < typename Expr, typename LhsType, typename SimdTag >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecMapTag&,
+			LhsType& lhs,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >& )
 		const
 		{
-			#pragma omp parallel for shared( lhs)
-			for(int i=0; i < lhs.sz; ++i)
-				AssignType()( lhs.data[i], VecMapReduceGrammar()( expr(i) ) );
-			// std::cout << "skelton for Map and Reduce, OpenMP " << std::endl;
+			PTT::WorkStealingPool::local().parallelForBlocks(
+				lhs.size(), SimdBlockSize,
+				[&expr, &lhs]( int first, int last) {
+					for(int i=first; i < last; ++i)
+						AssignType()( lhs(i), VecMapGrammar()( expr(i) ) );
+				} );
+		};
+
+		template < typename Expr, typename LhsType, typename SimdTag >
+		void operator()(
+			const ExprWrapper< Expr >& expr, const VecMapReduceTag&,
+			LhsType& lhs,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >& pt)
+		const
+		{
+			if ( GatherAliasGrammar()( expr, 0, lhs) ) {
+				assignThroughScratch( expr, lhs, pt);
+				return;
+			}
+
+			typedef LazyVecExpr< ExprWrapper< Expr >, SimdTag > Lazy;
+			PTT::WorkStealingPool& pool = PTT::WorkStealingPool::local();
+			PTT::WorkerStates< Lazy > lazyExprs( pool);
+			pool.parallelForBlocks( lhs.size(), SimdBlockSize,
+				[&expr, &lhs, &lazyExprs]( int first, int last) {
+					lazyExprs.run( [&expr]() { return new Lazy( expr); },
+						[&lhs, first, last]( Lazy& lazy) {
+							for(int i=first; i < last; ++i)
+								AssignType()( lhs(i),
+									VecExprGrammar()( lazy.expr(i) ) );
+						} );
+				} );
 		};
 	};
 
 
+	template < typename Expr, typename Scalar >
+	void materializeVecExpr( const Expr& expr, TempVector< Scalar >& temp)
+	{
+		AssignVecExpr< AssignFunctor >()(
+				expr, VecExprTagGrammar()( expr), temp, PTT::Specified() );
+	}
+
+
 	// Implementations for
 	// function object for lazily assigning
 	// an vector object (not expression temaplte) into a vector object
 	template < typename AssignType >
+	template < typename Scalar >
 	void AssignVector< AssignType >::operator()(
-		const Vector& rhs, Vector& lhs,
+		const BasicVector< Scalar >& rhs, BasicVector< Scalar >& lhs,
 		const PTT::SingleProcess< PTT::SingleThread< PTT::NoSIMD > >& )
 	const
 	{
+		Scalar* const lhsData = assumeAligned( lhs.data);
+		const Scalar* const rhsData = assumeAligned( rhs.data);
 		for(int i=0; i < lhs.sz; ++i)
-			AssignType()( lhs.data[i], rhs.data[i] );
+			AssignType()( lhsData[i], rhsData[i] );
 	};
 
 	template < typename AssignType >
+	template < typename Scalar >
 	void AssignVector< AssignType >::operator()(
-		const Vector& rhs, Vector& lhs,
+		const BasicVector< Scalar >& rhs, BasicVector< Scalar >& lhs,
 		const PTT::SingleProcess< PTT::OpenMP< PTT::NoSIMD > >& )
 	const
 	{
-		#pragma omp parallel for
+		Scalar* const lhsData = assumeAligned( lhs.data);
+		const Scalar* const rhsData = assumeAligned( rhs.data);
+		#pragma omp parallel for schedule( static)
 		for(int i=0; i < lhs.sz; ++i)
-			AssignType()( lhs.data[i], rhs.data[i] );
+			AssignType()( lhsData[i], rhsData[i] );
 		// std::cout << "skelton Map and Reduce, OpenMP " << std::endl;
 	};
 
+	template < typename AssignType >
+	template < typename Scalar, typename SimdTag >
+	void AssignVector< AssignType >::operator()(
+		const BasicVector< Scalar >& rhs, BasicVector< Scalar >& lhs,
+		const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& )
+	const
+	{
+		simdAssign< AssignType >(
+			assumeAligned( lhs.data), assumeAligned( rhs.data), 0, lhs.sz,
+			(typename SimdOpsOf< Scalar, SimdTag >::type*)nullptr );
+	};
+
+	template < typename AssignType >
+	template < typename Scalar, typename SimdTag >
+	void AssignVector< AssignType >::operator()(
+		const BasicVector< Scalar >& rhs, BasicVector< Scalar >& lhs,
+		const PTT::SingleProcess< PTT::OpenMP< SimdTag > >& )
+	const
+	{
+		Scalar* const lhsData = assumeAligned( lhs.data);
+		const Scalar* const rhsData = assumeAligned( rhs.data);
+		const int numBlocks = ( lhs.sz + SimdBlockSize - 1 ) / SimdBlockSize;
+		#pragma omp parallel for schedule( static)
+		for (int b = 0; b < numBlocks; b++)
+			simdAssign< AssignType >( lhsData, rhsData, b * SimdBlockSize,
+				std::min( ( b + 1 ) * SimdBlockSize, lhs.sz),
+				(typename SimdOpsOf< Scalar, SimdTag >::type*)nullptr );
+	};
+
+	// The chunks of the blocks are run by the tasks of the thread pool.
+	template < typename AssignType >
+	template < typename Scalar, typename SimdTag >
+	void AssignVector< AssignType >::operator()(
+		const BasicVector< Scalar >& rhs, BasicVector< Scalar >& lhs,
+		const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >& )
+	const
+	{
+		Scalar* const lhsData = assumeAligned( lhs.data);
+		const Scalar* const rhsData = assumeAligned( rhs.data);
+		PTT::WorkStealingPool::local().parallelForBlocks( lhs.sz, SimdBlockSize,
+			[lhsData, rhsData]( int first, int last) {
+				simdAssign< AssignType >( lhsData, rhsData, first, last,
+					(typename SimdOpsOf< Scalar, SimdTag >::type*)nullptr );
+			} );
+	};
 
-	class DiagonalMatrix;
 
 	template < typename Derived >
 	struct LazyDiagonalMatrixMaker
@@ -359,46 +1070,86 @@ namespace DenseLinAlg {
 		int columnSize() const { return sz; }
 		int size() const { return sz; }
 
-		void assignDataTo(DiagonalMatrix& lhs) const {
+		template < typename Scalar >
+		void assignDataTo(BasicDiagonalMatrix< Scalar >& lhs) const {
 			static_cast< const Derived & >( *this).assignDataTo_derived( lhs);
 		}
 	};
 
 
-	class DiagonalMatrix
+	// Diagonal matrix of the elements of the type Scalar
+	template < typename Scalar >
+	class BasicDiagonalMatrix
 	{
 	private:
-		const int sz;
-		double* data;
+		int sz;
+		Scalar* data;
 
 	public:
+		typedef Scalar value_type;
+
 		template <typename Sig> struct result;
 
 		template <typename This, typename T>
-		struct result< This(T,T) > { typedef double type; };
+		struct result< This(T,T) > { typedef Scalar type; };
 
 		template <typename This, typename T>
-		struct result< This(T) > { typedef double type; };
+		struct result< This(T) > { typedef Scalar type; };
 
-		explicit DiagonalMatrix(int sz_ = 1, double iniVal = 0.0) :
-				sz( sz_), data( new double[sz] )
+		explicit BasicDiagonalMatrix(int sz_ = 1, Scalar iniVal = 0.0) :
+				sz( sz_), data( DefaultAllocator::allocate< Scalar >( sz) )
 		{
-			for (int i = 0; i < sz; i++) data[i] = iniVal;
+			FillLines()( data, sz, 1, iniVal, PTT::Specified() );
 		}
 
-		~DiagonalMatrix() {
-			delete [] data;
+		BasicDiagonalMatrix( const BasicDiagonalMatrix& mat) :
+				sz( mat.sz), data( DefaultAllocator::allocate< Scalar >( sz) )
+		{
+			CopyLines()( data, mat.data, sz, 1, PTT::Specified() );
+		}
+
+		// Taking over the buffer of mat, which becomes an empty matrix
+		BasicDiagonalMatrix( BasicDiagonalMatrix&& mat) noexcept :
+				sz( mat.sz), data( mat.data)
+		{
+			mat.sz = 0;
+			mat.data = nullptr;
+		}
+
+		~BasicDiagonalMatrix() {
+			DefaultAllocator::deallocate( data);
 		}
 
 		int size() const { return sz; }
 		int rowSize() const { return sz; }
 		int columnSize() const { return sz; }
 
+		// exchanging the buffers of two diagonal matrices
+		void swap( BasicDiagonalMatrix& mat) noexcept {
+			std::swap( sz, mat.sz);
+			std::swap( data, mat.data);
+		}
+
+		BasicDiagonalMatrix& operator=( const BasicDiagonalMatrix& rhs ) {
+			if ( sz != rhs.sz ) {
+				BasicDiagonalMatrix copied( rhs);
+				swap( copied);
+			} else {
+				CopyLines()( data, rhs.data, sz, 1, PTT::Specified() );
+			}
+			return *this;
+		}
+
+		BasicDiagonalMatrix& operator=( BasicDiagonalMatrix&& rhs ) noexcept {
+			swap( rhs);
+			return *this;
+		}
+
 		// accessing to an element of this vector
-		double& operator()(int i) { return data[i]; }
-		const double& operator()(int i) const { return data[i]; }
+		Scalar& operator()(int i) { return data[i]; }
+		const Scalar& operator()(int i) const { return data[i]; }
 
-		double operator()(int ri, int ci) const {
+		Scalar operator()(int ri, int ci) const {
 			if ( ri == ci )  {
 				return data[ri];
 			} else {
@@ -407,14 +1158,14 @@ namespace DenseLinAlg {
 		}
 
 		template< typename Expr >
-		DiagonalMatrix& operator=( const ExprWrapper< Expr >& expr ) {
+		BasicDiagonalMatrix& operator=( const ExprWrapper< Expr >& expr ) {
 			for(int i=0; i < sz; ++i)
 				data[i] = DiagMatExprGrammar()( expr(i) );
 			return *this;
 		}
 
 		template < typename Derived >
-		DiagonalMatrix&
+		BasicDiagonalMatrix&
 		operator=( const LazyDiagonalMatrixMaker< Derived >& maker ) {
 			maker.assignDataTo( *this);
 			return *this;
@@ -434,99 +1185,322 @@ namespace DenseLinAlg {
 		int rowSize() const { return rowSz; }
 		int columnSize() const { return colSz; }
 
-		void assignDataTo(Matrix& lhs) const {
+		template < typename Layout, typename Scalar >
+		void assignDataTo(BasicMatrix< Layout, Scalar >& lhs) const {
 			static_cast< const Derived & >( *this).assignDataTo_derived( lhs);
 		}
 	};
 
 
-	class Matrix
+	// Dense matrix of the elements of the type Scalar
+	// stored in a contiguous buffer in the layout given by the Layout policy
+	template < typename Layout, typename Scalar >
+	class BasicMatrix
 	{
 	private:
 		int rowSz, colSz;
-		double* data;
-		double** m;
+
+		// leading dimension, i.e. the stride between
+		// the beginnings of the successive major lines
+		int ld;
+		Scalar* data;
+
+		int bufferSize() const {
+			return Layout::majorSize( rowSz, colSz) * ld;
+		}
 
 	public:
+		typedef Layout layout_type;
+		typedef Scalar value_type;
+
 		template <typename Sig> struct result;
 
 		template <typename This, typename T>
-		struct result< This(T,T) > { typedef double type; };
+		struct result< This(T,T) > { typedef Scalar type; };
 
-		explicit Matrix(int rowSize = 1, int columnSize =1,
-					double iniVal = 0.0) :
+		explicit BasicMatrix(int rowSize = 1, int columnSize =1,
+					Scalar iniVal = 0.0) :
 			rowSz( rowSize), colSz(columnSize),
-			data( new double[rowSz*colSz] ), m( new double*[rowSz])
+			ld( Layout::leadingDimension( rowSz, colSz, sizeof( Scalar)) ),
+			data( DefaultAllocator::allocate< Scalar >( bufferSize() ) )
+		{
+			FillLines()( data, Layout::majorSize( rowSz, colSz), ld, iniVal,
+						PTT::Specified() );
+		}
+
+		BasicMatrix( const BasicMatrix& mat) :
+			rowSz( mat.rowSz), colSz( mat.colSz), ld( mat.ld),
+			data( DefaultAllocator::allocate< Scalar >( bufferSize() ) )
 		{
-			for (int i = 0; i < rowSz; i++) m[i] = data + i*colSz;
-			for (int ri = 0; ri < rowSz; ri++)
-				for (int ci = 0; ci < colSz; ci++) m[ri][ci] = iniVal;
+			CopyLines()( data, mat.data, Layout::majorSize( rowSz, colSz), ld,
+						PTT::Specified() );
 		}
 
-		Matrix( const Matrix& mat) :
-			rowSz( mat.rowSz), colSz( mat.colSz),
-			data( new double[rowSz*colSz] ), m( new double*[rowSz])
+		// Taking over the buffer of mat, which becomes an empty matrix
+		BasicMatrix( BasicMatrix&& mat) noexcept :
+			rowSz( mat.rowSz), colSz( mat.colSz), ld( mat.ld),
+			data( mat.data)
 		{
-			for (int i = 0; i < rowSz; i++) m[i] = data + i*colSz;
-				for (int ri = 0; ri < rowSz; ri++)
-					for (int ci = 0; ci < colSz; ci++)
-						m[ri][ci] = mat.m[ri][ci];
+			mat.rowSz = 0;
+			mat.colSz = 0;
+			mat.ld = 0;
+			mat.data = nullptr;
 		}
 
-		~Matrix()
+		~BasicMatrix()
 		{
-			delete [] m;
-			delete [] data;
+			DefaultAllocator::deallocate( data);
 		}
 
 		int rowSize() const { return rowSz; }
 		int columnSize() const { return colSz; }
+		int leadingDimension() const { return ld; }
+
+		// Interleaving the pages of the elements across the NUMA nodes,
+		// for a matrix read by all the threads.
+		// Returning false if the NUMA policy is not supported.
+		bool interleave() const {
+			return interleavePages( data, bufferSize() );
+		}
+
+		// exchanging the buffers of two matrices
+		void swap( BasicMatrix& mat) noexcept {
+			std::swap( rowSz, mat.rowSz);
+			std::swap( colSz, mat.colSz);
+			std::swap( ld, mat.ld);
+			std::swap( data, mat.data);
+		}
+
+		BasicMatrix& operator=( const BasicMatrix& rhs ) {
+			if ( rowSz != rhs.rowSz || colSz != rhs.colSz ) {
+				BasicMatrix copied( rhs);
+				swap( copied);
+			} else {
+				CopyLines()( data, rhs.data, Layout::majorSize( rowSz, colSz),
+							ld, PTT::Specified() );
+			}
+			return *this;
+		}
+
+		BasicMatrix& operator=( BasicMatrix&& rhs ) noexcept {
+			swap( rhs);
+			return *this;
+		}
 
 		// accesing to a matrix element
-		double& operator()(int ri, int ci) { return m[ri][ci]; }
-		const double& operator()(int ri, int ci) const { return m[ri][ci]; }
+		Scalar& operator()(int ri, int ci) {
+			return data[ Layout::index( ri, ci, ld) ];
+		}
+		const Scalar& operator()(int ri, int ci) const {
+			return data[ Layout::index( ri, ci, ld) ];
+		}
 
 		// assigning the lhs of a vector expression into this matrix
 		template<typename Expr>
-		Matrix& operator=( const ExprWrapper< Expr >& expr ) {
-			for(int ri=0; ri < rowSz; ri++)
-				for (int ci=0; ci < colSz; ci++ )
-					m[ri][ci] = MatExprGrammar()( expr(ri, ci) );
+		BasicMatrix& operator=( const ExprWrapper< Expr >& expr ) {
+			AssignMatExpr< AssignFunctor >()( expr, *this, PTT::Specified() );
 			return *this;
 		}
 
 		template < typename Derived >
-		Matrix& operator=( const LazyMatrixMaker< Derived >& maker) {
+		BasicMatrix& operator=( const LazyMatrixMaker< Derived >& maker) {
 			maker.assignDataTo( *this);
 			return *this;
 		}
 
 		// assigning and adding the lhs of a vector expression into this matrix
 		template<typename Expr>
-		Matrix& operator+=( const Expr& expr ) {
-			for(int ri=0; ri < rowSz; ri++)
-				for (int ci=0; ci < colSz; ci++ )
-					m[ri][ci] += MatExprGrammar()( expr(ri, ci) );
+		BasicMatrix& operator+=( const Expr& expr ) {
+			AssignMatExpr< PlusAssignFunctor >()( expr, *this, PTT::Specified() );
 			return *this;
 		}
 
 		// assigning and subtracting the lhs of a vector expression into
 		// this matrix
 		template<typename Expr>
-		Matrix& operator-=( const Expr& expr ) {
-			for(int ri=0; ri < rowSz; ri++)
-				for (int ci=0; ci < colSz; ci++ )
-					m[ri][ci] -= MatExprGrammar()( expr(ri, ci) );
+		BasicMatrix& operator-=( const Expr& expr ) {
+			AssignMatExpr< MinusAssignFunctor >()( expr, *this, PTT::Specified() );
 			return *this;
 		}
 
 		friend void diagPrecondConGrad( Vector & ansVec,
 				const Matrix & coeffMat, const Vector & rhsVec,
 				const Vector & initGuessVec,
-				double convergenceCriterion);
+				double convergenceCriterion,
+				DiagPrecondConGradWorkspace & workspace);
+
+		template < typename AssignType > friend struct AssignMatExpr;
 	};
 
 
+	// The edge length of the square tiles of a matrix,
+	// in which matrix expressions are evaluated
+	const int MatTileSize = 64;
+
+	// Function object for assigning a matrix expression into
+	// a matrix a tile at a time.
+	//
+	// The expression is evaluated after rewritten by MatLazyGrammar ,
+	// and the elements of a tile in the order of the memory layout.
+	// The tiles are visited column of tiles by column of tiles,
+	// so that the lazy function objects can reuse
+	// what they have prepared for the columns.
+	template < typename AssignType >
+	struct AssignMatExpr
+	{
+		// the number of the tiles along the columns
+		template < typename Layout, typename Scalar >
+		static int rowTiles( const BasicMatrix< Layout, Scalar >& lhs) {
+			return ( lhs.rowSz + MatTileSize - 1 ) / MatTileSize;
+		}
+
+		template < typename Layout, typename Scalar >
+		static int numTiles( const BasicMatrix< Layout, Scalar >& lhs) {
+			return rowTiles( lhs) *
+					( ( lhs.colSz + MatTileSize - 1 ) / MatTileSize );
+		}
+
+		template < typename LazyExpr, typename Layout, typename Scalar >
+		static void assignTile( const LazyExpr& lazyExpr,
+			BasicMatrix< Layout, Scalar >& lhs, int tile)
+		{
+			const int rBegin = tile % rowTiles( lhs) * MatTileSize,
+					cBegin = tile / rowTiles( lhs) * MatTileSize;
+			const int rEnd = std::min( rBegin + MatTileSize, lhs.rowSz),
+					cEnd = std::min( cBegin + MatTileSize, lhs.colSz);
+			// the ranges of the major and minor indices of the tile
+			const int mBegin = Layout::majorSize( rBegin, cBegin),
+					mEnd = Layout::majorSize( rEnd, cEnd),
+					nBegin = Layout::minorSize( rBegin, cBegin),
+					nEnd = Layout::minorSize( rEnd, cEnd);
+			for (int mi = mBegin; mi < mEnd; mi++)
+				for (int ni = nBegin; ni < nEnd; ni++) {
+					const int ri = Layout::rowIndex( mi, ni),
+							ci = Layout::columnIndex( mi, ni);
+					AssignType()( lhs.data[ mi * lhs.ld + ni],
+								MatExprGrammar()( lazyExpr(ri, ci) ) );
+				}
+		}
+
+		// Evaluating an expression multiplying lhs into a scratch matrix,
+		// which is then assigned into lhs
+		template < typename Expr, typename Layout, typename Scalar,
+					typename ParallelizationType >
+		void assignThroughScratch( const Expr& expr,
+			BasicMatrix< Layout, Scalar >& lhs, const ParallelizationType& pt)
+		const
+		{
+			BasicMatrix< Layout, Scalar > scratch( lhs.rowSz, lhs.colSz);
+			AssignMatExpr< AssignFunctor >()( expr, scratch, pt);
+			(*this)( proto::as_child< Domain >( scratch), lhs, pt);
+		}
+
+		template < typename Expr, typename Layout, typename Scalar,
+					typename SimdTag >
+		void operator()( const Expr& expr,
+			BasicMatrix< Layout, Scalar >& lhs,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& pt)
+		const
+		{
+			if ( MatProductAliasGrammar()( expr, 0, lhs) ) {
+				assignThroughScratch( expr, lhs, pt);
+				return;
+			}
+
+			auto lazyExpr = MatLazyGrammar< SimdTag >()( expr);
+			const int sz = numTiles( lhs);
+			for (int t = 0; t < sz; t++)
+				assignTile( lazyExpr, lhs, t);
+		}
+
+		template < typename Expr, typename Layout, typename Scalar,
+					typename SimdTag >
+		void operator()( const Expr& expr,
+			BasicMatrix< Layout, Scalar >& lhs,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >& pt)
+		const
+		{
+			if ( MatProductAliasGrammar()( expr, 0, lhs) ) {
+				assignThroughScratch( expr, lhs, pt);
+				return;
+			}
+
+			const int sz = numTiles( lhs);
+			#pragma omp parallel shared( lhs)
+			{
+				auto lazyExpr = MatLazyGrammar< SimdTag >()( expr);
+				#pragma omp for schedule( static)
+				for (int t = 0; t < sz; t++)
+					assignTile( lazyExpr, lhs, t);
+			}
+		}
+
+		template < typename Expr, typename Layout, typename Scalar,
+					typename SimdTag >
+		void operator()( const Expr& expr,
+			BasicMatrix< Layout, Scalar >& lhs,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >& pt)
+		const
+		{
+			if ( MatProductAliasGrammar()( expr, 0, lhs) ) {
+				assignThroughScratch( expr, lhs, pt);
+				return;
+			}
+
+			// Every worker makes its own lazy function objects.
+			typedef typename std::decay<
+				decltype( MatLazyGrammar< SimdTag >()( expr) ) >::type Lazy;
+			PTT::WorkStealingPool& pool = PTT::WorkStealingPool::local();
+			PTT::WorkerStates< Lazy > lazyExprs( pool);
+			const int sz = numTiles( lhs);
+			pool.parallelFor( 0, sz, pool.chunkSize( sz),
+				[&expr, &lhs, &lazyExprs]( int first, int last) {
+					lazyExprs.run(
+						[&expr]() {
+							return new Lazy( MatLazyGrammar< SimdTag >()( expr) ); },
+						[&lhs, first, last]( Lazy& lazyExpr) {
+							for (int t = first; t < last; t++)
+								assignTile( lazyExpr, lhs, t);
+						} );
+				} );
+		}
+
+		template < typename Expr, typename Layout, typename Scalar >
+		void operator()( const Expr& expr,
+			BasicMatrix< Layout, Scalar >& lhs,
+			const PTT::SingleProcess< PTT::Runtime >& )
+		const
+		{
+			PTT::dispatch( *this, expr, lhs);
+		}
+
+		// The dense matrices are not distributed.
+		template < typename Expr, typename Layout, typename Scalar,
+					typename Multithreading >
+		void operator()( const Expr& expr,
+			BasicMatrix< Layout, Scalar >& lhs,
+			const PTT::MPI< Multithreading >& )
+		const
+		{
+			(*this)( expr, lhs, PTT::SingleProcess< Multithreading >() );
+		}
+	};
+
+
+	// Overloads of swap() found by the argument dependent lookup
+	template < typename Scalar >
+	inline void swap( BasicVector< Scalar >& a, BasicVector< Scalar >& b)
+	noexcept { a.swap( b); }
+	template < typename Scalar >
+	inline void swap( BasicDiagonalMatrix< Scalar >& a,
+						BasicDiagonalMatrix< Scalar >& b) noexcept {
+		a.swap( b);
+	}
+	template < typename Layout, typename Scalar >
+	inline void swap( BasicMatrix< Layout, Scalar >& a,
+						BasicMatrix< Layout, Scalar >& b)
+	noexcept { a.swap( b); }
+
 }
 
 
@@ -0,0 +1,387 @@
+/*
+ * MultiVector.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef DENSELINALG_MULTIVECTOR_HPP_
+#define DENSELINALG_MULTIVECTOR_HPP_
+
+#include <math.h>
+
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <vector>
+#include <boost/proto/proto.hpp>
+
+#include <ParallelizationTypeTag/Default.hpp>
+
+#include <DenseLinAlg/Grammar.hpp>
+#include <DenseLinAlg/Allocator.hpp>
+#include <DenseLinAlg/FirstTouch.hpp>
+#include <DenseLinAlg/MatrixVector.hpp>
+
+
+namespace DenseLinAlg {
+
+	namespace proto = boost::proto;
+
+	namespace PTT = ParallelizationTypeTag;
+
+
+	// Callable transform object to evaluate an element of
+	// a vector, a diagonal matrix, a multivector or a lazy function object
+	struct MultiVecElement : proto::callable
+	{
+		typedef double result_type;
+
+		template < typename T >
+		double operator()( const T& obj, int i) const { return obj( i); }
+
+		template < typename T >
+		double operator()( const T& obj, int i, int j) const {
+			return obj( i, j);
+		}
+	};
+
+	// Callable transform object to multiply two elements
+	struct ScalarMult : proto::callable
+	{
+		typedef double result_type;
+
+		double operator()( double a, double b) const { return a * b; }
+	};
+
+
+	template < typename AssignType > struct AssignMultiVecExpr;
+
+	// Set of numVectors vectors of the same size.
+	//
+	// The vectors are stored interleaved, so that the i'th elements
+	// of all the vectors are adjacent, data[ i * numVectors + j ] .
+	// Multiplying a matrix and a multivector thus reads every element
+	// of the matrix once for all the vectors.
+	class MultiVector {
+	private:
+		int sz, numVecs;
+		double* data;
+
+		template < typename SimdTag >
+		void _dot( const MultiVector& mv, Vector& result,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >&)
+		const
+		{
+			double* const d = &result(0);
+			for (int j = 0; j < numVecs; j++) d[j] = 0.0;
+			for (int i = 0; i < sz; i++) {
+				const double* const x = data + i * numVecs;
+				const double* const y = mv.data + i * numVecs;
+				for (int j = 0; j < numVecs; j++) d[j] += x[j] * y[j];
+			}
+		}
+
+		template < typename SimdTag >
+		void _dot( const MultiVector& mv, Vector& result,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >&)
+		const
+		{
+			double* const d = &result(0);
+			const int k = numVecs;
+			for (int j = 0; j < k; j++) d[j] = 0.0;
+			#pragma omp parallel for reduction (+:d[:k])
+			for (int i = 0; i < sz; i++) {
+				const double* const x = data + i * k;
+				const double* const y = mv.data + i * k;
+				for (int j = 0; j < k; j++) d[j] += x[j] * y[j];
+			}
+		}
+
+		// The partial sums of the blocks are added in order,
+		// so that the result does not depend on the threads.
+		template < typename SimdTag >
+		void _dot( const MultiVector& mv, Vector& result,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >&)
+		const
+		{
+			const int k = numVecs;
+			const double* const xs = data;
+			const double* const ys = mv.data;
+			const std::vector< double > d =
+				PTT::WorkStealingPool::local().reduceBlocks(
+					sz, SimdBlockSize, std::vector< double >( k, 0.0),
+					[xs, ys, k]( int first, int last,
+								std::vector< double >* partials) {
+						for (int b = first; b < last; b += SimdBlockSize) {
+							const int end = std::min( b + SimdBlockSize, last);
+							double* const acc = partials->data();
+							for (int i = b; i < end; i++) {
+								const double* const x = xs + i * k;
+								const double* const y = ys + i * k;
+								for (int j = 0; j < k; j++) acc[j] += x[j] * y[j];
+							}
+							partials++;
+						}
+					},
+					[k]( std::vector< double >& acc,
+						const std::vector< double >& partial) {
+						for (int j = 0; j < k; j++) acc[j] += partial[j];
+					} );
+			for (int j = 0; j < k; j++) result(j) = d[j];
+		}
+
+		// The kernel is selected at run time.
+		struct DotCall {
+			const MultiVector& self;
+
+			template < typename ParallelizationType >
+			void operator()( const MultiVector& mv, Vector& result,
+							const ParallelizationType& pt) const {
+				self._dot( mv, result, pt);
+			}
+		};
+
+		void _dot( const MultiVector& mv, Vector& result,
+					const PTT::SingleProcess< PTT::Runtime >&) const {
+			PTT::dispatch( DotCall{ *this }, mv, result);
+		}
+
+		// The dot products of the rows of the processes are summed.
+		template < typename Multithreading >
+		void _dot( const MultiVector& mv, Vector& result,
+					const PTT::MPI< Multithreading >& pt) const {
+			_dot( mv, result, PTT::SingleProcess< Multithreading >() );
+			if ( numVecs > 0 ) allreduceSum( &result(0), numVecs, pt);
+		}
+
+	public:
+		typedef double value_type;
+
+		template <typename Sig> struct result;
+
+		template <typename This, typename T>
+		struct result< This(T,T) > { typedef double type; };
+
+		// No initialization, though the pages are touched first
+		// by the threads evaluating their rows
+		explicit MultiVector(int size = 1, int numVectors = 1) :
+			sz( size), numVecs( numVectors),
+			data( DefaultAllocator::allocate( sz * numVecs) )
+		{
+			TouchLines()( data, sz, numVecs, PTT::Specified() );
+		}
+
+		explicit MultiVector(int size, int numVectors, double iniVal) :
+			sz( size), numVecs( numVectors),
+			data( DefaultAllocator::allocate( sz * numVecs) )
+		{
+			FillLines()( data, sz, numVecs, iniVal, PTT::Specified() );
+		}
+
+		MultiVector( const MultiVector& mv) :
+			sz( mv.sz), numVecs( mv.numVecs),
+			data( DefaultAllocator::allocate( sz * numVecs) )
+		{
+			CopyLines()( data, mv.data, sz, numVecs, PTT::Specified() );
+		}
+
+		// Taking over the buffer of mv, which becomes an empty multivector
+		MultiVector( MultiVector&& mv) noexcept :
+			sz( mv.sz), numVecs( mv.numVecs), data( mv.data)
+		{
+			mv.sz = 0;
+			mv.numVecs = 0;
+			mv.data = nullptr;
+		}
+
+		~MultiVector() {
+			DefaultAllocator::deallocate( data);
+		}
+
+		int size() const { return sz; }
+		int numVectors() const { return numVecs; }
+		int rowSize() const { return sz; }
+		int columnSize() const { return numVecs; }
+
+		// exchanging the buffers of two multivectors
+		void swap( MultiVector& mv) noexcept {
+			std::swap( sz, mv.sz);
+			std::swap( numVecs, mv.numVecs);
+			std::swap( data, mv.data);
+		}
+
+		// accessing to the i'th element of the j'th vector
+		double& operator()(int i, int j) { return data[ i * numVecs + j]; }
+		const double& operator()(int i, int j) const {
+			return data[ i * numVecs + j];
+		}
+
+		// the i'th elements of all the vectors
+		double* row(int i) { return data + i * numVecs; }
+		const double* row(int i) const { return data + i * numVecs; }
+
+		// copying the j'th vector from / to a vector
+		void setVector(int j, const Vector& vec) {
+			for (int i = 0; i < sz; i++) data[ i * numVecs + j] = vec(i);
+		}
+
+		void getVector(int j, Vector& vec) const {
+			for (int i = 0; i < sz; i++) vec(i) = data[ i * numVecs + j];
+		}
+
+		// dot products between the corresponding vectors
+		// of this and mv, which are stored into result
+		void dot( const MultiVector& mv, Vector& result) const {
+			_dot( mv, result, PTT::Specified());
+		}
+
+		// absolute values of all the vectors
+		void abs( Vector& result) const {
+			_dot( *this, result, PTT::Specified());
+			for (int j = 0; j < numVecs; j++) result(j) = sqrt( result(j));
+		}
+
+		MultiVector& operator=( const MultiVector& rhs ) {
+			if ( sz != rhs.sz || numVecs != rhs.numVecs ) {
+				MultiVector copied( rhs);
+				swap( copied);
+			} else {
+				CopyLines()( data, rhs.data, sz, numVecs, PTT::Specified() );
+			}
+			return *this;
+		}
+
+		// The old buffer of this multivector is released by rhs.
+		MultiVector& operator=( MultiVector&& rhs ) noexcept {
+			swap( rhs);
+			return *this;
+		}
+
+		// assigning the lhs of a multivector expression into this multivector
+		template < typename Expr >
+		MultiVector& operator=( const ExprWrapper< Expr >& expr ) {
+			AssignMultiVecExpr< AssignFunctor >()(
+					expr, *this, PTT::Specified() );
+			return *this;
+		}
+
+		template < typename Expr >
+		MultiVector& operator+=( const ExprWrapper< Expr >& expr ) {
+			AssignMultiVecExpr< PlusAssignFunctor >()(
+					expr, *this, PTT::Specified() );
+			return *this;
+		}
+
+		template < typename Expr >
+		MultiVector& operator-=( const ExprWrapper< Expr >& expr ) {
+			AssignMultiVecExpr< MinusAssignFunctor >()(
+					expr, *this, PTT::Specified() );
+			return *this;
+		}
+
+		template < typename AssignType > friend struct AssignMultiVecExpr;
+	};
+
+	inline void swap( MultiVector& a, MultiVector& b) noexcept { a.swap( b); }
+
+
+	// Function object for assigning
+	// a multivector expression into a multivector object .
+	//
+	// The matrix multivector multiplications in the expression are
+	// first replaced by the lazy function objects computing a whole row,
+	// and then the elements are evaluated row by row.
+	// Every thread makes its own lazy function objects,
+	// since they keep the row being computed.
+	template < typename AssignType >
+	struct AssignMultiVecExpr
+	{
+		template < typename Expr, typename SimdTag >
+		void operator()(
+			const ExprWrapper< Expr >& expr, MultiVector& lhs,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& )
+		const
+		{
+			auto lazyExpr = MultiVecLazyGrammar()( expr);
+			const int k = lhs.numVecs;
+			for (int i = 0; i < lhs.sz; i++) {
+				double* const lhsRow = lhs.data + i * k;
+				for (int j = 0; j < k; j++)
+					AssignType()( lhsRow[j],
+							MultiVecElmGrammar()( lazyExpr, i, j) );
+			}
+		}
+
+		template < typename Expr, typename SimdTag >
+		void operator()(
+			const ExprWrapper< Expr >& expr, MultiVector& lhs,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >& )
+		const
+		{
+			const int k = lhs.numVecs;
+			#pragma omp parallel
+			{
+				auto lazyExpr = MultiVecLazyGrammar()( expr);
+				#pragma omp for
+				for (int i = 0; i < lhs.sz; i++) {
+					double* const lhsRow = lhs.data + i * k;
+					for (int j = 0; j < k; j++)
+						AssignType()( lhsRow[j],
+								MultiVecElmGrammar()( lazyExpr, i, j) );
+				}
+			}
+		}
+
+		template < typename Expr, typename SimdTag >
+		void operator()(
+			const ExprWrapper< Expr >& expr, MultiVector& lhs,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >& )
+		const
+		{
+			// Every worker makes its own lazy function objects.
+			typedef typename std::decay<
+				decltype( MultiVecLazyGrammar()( expr) ) >::type Lazy;
+			PTT::WorkStealingPool& pool = PTT::WorkStealingPool::local();
+			PTT::WorkerStates< Lazy > lazyExprs( pool);
+			const int k = lhs.numVecs;
+			double* const data = lhs.data;
+			pool.parallelFor( 0, lhs.sz, pool.chunkSize( lhs.sz),
+				[&expr, &lazyExprs, data, k]( int first, int last) {
+					lazyExprs.run(
+						[&expr]() { return new Lazy( MultiVecLazyGrammar()( expr) ); },
+						[data, k, first, last]( Lazy& lazyExpr) {
+							for (int i = first; i < last; i++) {
+								double* const lhsRow = data + i * k;
+								for (int j = 0; j < k; j++)
+									AssignType()( lhsRow[j],
+										MultiVecElmGrammar()( lazyExpr, i, j) );
+							}
+						} );
+				} );
+		}
+
+		template < typename Expr >
+		void operator()(
+			const ExprWrapper< Expr >& expr, MultiVector& lhs,
+			const PTT::SingleProcess< PTT::Runtime >& )
+		const
+		{
+			PTT::dispatch( *this, expr, lhs);
+		}
+
+		// assigning the rows of this process
+		template < typename Expr, typename Multithreading >
+		void operator()(
+			const ExprWrapper< Expr >& expr, MultiVector& lhs,
+			const PTT::MPI< Multithreading >& )
+		const
+		{
+			(*this)( expr, lhs, PTT::SingleProcess< Multithreading >() );
+		}
+	};
+
+}
+
+
+#endif /* DENSELINALG_MULTIVECTOR_HPP_ */
@@ -0,0 +1,526 @@
+/*
+ * Reduction.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef DENSELINALG_REDUCTION_HPP_
+#define DENSELINALG_REDUCTION_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+#include <boost/proto/proto.hpp>
+
+#include <ParallelizationTypeTag/Default.hpp>
+
+#include <DenseLinAlg/Grammar.hpp>
+#include <DenseLinAlg/MatrixVector.hpp>
+#include <DenseLinAlg/Transpose.hpp>
+
+
+namespace DenseLinAlg {
+
+	namespace proto = boost::proto;
+
+	namespace PTT = ParallelizationTypeTag;
+
+
+	struct VecSize : proto::callable
+	{
+		typedef int result_type;
+
+		template < typename T >
+		int operator()( const T& vec) const { return vec.size(); }
+	};
+
+	struct MatRowSize : proto::callable
+	{
+		typedef int result_type;
+
+		template < typename T >
+		int operator()( const T& mat) const { return mat.rowSize(); }
+	};
+
+
+	// The ways of combining the partial results of the threads
+	// and of the processes
+	struct PlusCombination
+	{
+		template < typename T >
+		static void combine( T& acc, T e) { acc += e; }
+
+		template < typename T, typename Multithreading >
+		static void combineProcesses( T& acc,
+								const PTT::MPI< Multithreading >& pt) {
+			acc = allreduceSum( acc, pt);
+		}
+	};
+
+	struct MaxCombination
+	{
+		template < typename T >
+		static void combine( T& acc, T e) { if ( e > acc ) acc = e; }
+
+		template < typename T, typename Multithreading >
+		static void combineProcesses( T& acc,
+								const PTT::MPI< Multithreading >& pt) {
+			acc = allreduceMax( acc, pt);
+		}
+	};
+
+	// Reduction operations, defining the contribution of the elements
+	// of the operands and the final result from the combined contributions
+	struct DotOp
+	{
+		typedef PlusCombination Combination;
+
+		template < typename A, typename B >
+		static auto element( A a, B b) -> decltype( a * b) { return a * b; }
+
+		template < typename T >
+		static T finish( T acc) { return acc; }
+	};
+
+	struct Norm2Op
+	{
+		typedef PlusCombination Combination;
+
+		template < typename A >
+		static A element( A a) { return a * a; }
+
+		template < typename T >
+		static T finish( T acc) { return std::sqrt( acc); }
+	};
+
+	struct SumOp
+	{
+		typedef PlusCombination Combination;
+
+		template < typename A >
+		static A element( A a) { return a; }
+
+		template < typename T >
+		static T finish( T acc) { return acc; }
+	};
+
+	struct MaxAbsOp
+	{
+		typedef MaxCombination Combination;
+
+		template < typename A >
+		static A element( A a) { return a < 0 ? -a : a; }
+
+		template < typename T >
+		static T finish( T acc) { return acc; }
+	};
+
+
+	// The operand of a reduction, a vector or a vector expression.
+	// The vector is held by reference in a terminal,
+	// while the expression is held by reference as it is.
+	template < typename T >
+	struct VecReductionOperand
+	{
+		typedef typename proto::result_of::as_child<
+									const T, Domain >::type type;
+
+		// the output of VecLazyGrammar for SimdTag and its elements
+		template < typename SimdTag >
+		struct lazy_type
+		{
+			typedef typename VecReductionOperand::type operand_type;
+			typedef typename std::decay< decltype(
+				VecLazyGrammar< SimdTag >()( std::declval< operand_type >(),
+					std::declval< operand_type >(),
+					std::declval< VecExprMemo& >() )
+			) >::type type;
+		};
+
+		typedef typename std::decay< decltype(
+			VecExprGrammar()( std::declval<
+				typename lazy_type< PTT::NoSIMD >::type& >()( 0) )
+		) >::type element_type;
+	};
+
+	// Meta function telling whether T is a vector or a vector expression
+	template < typename T >
+	struct IsVecReductionOperand : proto::matches<
+		typename std::remove_reference<
+			typename proto::result_of::as_child< const T, Domain >::type
+		>::type,
+		VecExprGrammar > {};
+
+
+	template < typename Combination > struct ReduceVecExpr;
+
+	// Reduction of a vector expression, like norm2( b - A * x ) .
+	//
+	// It is evaluated in a single pass over the operand
+	// when converted into its result type, so that the operand is
+	// not stored into a temporary vector.
+	// The operand holds its subexpressions by reference
+	// like the other expressions, and thus
+	// it should be evaluated in the full expression making it.
+	template < typename Op, typename Operand >
+	class UnaryVecReduction
+	{
+	private:
+		typedef VecReductionOperand< Operand > OperandTraits;
+
+		typename OperandTraits::type operand;
+
+	public:
+		typedef typename std::decay< decltype( Op::element(
+			std::declval< typename OperandTraits::element_type >() )
+		) >::type result_type;
+
+		explicit UnaryVecReduction( const Operand& e) :
+			operand( proto::as_child< Domain >( e) ) {}
+
+		int size() const { return VecSizeGrammar()( operand); }
+
+		// exchanging the halos of the distributed matrix vector products,
+		// and releasing them after the evaluation
+		void exchangeHalos() const { HaloExchangeGrammar()( operand, 0); }
+		void releaseHalos() const { HaloReleaseGrammar()( operand, 0); }
+
+		// computing the products of the transposed matrices by the threads
+		template < typename ParallelizationType >
+		void computeTransProducts( const ParallelizationType& pt) const {
+			TransProductGrammar()( operand, 0, pt);
+		}
+
+		// Evaluator of the contributions of the elements
+		// by the kernels of the SIMD extension SimdTag .
+		// Every thread makes its own evaluator,
+		// since the lazy function objects in it have their caches.
+		template < typename SimdTag >
+		class Evaluator
+		{
+		private:
+			VecExprMemo memo;
+			typename OperandTraits::template lazy_type< SimdTag >::type lazy;
+
+		public:
+			explicit Evaluator( const UnaryVecReduction& r) :
+				lazy( VecLazyGrammar< SimdTag >()( r.operand, r.operand, memo) )
+			{}
+
+			result_type operator()( int i) {
+				return Op::element( VecExprGrammar()( lazy( i) ) );
+			}
+		};
+
+		result_type value() const {
+			return Op::finish(
+				ReduceVecExpr< typename Op::Combination >()(
+					*this, PTT::Specified() ) );
+		}
+
+		operator result_type() const { return value(); }
+	};
+
+	// Reduction of two vector expressions, like dot( p, A * p )
+	template < typename Op, typename Operand1, typename Operand2 >
+	class BinaryVecReduction
+	{
+	private:
+		typedef VecReductionOperand< Operand1 > OperandTraits1;
+		typedef VecReductionOperand< Operand2 > OperandTraits2;
+
+		typename OperandTraits1::type operand1;
+		typename OperandTraits2::type operand2;
+
+	public:
+		typedef typename std::decay< decltype( Op::element(
+			std::declval< typename OperandTraits1::element_type >(),
+			std::declval< typename OperandTraits2::element_type >() )
+		) >::type result_type;
+
+		// The operands should be of the same size.
+		explicit BinaryVecReduction( const Operand1& e1, const Operand2& e2) :
+			operand1( proto::as_child< Domain >( e1) ),
+			operand2( proto::as_child< Domain >( e2) )
+		{
+			assert( VecSizeGrammar()( operand1) == VecSizeGrammar()( operand2) );
+		}
+
+		int size() const { return VecSizeGrammar()( operand1); }
+
+		void exchangeHalos() const {
+			HaloExchangeGrammar()( operand1, 0);
+			HaloExchangeGrammar()( operand2, 0);
+		}
+
+		void releaseHalos() const {
+			HaloReleaseGrammar()( operand1, 0);
+			HaloReleaseGrammar()( operand2, 0);
+		}
+
+		template < typename ParallelizationType >
+		void computeTransProducts( const ParallelizationType& pt) const {
+			TransProductGrammar()( operand1, 0, pt);
+			TransProductGrammar()( operand2, 0, pt);
+		}
+
+		template < typename SimdTag >
+		class Evaluator
+		{
+		private:
+			VecExprMemo memo1, memo2;
+			typename OperandTraits1::template lazy_type< SimdTag >::type lazy1;
+			typename OperandTraits2::template lazy_type< SimdTag >::type lazy2;
+
+		public:
+			explicit Evaluator( const BinaryVecReduction& r) :
+				lazy1( VecLazyGrammar< SimdTag >()(
+										r.operand1, r.operand1, memo1) ),
+				lazy2( VecLazyGrammar< SimdTag >()(
+										r.operand2, r.operand2, memo2) ) {}
+
+			result_type operator()( int i) {
+				return Op::element( VecExprGrammar()( lazy1( i) ),
+									VecExprGrammar()( lazy2( i) ) );
+			}
+		};
+
+		result_type value() const {
+			return Op::finish(
+				ReduceVecExpr< typename Op::Combination >()(
+					*this, PTT::Specified() ) );
+		}
+
+		operator result_type() const { return value(); }
+	};
+
+
+	// Function objects for accumulating the contributions of the elements
+	// of a reduction in a single loop
+	template <>
+	struct ReduceVecExpr< PlusCombination >
+	{
+		template < typename Reduction, typename SimdTag >
+		typename Reduction::result_type operator()( const Reduction& r,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& pt)
+		const
+		{
+			r.computeTransProducts( pt);
+			typename Reduction::template Evaluator< SimdTag > elm( r);
+			typename Reduction::result_type acc = 0;
+			const int sz = r.size();
+			for (int i = 0; i < sz; i++) acc += elm( i);
+			return acc;
+		}
+
+		template < typename Reduction, typename SimdTag >
+		typename Reduction::result_type operator()( const Reduction& r,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >& pt)
+		const
+		{
+			r.computeTransProducts( pt);
+			typename Reduction::result_type acc = 0;
+			const int sz = r.size();
+			#pragma omp parallel reduction (+:acc)
+			{
+				typename Reduction::template Evaluator< SimdTag > elm( r);
+				#pragma omp for
+				for (int i = 0; i < sz; i++) acc += elm( i);
+			}
+			return acc;
+		}
+
+		// The partial sums of the blocks are added in order,
+		// so that the result does not depend on the threads.
+		// Every worker makes its own evaluator used by the tasks it runs.
+		template < typename Reduction, typename SimdTag >
+		typename Reduction::result_type operator()( const Reduction& r,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >& pt)
+		const
+		{
+			r.computeTransProducts( pt);
+			typedef typename Reduction::result_type T;
+			typedef typename Reduction::template Evaluator< SimdTag > Evaluator;
+			PTT::WorkStealingPool& pool = PTT::WorkStealingPool::local();
+			PTT::WorkerStates< Evaluator > evaluators( pool);
+			return pool.reduceBlocks( r.size(), SimdBlockSize, T( 0),
+				[&r, &evaluators]( int first, int last, T* partials) {
+					evaluators.run( [&r]() { return new Evaluator( r); },
+						[first, last, partials]( Evaluator& elm) {
+							T* p = partials;
+							for (int b = first; b < last; b += SimdBlockSize) {
+								const int end = std::min( b + SimdBlockSize, last);
+								T acc = 0;
+								for (int i = b; i < end; i++) acc += elm( i);
+								*p++ = acc;
+							}
+						} );
+				},
+				[]( T& acc, T partial) { PlusCombination::combine( acc, partial); } );
+		}
+
+		template < typename Reduction >
+		typename Reduction::result_type operator()( const Reduction& r,
+			const PTT::SingleProcess< PTT::Runtime >& )
+		const
+		{
+			return PTT::dispatch( *this, r);
+		}
+
+		// The contributions of the rows of the processes are combined.
+		template < typename Reduction, typename Multithreading >
+		typename Reduction::result_type operator()( const Reduction& r,
+			const PTT::MPI< Multithreading >& pt)
+		const
+		{
+			r.exchangeHalos();
+			typename Reduction::result_type acc =
+				(*this)( r, PTT::SingleProcess< Multithreading >() );
+			r.releaseHalos();
+			PlusCombination::combineProcesses( acc, pt);
+			return acc;
+		}
+	};
+
+	// The contributions of MaxCombination are not negative.
+	template <>
+	struct ReduceVecExpr< MaxCombination >
+	{
+		template < typename Reduction, typename SimdTag >
+		typename Reduction::result_type operator()( const Reduction& r,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& pt)
+		const
+		{
+			r.computeTransProducts( pt);
+			typename Reduction::template Evaluator< SimdTag > elm( r);
+			typename Reduction::result_type acc = 0;
+			const int sz = r.size();
+			for (int i = 0; i < sz; i++) {
+				const typename Reduction::result_type e = elm( i);
+				if ( e > acc ) acc = e;
+			}
+			return acc;
+		}
+
+		template < typename Reduction, typename SimdTag >
+		typename Reduction::result_type operator()( const Reduction& r,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >& pt)
+		const
+		{
+			r.computeTransProducts( pt);
+			typename Reduction::result_type acc = 0;
+			const int sz = r.size();
+			#pragma omp parallel reduction (max:acc)
+			{
+				typename Reduction::template Evaluator< SimdTag > elm( r);
+				#pragma omp for
+				for (int i = 0; i < sz; i++) {
+					const typename Reduction::result_type e = elm( i);
+					if ( e > acc ) acc = e;
+				}
+			}
+			return acc;
+		}
+
+		template < typename Reduction, typename SimdTag >
+		typename Reduction::result_type operator()( const Reduction& r,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >& pt)
+		const
+		{
+			r.computeTransProducts( pt);
+			typedef typename Reduction::result_type T;
+			typedef typename Reduction::template Evaluator< SimdTag > Evaluator;
+			PTT::WorkStealingPool& pool = PTT::WorkStealingPool::local();
+			PTT::WorkerStates< Evaluator > evaluators( pool);
+			return pool.reduceBlocks( r.size(), SimdBlockSize, T( 0),
+				[&r, &evaluators]( int first, int last, T* partials) {
+					evaluators.run( [&r]() { return new Evaluator( r); },
+						[first, last, partials]( Evaluator& elm) {
+							T* p = partials;
+							for (int b = first; b < last; b += SimdBlockSize) {
+								const int end = std::min( b + SimdBlockSize, last);
+								T acc = 0;
+								for (int i = b; i < end; i++) {
+									const T e = elm( i);
+									if ( e > acc ) acc = e;
+								}
+								*p++ = acc;
+							}
+						} );
+				},
+				[]( T& acc, T partial) { MaxCombination::combine( acc, partial); } );
+		}
+
+		template < typename Reduction >
+		typename Reduction::result_type operator()( const Reduction& r,
+			const PTT::SingleProcess< PTT::Runtime >& )
+		const
+		{
+			return PTT::dispatch( *this, r);
+		}
+
+		// The contributions of the rows of the processes are combined.
+		template < typename Reduction, typename Multithreading >
+		typename Reduction::result_type operator()( const Reduction& r,
+			const PTT::MPI< Multithreading >& pt)
+		const
+		{
+			r.exchangeHalos();
+			typename Reduction::result_type acc =
+				(*this)( r, PTT::SingleProcess< Multithreading >() );
+			r.releaseHalos();
+			MaxCombination::combineProcesses( acc, pt);
+			return acc;
+		}
+	};
+
+
+	// dot product of two vector expressions
+	template < typename E1, typename E2 >
+	typename std::enable_if<
+		IsVecReductionOperand< E1 >::value &&
+		IsVecReductionOperand< E2 >::value,
+		BinaryVecReduction< DotOp, E1, E2 >
+	>::type
+	dot( const E1& e1, const E2& e2)
+	{
+		return BinaryVecReduction< DotOp, E1, E2 >( e1, e2);
+	}
+
+	// Euclidean norm of a vector expression
+	template < typename E >
+	typename std::enable_if< IsVecReductionOperand< E >::value,
+		UnaryVecReduction< Norm2Op, E >
+	>::type
+	norm2( const E& e)
+	{
+		return UnaryVecReduction< Norm2Op, E >( e);
+	}
+
+	// sum of the elements of a vector expression
+	template < typename E >
+	typename std::enable_if< IsVecReductionOperand< E >::value,
+		UnaryVecReduction< SumOp, E >
+	>::type
+	sum( const E& e)
+	{
+		return UnaryVecReduction< SumOp, E >( e);
+	}
+
+	// maximum absolute value of the elements of a vector expression
+	template < typename E >
+	typename std::enable_if< IsVecReductionOperand< E >::value,
+		UnaryVecReduction< MaxAbsOp, E >
+	>::type
+	max_abs( const E& e)
+	{
+		return UnaryVecReduction< MaxAbsOp, E >( e);
+	}
+
+}
+
+
+#endif /* DENSELINALG_REDUCTION_HPP_ */
@@ -0,0 +1,569 @@
+/*
+ * Simd.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef DENSELINALG_SIMD_HPP_
+#define DENSELINALG_SIMD_HPP_
+
+#include <type_traits>
+#include <boost/proto/proto.hpp>
+
+// GCC compiles the SIMD kernels for the SIMD extensions
+// not enabled by the command line options, like -mavx ,
+// as the functions of their own targets,
+// so that a binary for any x86 processor selects them at run time
+// by ParallelizationTypeTag/Dispatch.hpp .
+#if defined(__GNUC__) && ! defined(__clang__) && \
+	( defined(__x86_64__) || defined(__i386__) )
+#define DENSELINALG_SIMD_MULTIVERSION_
+#endif
+
+#if defined(__SSE2__) || defined(DENSELINALG_SIMD_MULTIVERSION_)
+#include <immintrin.h>
+#endif
+
+#include <ParallelizationTypeTag/ParallelizationTypeTag.hpp>
+
+#include <DenseLinAlg/Grammar.hpp>
+
+
+namespace DenseLinAlg {
+
+	namespace proto = boost::proto;
+	namespace PTT = ParallelizationTypeTag;
+
+
+	struct AssignFunctor;
+	struct PlusAssignFunctor;
+	struct MinusAssignFunctor;
+
+
+	// The kernels over the arrays of double-precision elements,
+	// written once on the operations of the register type reg ,
+	// and stamped into each specialization of SimdDoubleOps
+	// so that they are compiled for its SIMD extension.
+	// The products and the sums are not fused, so that each element
+	// is computed in the same way as the scalar code.
+#define DENSELINALG_SIMD_KERNELS_ \
+		static reg combine( reg, reg r, AssignFunctor* ) { return r; } \
+		static reg combine( reg l, reg r, PlusAssignFunctor* ) { \
+			return add( l, r); \
+		} \
+		static reg combine( reg l, reg r, MinusAssignFunctor* ) { \
+			return sub( l, r); \
+		} \
+		\
+		/* the dot product of the elements from first to last */ \
+		static double dot( const double* x, const double* y, \
+							int first, int last) \
+		{ \
+			reg acc0 = set1( 0.0), acc1 = set1( 0.0); \
+			int i = first; \
+			for (; i + 2 * width <= last; i += 2 * width) { \
+				acc0 = add( acc0, mul( load( x + i), load( y + i) ) ); \
+				acc1 = add( acc1, \
+					mul( load( x + i + width), load( y + i + width) ) ); \
+			} \
+			for (; i + width <= last; i += width) \
+				acc0 = add( acc0, mul( load( x + i), load( y + i) ) ); \
+			double d = sum( add( acc0, acc1) ); \
+			for (; i < last; i++) d += x[i] * y[i]; \
+			return d; \
+		} \
+		\
+		/* assigning the elements by the function object AssignType */ \
+		template < typename AssignType > \
+		static void assign( double* lhs, const double* rhs, \
+							int first, int last) \
+		{ \
+			int i = first; \
+			for (; i + width <= last; i += width) { \
+				const reg r = load( rhs + i); \
+				store( lhs + i, \
+					std::is_same< AssignType, AssignFunctor >::value ? r : \
+					combine( load( lhs + i), r, (AssignType*)nullptr ) ); \
+			} \
+			for (; i < last; i++) AssignType()( lhs[i], rhs[i]); \
+		} \
+		\
+		/* multiplying the elements of a and b */ \
+		static void multiply( double* lhs, const double* a, const double* b, \
+							int first, int last) \
+		{ \
+			int i = first; \
+			for (; i + width <= last; i += width) \
+				store( lhs + i, mul( load( a + i), load( b + i) ) ); \
+			for (; i < last; i++) lhs[i] = a[i] * b[i]; \
+		} \
+		\
+		/* multiplying the height rows of a slice stored column-major, \
+		   like a chunk of a SELL matrix, and x , \
+		   y[ l ] = a[ l ] * x[ col[ l ] ] + a[ l + height ] * ... \
+		   for the size elements; the height is a multiple of width */ \
+		static void multiplySlice( double* y, const double* a, \
+							const int* col, const double* x, \
+							int height, int size) \
+		{ \
+			for (int l = 0; l < height; l += width) { \
+				reg acc = set1( 0.0); \
+				for (int k = l; k < size; k += height) \
+					acc = add( acc, mul( load( a + k), gather( x, col + k) ) ); \
+				store( y + l, acc); \
+			} \
+		} \
+		\
+		/* adding the product of the panels a and b , packed k by k as \
+		   a[ k * panelRows + r ] and b[ k * 2 * width + l ] , \
+		   into the panelRows x ( 2 * width ) block of c , \
+		   whose rows are ldc apart */ \
+		static void multiplyPanels( int depth, const double* a, \
+							const double* b, double* c, int ldc) \
+		{ \
+			reg acc[ panelRows ][ 2 ]; \
+			for (int r = 0; r < panelRows; r++) \
+				acc[r][0] = acc[r][1] = set1( 0.0); \
+			for (int k = 0; k < depth; k++) { \
+				const reg b0 = load( b + k * 2 * width), \
+						b1 = load( b + k * 2 * width + width); \
+				for (int r = 0; r < panelRows; r++) { \
+					const reg ar = set1( a[ k * panelRows + r]); \
+					acc[r][0] = add( acc[r][0], mul( ar, b0) ); \
+					acc[r][1] = add( acc[r][1], mul( ar, b1) ); \
+				} \
+			} \
+			for (int r = 0; r < panelRows; r++) { \
+				double* const cr = c + r * ldc; \
+				store( cr, add( load( cr), acc[r][0]) ); \
+				store( cr + width, add( load( cr + width), acc[r][1]) ); \
+			} \
+		}
+
+
+	// Operations on a SIMD register of double-precision elements,
+	// and the kernels on them, specialized for the SIMD extensions
+	template < typename SimdTag > struct SimdDoubleOps;
+
+#if defined(__SSE2__) || defined(DENSELINALG_SIMD_MULTIVERSION_)
+#ifndef __SSE2__
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+	template <>
+	struct SimdDoubleOps< PTT::SSE2 >
+	{
+		typedef __m128d reg;
+		static const int width = 2;
+		// the rows of the panels multiplied by multiplyPanels
+		static const int panelRows = 4;
+
+		static reg load( const double* p) { return _mm_loadu_pd( p); }
+		static void store( double* p, reg a) { _mm_storeu_pd( p, a); }
+		static reg set1( double a) { return _mm_set1_pd( a); }
+		static reg set( const double* e) { return _mm_set_pd( e[1], e[0]); }
+		static reg gather( const double* x, const int* i) {
+			return _mm_set_pd( x[ i[1] ], x[ i[0] ]);
+		}
+		static reg add( reg a, reg b) { return _mm_add_pd( a, b); }
+		static reg sub( reg a, reg b) { return _mm_sub_pd( a, b); }
+		static reg mul( reg a, reg b) { return _mm_mul_pd( a, b); }
+		static double sum( reg a) {
+			return _mm_cvtsd_f64( _mm_add_sd( a, _mm_unpackhi_pd( a, a) ) );
+		}
+
+		DENSELINALG_SIMD_KERNELS_
+	};
+#ifndef __SSE2__
+#pragma GCC pop_options
+#endif
+#endif
+
+#if defined(__AVX__) || defined(DENSELINALG_SIMD_MULTIVERSION_)
+#ifndef __AVX__
+#pragma GCC push_options
+#pragma GCC target("avx")
+#endif
+	template <>
+	struct SimdDoubleOps< PTT::AVX >
+	{
+		typedef __m256d reg;
+		static const int width = 4;
+		static const int panelRows = 4;
+
+		static reg load( const double* p) { return _mm256_loadu_pd( p); }
+		static void store( double* p, reg a) { _mm256_storeu_pd( p, a); }
+		static reg set1( double a) { return _mm256_set1_pd( a); }
+		static reg set( const double* e) {
+			return _mm256_set_pd( e[3], e[2], e[1], e[0]);
+		}
+		static reg gather( const double* x, const int* i) {
+			return _mm256_set_pd( x[ i[3] ], x[ i[2] ], x[ i[1] ], x[ i[0] ]);
+		}
+		static reg add( reg a, reg b) { return _mm256_add_pd( a, b); }
+		static reg sub( reg a, reg b) { return _mm256_sub_pd( a, b); }
+		static reg mul( reg a, reg b) { return _mm256_mul_pd( a, b); }
+		static double sum( reg a) {
+			const __m128d h = _mm_add_pd(
+				_mm256_castpd256_pd128( a), _mm256_extractf128_pd( a, 1) );
+			return _mm_cvtsd_f64( _mm_add_sd( h, _mm_unpackhi_pd( h, h) ) );
+		}
+
+		DENSELINALG_SIMD_KERNELS_
+	};
+#ifndef __AVX__
+#pragma GCC pop_options
+#endif
+#endif
+
+#if defined(__AVX512F__) || defined(DENSELINALG_SIMD_MULTIVERSION_)
+#ifndef __AVX512F__
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+	template <>
+	struct SimdDoubleOps< PTT::AVX512 >
+	{
+		typedef __m512d reg;
+		static const int width = 8;
+		static const int panelRows = 8;
+
+		static reg load( const double* p) { return _mm512_loadu_pd( p); }
+		static void store( double* p, reg a) { _mm512_storeu_pd( p, a); }
+		static reg set1( double a) { return _mm512_set1_pd( a); }
+		static reg set( const double* e) {
+			return _mm512_set_pd( e[7], e[6], e[5], e[4], e[3], e[2], e[1], e[0]);
+		}
+		static reg gather( const double* x, const int* i) {
+			return _mm512_i32gather_pd( _mm256_loadu_si256(
+				reinterpret_cast< const __m256i* >( i) ), x, 8);
+		}
+		static reg add( reg a, reg b) { return _mm512_add_pd( a, b); }
+		static reg sub( reg a, reg b) { return _mm512_sub_pd( a, b); }
+		static reg mul( reg a, reg b) { return _mm512_mul_pd( a, b); }
+		// The halves are extracted with the zero masking, since
+		// _mm512_reduce_add_pd( ) and the casts read an undefined register.
+		static double sum( reg a) {
+			const __m256d q = _mm256_add_pd(
+				_mm512_maskz_extractf64x4_pd( 0xF, a, 0),
+				_mm512_maskz_extractf64x4_pd( 0xF, a, 1) );
+			const __m128d h = _mm_add_pd(
+				_mm256_castpd256_pd128( q), _mm256_extractf128_pd( q, 1) );
+			return _mm_cvtsd_f64( _mm_add_sd( h, _mm_unpackhi_pd( h, h) ) );
+		}
+
+		DENSELINALG_SIMD_KERNELS_
+	};
+#ifndef __AVX512F__
+#pragma GCC pop_options
+#endif
+#endif
+
+#undef DENSELINALG_SIMD_KERNELS_
+
+
+	// Pack of the double-precision elements in a SIMD register
+	// of the extension SimdTag .
+	// The products and the sums are not fused, so that each element
+	// is computed in the same way as the scalar code.
+	template < typename SimdTag >
+	struct SimdPack
+	{
+		typedef SimdDoubleOps< SimdTag > Ops;
+		typedef double value_type;
+		static const int width = Ops::width;
+
+		typename Ops::reg v;
+
+		SimdPack() {}
+		SimdPack( typename Ops::reg r) : v( r) {}
+		// broadcasting a scalar
+		explicit SimdPack( double a) : v( Ops::set1( a) ) {}
+
+		static SimdPack load( const double* p) { return Ops::load( p); }
+		// making a pack of the elements computed in the registers,
+		// without storing and loading them
+		static SimdPack set( const double* e) { return Ops::set( e); }
+		void store( double* p) const { Ops::store( p, v); }
+
+		// the sum of the elements
+		double sum() const { return Ops::sum( v); }
+
+		SimdPack& operator+=( const SimdPack& b) {
+			v = Ops::add( v, b.v);
+			return *this;
+		}
+		SimdPack& operator-=( const SimdPack& b) {
+			v = Ops::sub( v, b.v);
+			return *this;
+		}
+	};
+
+	template < typename SimdTag >
+	inline SimdPack< SimdTag > operator+(
+		const SimdPack< SimdTag >& a, const SimdPack< SimdTag >& b)
+	{
+		return SimdPack< SimdTag >::Ops::add( a.v, b.v);
+	}
+
+	template < typename SimdTag >
+	inline SimdPack< SimdTag > operator-(
+		const SimdPack< SimdTag >& a, const SimdPack< SimdTag >& b)
+	{
+		return SimdPack< SimdTag >::Ops::sub( a.v, b.v);
+	}
+
+	template < typename SimdTag >
+	inline SimdPack< SimdTag > operator*(
+		const SimdPack< SimdTag >& a, const SimdPack< SimdTag >& b)
+	{
+		return SimdPack< SimdTag >::Ops::mul( a.v, b.v);
+	}
+
+
+	// The pack of the elements of the type Scalar for the SIMD extension
+	// SimdTag is chosen by the overload resolution on these declarations,
+	// falling back to the narrower extensions through the hierarchy
+	// of the tags, and to void , i.e. the scalar code, at last.
+	template < typename Scalar >
+	void simdPackOf( const Scalar*, const PTT::NoSIMD& );
+#ifdef __SSE2__
+	SimdPack< PTT::SSE2 > simdPackOf( const double*, const PTT::SSE2& );
+#endif
+#ifdef __AVX__
+	SimdPack< PTT::AVX > simdPackOf( const double*, const PTT::AVX& );
+#endif
+#ifdef __AVX512F__
+	SimdPack< PTT::AVX512 > simdPackOf( const double*, const PTT::AVX512& );
+#endif
+
+	template < typename Scalar, typename SimdTag >
+	struct SimdPackOf
+	{
+		typedef decltype( simdPackOf(
+			static_cast< const Scalar* >( nullptr), SimdTag() ) ) type;
+	};
+
+	// The kernels for the SIMD extension SimdTag are chosen
+	// in the same way, among those compiled for this binary.
+	// Unlike the packs, they may be of the extensions not enabled
+	// for the compiler, which must be checked at run time
+	// before the tag is specified.
+	template < typename Scalar >
+	void simdOpsOf( const Scalar*, const PTT::NoSIMD& );
+#if defined(__SSE2__) || defined(DENSELINALG_SIMD_MULTIVERSION_)
+	SimdDoubleOps< PTT::SSE2 > simdOpsOf( const double*, const PTT::SSE2& );
+#endif
+#if defined(__AVX__) || defined(DENSELINALG_SIMD_MULTIVERSION_)
+	SimdDoubleOps< PTT::AVX > simdOpsOf( const double*, const PTT::AVX& );
+#endif
+#if defined(__AVX512F__) || defined(DENSELINALG_SIMD_MULTIVERSION_)
+	SimdDoubleOps< PTT::AVX512 > simdOpsOf( const double*,
+											const PTT::AVX512& );
+#endif
+
+	template < typename Scalar, typename SimdTag >
+	struct SimdOpsOf
+	{
+		typedef decltype( simdOpsOf(
+			static_cast< const Scalar* >( nullptr), SimdTag() ) ) type;
+	};
+
+	// the number of the elements of the blocks, into which
+	// the vectors are divided among the threads
+	const int SimdBlockSize = 4096;
+
+
+	// the dot product of the elements from first to last of x and y
+	template < typename Scalar >
+	Scalar simdDot( const Scalar* x, const Scalar* y, int first, int last,
+					void* )
+	{
+		Scalar d = 0.0;
+		for (int i = first; i < last; i++) d += x[i] * y[i];
+		return d;
+	}
+
+	template < typename SimdTag >
+	double simdDot( const double* x, const double* y, int first, int last,
+					SimdDoubleOps< SimdTag >* )
+	{
+		return SimdDoubleOps< SimdTag >::dot( x, y, first, last);
+	}
+
+	// assigning the elements from first to last of rhs into lhs
+	// by the function object AssignType
+	template < typename AssignType, typename Scalar >
+	void simdAssign( Scalar* lhs, const Scalar* rhs, int first, int last,
+					void* )
+	{
+		for (int i = first; i < last; i++) AssignType()( lhs[i], rhs[i]);
+	}
+
+	template < typename AssignType, typename SimdTag >
+	void simdAssign( double* lhs, const double* rhs, int first, int last,
+					SimdDoubleOps< SimdTag >* )
+	{
+		SimdDoubleOps< SimdTag >::template assign< AssignType >(
+												lhs, rhs, first, last);
+	}
+
+	// multiplying the elements from first to last of a and b into lhs
+	template < typename Scalar >
+	void simdMultiply( Scalar* lhs, const Scalar* a, const Scalar* b,
+					int first, int last, void* )
+	{
+		for (int i = first; i < last; i++) lhs[i] = a[i] * b[i];
+	}
+
+	template < typename SimdTag >
+	void simdMultiply( double* lhs, const double* a, const double* b,
+					int first, int last, SimdDoubleOps< SimdTag >* )
+	{
+		SimdDoubleOps< SimdTag >::multiply( lhs, a, b, first, last);
+	}
+
+
+	// The grammar for the vector expressions evaluated a pack at a time,
+	// whose vectors and diagonal matrices are of double precision,
+	// and whose scalars are not of long double.
+	// The elements of the other operands, like matrices, are
+	// promoted to double precision in the evaluation anyway.
+	struct PackableVecExprGrammar : proto::or_<
+		proto::terminal< BasicVector< double > >,
+		proto::terminal< TempVector< double > >,
+		proto::terminal< BasicDiagonalMatrix< double > >,
+		proto::and_<
+			proto::terminal< proto::_ >,
+			proto::not_< proto::or_<
+				proto::terminal< BasicVector< proto::_ > >,
+				proto::terminal< TempVector< proto::_ > >,
+				proto::terminal< BasicDiagonalMatrix< proto::_ > >,
+				proto::terminal< long double >
+			> >
+		>,
+		proto::nary_expr< proto::_, proto::vararg< PackableVecExprGrammar > >
+	> {};
+
+	// the pack of the elements of the expression of the type Expr
+	// assigned into the vector of the elements of the type Scalar
+	// for the SIMD extension SimdTag , void if it is not packable
+	template < typename Expr, typename Scalar, typename SimdTag >
+	struct VecExprPackOf : std::conditional<
+		proto::matches< Expr, PackableVecExprGrammar >::value,
+		typename SimdPackOf< Scalar, SimdTag >::type,
+		void
+	> {};
+
+
+	// Callable transform objects making a pack of the elements
+	// from the index of a vector, a view or a diagonal matrix,
+	// of a scalar broadcasted,
+	// and of a subexpression evaluated element by element
+	template < typename Pack >
+	struct PackLoad : proto::callable
+	{
+		typedef Pack result_type;
+
+		template < typename VecType >
+		Pack operator()( const VecType& v, int index) const
+		{
+			return load( v, index, (VecType*)nullptr );
+		}
+
+	private:
+		template < typename VecType >
+		static Pack load( const VecType& v, int index, void* )
+		{
+			return Pack::load( &v( index) );
+		}
+
+		// The elements of a view are gathered unless they are contiguous.
+		template < typename VecType >
+		static Pack load( const VecType& v, int index, VectorView* )
+		{
+			if ( v.contiguous() ) return Pack::load( &v( index) );
+			double elms[ Pack::width ];
+			for (int k = 0; k < Pack::width; k++) elms[k] = v( index + k);
+			return Pack::set( elms);
+		}
+	};
+
+	template < typename Pack >
+	struct PackBroadcast : proto::callable
+	{
+		typedef Pack result_type;
+
+		template < typename Scalar >
+		Pack operator()( Scalar a) const { return Pack( double( a) ); }
+	};
+
+	template < typename Pack >
+	struct PackGather : proto::callable
+	{
+		typedef Pack result_type;
+
+		template < typename Expr >
+		Pack operator()( const Expr& expr, int index) const
+		{
+			double elms[ Pack::width ];
+			for (int k = 0; k < Pack::width; k++)
+				elms[k] = VecExprGrammar()( expr( index + k) );
+			return Pack::set( elms);
+		}
+	};
+
+	// The transformation rule evaluating a pack of the elements
+	// of a vector expression, accepting the index of the first element
+	// as the state variable.
+	// The vectors and the diagonal matrices are loaded,
+	// and the scalars are broadcasted.
+	// The other subexpressions, like the products of matrices and vectors
+	// and the terminals made by VecLazyGrammar , are evaluated
+	// element by element and gathered.
+	template < typename Pack >
+	struct VecPackGrammar : proto::or_<
+		proto::when< ScalarTermGrammar,
+					proto::call< PackBroadcast< Pack >( proto::_value) > >,
+
+		proto::when<
+			proto::or_<
+				proto::terminal< BasicVector< double > >,
+				proto::terminal< VectorView >,
+				proto::terminal< TempVector< double > >,
+				proto::terminal< BasicDiagonalMatrix< double > >
+			>,
+			proto::call< PackLoad< Pack >( proto::_value, proto::_state) >
+		>,
+
+		// VecPackGrammar +(-) VecPackGrammar
+		proto::when<
+			proto::or_<
+				proto::plus< VecPackGrammar< Pack >, VecPackGrammar< Pack > >,
+				proto::minus< VecPackGrammar< Pack >, VecPackGrammar< Pack > >
+			>,
+			proto::_default< VecPackGrammar< Pack > >
+		>,
+
+		// Scalar * VecPackGrammar , DiagonalMatrix * VecPackGrammar ,
+		// VecPackGrammar * Scalar
+		proto::when<
+			proto::or_<
+				proto::multiplies<
+					proto::or_< ScalarTermGrammar, DiagMatTermGrammar >,
+					VecPackGrammar< Pack >
+				>,
+				proto::multiplies< VecPackGrammar< Pack >, ScalarTermGrammar >
+			>,
+			proto::_default< VecPackGrammar< Pack > >
+		>,
+
+		proto::when< proto::_,
+			proto::call< PackGather< Pack >( proto::_, proto::_state) > >
+	> {};
+
+}
+
+
+#endif /* DENSELINALG_SIMD_HPP_ */
@@ -0,0 +1,239 @@
+/*
+ * TiledMatVec.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef DENSELINALG_TILEDMATVEC_HPP_
+#define DENSELINALG_TILEDMATVEC_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <boost/proto/proto.hpp>
+#include <boost/type_traits/remove_const.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+
+#include <DenseLinAlg/MatrixVector.hpp>
+#include <DenseLinAlg/LazyEvaluator.hpp>
+
+
+namespace DenseLinAlg {
+
+	namespace proto = boost::proto;
+
+
+	// Tile sizes of the matrix vector multiplication.
+	// A strip of rows is multiplied by a tile of columns of the vector
+	// at a time, so that the tile is reused by all the rows of the strip
+	// while it is in the cache.
+	struct MatVecTile
+	{
+		int rows, columns;
+	};
+
+	// Multiplying the rowSz rows of m from first by v into y ,
+	// columnSz columns at a time.
+	// Four rows are accumulated in the registers together, and
+	// each row is summed in the order of the columns like LazyMatVecMult .
+	template < typename MatType, typename VecType, typename Scalar >
+	void multiplyStrip( const MatType& m, const VecType& v,
+						int first, int rowSz, int columnSz, Scalar* y)
+	{
+		const int mColSz = m.columnSize();
+		for (int r = 0; r < rowSz; r++) y[r] = 0.0;
+
+		for (int cBegin = 0; cBegin < mColSz; cBegin += columnSz) {
+			const int cEnd = std::min( cBegin + columnSz, mColSz);
+			int r = 0;
+			for (; r + 4 <= rowSz; r += 4) {
+				const int ri = first + r;
+				Scalar acc0 = y[r], acc1 = y[r + 1],
+						acc2 = y[r + 2], acc3 = y[r + 3];
+				for (int ci = cBegin; ci < cEnd; ci++) {
+					const typename VecType::value_type vc = v(ci);
+					acc0 += m(ri, ci) * vc;
+					acc1 += m(ri + 1, ci) * vc;
+					acc2 += m(ri + 2, ci) * vc;
+					acc3 += m(ri + 3, ci) * vc;
+				}
+				y[r] = acc0;
+				y[r + 1] = acc1;
+				y[r + 2] = acc2;
+				y[r + 3] = acc3;
+			}
+			for (; r < rowSz; r++) {
+				const int ri = first + r;
+				Scalar acc = y[r];
+				for (int ci = cBegin; ci < cEnd; ci++)
+					acc += m(ri, ci) * v(ci);
+				y[r] = acc;
+			}
+		}
+	}
+
+	// Autotuner of the tile sizes, which times the candidates
+	// on the first matrix of every size class and keeps
+	// the fastest one for the class.
+	// The column sizes rounded up to a power of two are the classes,
+	// and the sizes are tuned for each type of the matrices and vectors.
+	template < typename MatType, typename VecType >
+	struct MatVecTileTuner
+	{
+		typedef typename PromotedScalar< typename MatType::value_type,
+				typename VecType::value_type >::type result_type;
+
+		static const int rowCandidates[], columnCandidates[];
+		static const int numRowCandidates = 3, numColumnCandidates = 4;
+
+		// the rows multiplied for timing a candidate
+		static const int sampleRows = 64;
+
+		static const int numSizeClasses = 32;
+
+		// The tiles are tuned once for a class,
+		// and read without locking afterwards.
+		static MatVecTile tile( const MatType& m, const VecType& v)
+		{
+			static std::once_flag tuned[ numSizeClasses ];
+			static MatVecTile tiles[ numSizeClasses ];
+
+			const int sizeClass = columnSizeClass( m.columnSize() );
+			std::call_once( tuned[ sizeClass],
+				[&m, &v, sizeClass]() { tiles[ sizeClass] = tune( m, v); } );
+			return tiles[ sizeClass];
+		}
+
+	private:
+		static int columnSizeClass( int columnSz)
+		{
+			int sizeClass = 0;
+			while ( sizeClass + 1 < numSizeClasses &&
+					( 1 << sizeClass ) < columnSz ) sizeClass++;
+			return sizeClass;
+		}
+
+		static MatVecTile tune( const MatType& m, const VecType& v)
+		{
+			const int mColSz = m.columnSize();
+			// The vector of a few columns is kept in the cache anyway.
+			MatVecTile best = { rowCandidates[0], mColSz };
+			if ( mColSz <= columnCandidates[0] ) return best;
+
+			BasicVector< result_type > y(
+									std::min( int( sampleRows), m.rowSize() ) );
+			double bestTime = 0.0;
+			for (int r = 0; r < numRowCandidates; r++)
+				for (int c = 0; c <= numColumnCandidates; c++) {
+					const MatVecTile candidate = { rowCandidates[r],
+						c < numColumnCandidates ?
+							std::min( columnCandidates[c], mColSz) : mColSz };
+					const double time = std::min( measure( m, v, candidate, y),
+											measure( m, v, candidate, y) );
+					if ( bestTime == 0.0 || time < bestTime ) {
+						bestTime = time;
+						best = candidate;
+					}
+				}
+			return best;
+		}
+
+		static double measure( const MatType& m, const VecType& v,
+						const MatVecTile& t, BasicVector< result_type >& y)
+		{
+			const auto begin = std::chrono::steady_clock::now();
+			for (int first = 0; first < y.size(); first += t.rows)
+				multiplyStrip( m, v, first,
+					std::min( t.rows, y.size() - first), t.columns, &y( first) );
+			return std::chrono::duration< double >(
+						std::chrono::steady_clock::now() - begin ).count();
+		}
+	};
+
+	template < typename MatType, typename VecType >
+	const int MatVecTileTuner< MatType, VecType >::rowCandidates[] =
+		{ 16, 64, 256 };
+
+	template < typename MatType, typename VecType >
+	const int MatVecTileTuner< MatType, VecType >::columnCandidates[] =
+		{ 512, 1024, 2048, 4096 };
+
+
+	// Lazy function object for evaluating an element of
+	// the resultant vector from the multiplication of
+	// a matrix and a vector, a strip of rows at a time.
+	//
+	// The whole strip containing the requested element is computed
+	// tile by tile of the columns by multiplyStrip() , and kept
+	// until an element of another strip is requested.
+	// Every thread should make its own object.
+	template < typename MatType, typename VecType >
+	struct LazyTiledMatVecMult
+	{
+		MatType const& m;
+		VecType const& v;
+
+		typedef typename PromotedScalar< typename MatType::value_type,
+				typename VecType::value_type >::type result_type;
+
+		MatVecTile t;
+		// the first row of the cached strip
+		mutable int cachedBegin;
+		mutable BasicVector< result_type > stripCache;
+
+		explicit LazyTiledMatVecMult(MatType const& mat, VecType const& vec) :
+			m( mat), v( vec),
+			t( MatVecTileTuner< MatType, VecType >::tile( mat, vec) ),
+			cachedBegin( - t.rows), stripCache( t.rows) {}
+
+		LazyTiledMatVecMult( LazyTiledMatVecMult const& lazy) :
+			m( lazy.m), v( lazy.v), t( lazy.t),
+			cachedBegin( - lazy.t.rows), stripCache( lazy.t.rows) {}
+
+		result_type operator()(int index) const
+		{
+			if ( index < cachedBegin || index >= cachedBegin + t.rows ) {
+				cachedBegin = index - index % t.rows;
+				multiplyStrip( m, v, cachedBegin,
+					std::min( t.rows, m.rowSize() - cachedBegin),
+					t.columns, &stripCache(0) );
+			}
+			return stripCache( index - cachedBegin);
+		}
+	};
+
+
+	// Callable transform object to make the lazy functor
+	// a proto exression for evaluationg the multiplication
+	// of a matrix and a vector a strip of rows at a time
+	struct TiledMatVecMult : proto::callable
+	{
+		template < typename Sig > struct result;
+
+		template < typename This, typename MatType, typename VecType >
+		struct result< This( MatType, VecType) >
+		{
+			typedef typename proto::terminal< LazyTiledMatVecMult<
+				typename boost::remove_const<
+					typename boost::remove_reference< MatType >::type
+				>::type,
+				typename boost::remove_const<
+					typename boost::remove_reference< VecType >::type
+				>::type
+			> >::type type;
+		};
+
+		template < typename MatType, typename VecType >
+		typename proto::terminal< LazyTiledMatVecMult< MatType, VecType > >::type
+		operator()( MatType const& mat, VecType const& vec) const
+		{
+			return proto::as_expr(
+					LazyTiledMatVecMult< MatType, VecType >(mat, vec) );
+		}
+	};
+
+}
+
+
+#endif /* DENSELINALG_TILEDMATVEC_HPP_ */
@@ -0,0 +1,376 @@
+/*
+ * Transpose.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef DENSELINALG_TRANSPOSE_HPP_
+#define DENSELINALG_TRANSPOSE_HPP_
+
+#include <type_traits>
+#include <vector>
+#include <boost/proto/proto.hpp>
+#include <boost/type_traits/remove_const.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <DenseLinAlg/MatrixVector.hpp>
+#include <DenseLinAlg/LazyEvaluator.hpp>
+
+
+namespace DenseLinAlg {
+
+	namespace proto = boost::proto;
+
+
+	template < typename MatType > struct MultiplyTransposed;
+
+	// Transpose of a matrix of any type, referring to the matrix.
+	// The product of the transpose and a vector, like trans( A ) * x ,
+	// is evaluated by scattering the rows of the matrix,
+	// without making the transpose.
+	template < typename MatType >
+	class TransposedMatrix
+	{
+		// The rows of a distributed matrix would be scattered
+		// only into the columns of its diagonal block.
+		static_assert(
+			! std::is_same< MatType, SparseLinAlg::DistCsrMatrix >::value,
+			"The transpose of DistCsrMatrix is not supported, "
+			"since the products with its off-diagonal block would be lost." );
+
+	public:
+		typedef MatType matrix_type;
+		typedef typename MatType::value_type value_type;
+
+	private:
+		MatType const& m;
+
+		// the product with the vector multiplied by multiply()
+		mutable BasicVector< value_type > product;
+		mutable const void* multiplied;
+
+	public:
+		explicit TransposedMatrix( MatType const& mat) :
+			m( mat), product( 0), multiplied( nullptr) {}
+
+		TransposedMatrix( const TransposedMatrix& transposed) :
+			m( transposed.m), product( 0), multiplied( nullptr) {}
+
+		int rowSize() const { return m.columnSize(); }
+		int columnSize() const { return m.rowSize(); }
+
+		value_type operator()(int ri, int ci) const { return m( ci, ri); }
+
+		const MatType& matrix() const { return m; }
+
+		// Multiplying the transpose and x into the product kept,
+		// before the elements of an expression are evaluated by the threads
+		template < typename VecType, typename ParallelizationType >
+		void multiply( const VecType& x, const ParallelizationType& pt) const
+		{
+			multiplied = nullptr;
+			if ( m.columnSize() == 0 ) return;
+			if ( product.size() != m.columnSize() )
+				BasicVector< value_type >( m.columnSize() ).swap( product);
+			MultiplyTransposed< MatType >()( m, x, &product(0), pt);
+			multiplied = &x;
+		}
+
+		// the product with x kept by multiply() , or nullptr
+		template < typename VecType >
+		const value_type* productWith( const VecType& x) const {
+			return multiplied == &x ? &product(0) : nullptr;
+		}
+	};
+
+	// the transpose of a matrix in a linear algebraic expression
+	template < typename MatType >
+	typename proto::result_of::make_expr< proto::tag::terminal, Domain,
+										TransposedMatrix< MatType > >::type
+	trans( const MatType& mat)
+	{
+		return proto::make_expr< proto::tag::terminal, Domain >(
+									TransposedMatrix< MatType >( mat) );
+	}
+
+
+	// Kernel adding the contributions of the rows of a matrix
+	// to the product of its transpose and a vector x .
+	// The rows are grouped into blocks, and those of the blocks
+	// from first to last are scattered into y , an array of
+	// the column size of the matrix.
+	// A block of a dense matrix is a row, and the sparse matrices
+	// specialize this for their formats.
+	template < typename MatType >
+	struct TransposedMatVecKernel
+	{
+		static int blocks( const MatType& m) { return m.rowSize(); }
+
+		template < typename VecType, typename Scalar >
+		static void add( const MatType& m, int first, int last,
+						const VecType& x, Scalar* y)
+		{
+			const int colSz = m.columnSize();
+			for (int ri = first; ri < last; ri++) {
+				const typename VecType::value_type xr = x( ri);
+				for (int ci = 0; ci < colSz; ci++)
+					y[ci] += m( ri, ci) * xr;
+			}
+		}
+	};
+
+
+	// Function object multiplying the transpose of a matrix
+	// and a vector x into y , an array of the column size of the matrix
+	template < typename MatType >
+	struct MultiplyTransposed
+	{
+		typedef TransposedMatVecKernel< MatType > Kernel;
+
+		template < typename VecType, typename Scalar, typename SimdTag >
+		void operator()( const MatType& m, const VecType& x, Scalar* y,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >& )
+		const
+		{
+			const int sz = m.columnSize();
+			for (int i = 0; i < sz; i++) y[i] = 0.0;
+			Kernel::add( m, 0, Kernel::blocks( m), x, y);
+		}
+
+		// Every thread scatters its share of the blocks into
+		// its own partial sums, those of the first thread being y itself,
+		// and the partial sums are added up column by column.
+		template < typename VecType, typename Scalar, typename SimdTag >
+		void operator()( const MatType& m, const VecType& x, Scalar* y,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >& )
+		const
+		{
+			const int sz = m.columnSize(), blocks = Kernel::blocks( m);
+			std::vector< Scalar* > partials;
+
+			#pragma omp parallel shared( partials)
+			{
+#ifdef _OPENMP
+				const int numThreads = omp_get_num_threads(),
+						t = omp_get_thread_num();
+#else
+				const int numThreads = 1, t = 0;
+#endif
+				#pragma omp single
+				partials.assign( numThreads, y);
+
+				if ( t > 0 )
+					partials[t] = static_cast< Scalar* >(
+						ScratchPool::local().acquire( sz * sizeof( Scalar) ) );
+				Scalar* const partial = partials[t];
+				for (int i = 0; i < sz; i++) partial[i] = 0.0;
+				Kernel::add( m, int( long( blocks) * t / numThreads ),
+							int( long( blocks) * ( t + 1 ) / numThreads ),
+							x, partial);
+				#pragma omp barrier
+
+				#pragma omp for
+				for (int i = 0; i < sz; i++)
+					for (int p = 1; p < numThreads; p++)
+						y[i] += partials[p][i];
+
+				if ( t > 0 ) ScratchPool::local().release( partial);
+			}
+		}
+
+		// A task per thread of the pool scatters its share of the blocks,
+		// and the partial sums are added up by the chunks of the columns.
+		template < typename VecType, typename Scalar, typename SimdTag >
+		void operator()( const MatType& m, const VecType& x, Scalar* y,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >& )
+		const
+		{
+			PTT::WorkStealingPool& pool = PTT::WorkStealingPool::local();
+			const int sz = m.columnSize(), blocks = Kernel::blocks( m),
+					numTasks = pool.numThreads();
+			ScratchVector< Scalar > others( sz * ( numTasks - 1 ) );
+			Scalar* const o = numTasks > 1 ? &others(0) : nullptr;
+
+			pool.parallelFor( 0, numTasks, 1,
+				[&m, &x, y, o, sz, blocks, numTasks]( int first, int last) {
+					for (int t = first; t < last; t++) {
+						Scalar* const partial = t > 0 ? o + ( t - 1 ) * sz : y;
+						for (int i = 0; i < sz; i++) partial[i] = 0.0;
+						Kernel::add( m, int( long( blocks) * t / numTasks ),
+									int( long( blocks) * ( t + 1 ) / numTasks ),
+									x, partial);
+					}
+				} );
+
+			pool.parallelForBlocks( sz, SimdBlockSize,
+				[y, o, sz, numTasks]( int first, int last) {
+					for (int i = first; i < last; i++)
+						for (int p = 1; p < numTasks; p++)
+							y[i] += o[ ( p - 1 ) * sz + i];
+				} );
+		}
+	};
+
+
+	// Callable transform object multiplying the transpose of a matrix and
+	// a vector into the product kept by the transpose, by the threads
+	// given as the data. The state is returned as it is.
+	struct ComputeTransProduct : proto::callable
+	{
+		typedef int result_type;
+
+		template < typename MatType, typename VecType,
+					typename ParallelizationType >
+		int operator()( const TransposedMatrix< MatType >& transposed,
+			const VecType& x, int state, const ParallelizationType& pt) const
+		{
+			transposed.multiply( x, pt);
+			return state;
+		}
+	};
+
+
+	// Function object for assigning the product of the transpose of
+	// a matrix and a vector into the left hand side.
+	//
+	// The product is scattered directly into the left hand side,
+	// unless the left hand side is added to or subtracted from,
+	// is of another scalar type, or is the vector multiplied.
+	// Otherwise it is scattered into a scratch vector first.
+	template < typename AssignType >
+	struct AssignTransMatVecMult
+	{
+		template < typename Expr, typename LhsType,
+					typename ParallelizationType >
+		void operator()( const Expr& expr, LhsType& lhs,
+						const ParallelizationType& pt) const
+		{
+			const auto& transposed = proto::value( proto::left( expr) );
+			const auto& x = proto::value( proto::right( expr) );
+			typedef typename std::decay< decltype( transposed) >::type
+								::matrix_type mat_type;
+			typedef typename PromotedScalar< typename mat_type::value_type,
+				typename std::decay< decltype( x) >::type::value_type
+			>::type Scalar;
+
+			if ( lhs.size() == 0 ) return;
+			assign( transposed.matrix(), x, lhs, pt,
+				std::integral_constant< bool,
+					std::is_same< AssignType, AssignFunctor >::value &&
+					std::is_same< typename LhsType::value_type, Scalar >::value
+				>() );
+		}
+
+	private:
+		template < typename MatType, typename VecType, typename LhsType,
+					typename ParallelizationType >
+		static void assign( const MatType& m, const VecType& x, LhsType& lhs,
+			const ParallelizationType& pt, std::true_type )
+		{
+			if ( Overlaps()( x, lhs) ) {
+				assign( m, x, lhs, pt, std::false_type() );
+				return;
+			}
+			MultiplyTransposed< MatType >()( m, x, &lhs(0), pt);
+		}
+
+		template < typename MatType, typename VecType, typename LhsType,
+					typename ParallelizationType >
+		static void assign( const MatType& m, const VecType& x, LhsType& lhs,
+			const ParallelizationType& pt, std::false_type )
+		{
+			ScratchVector< typename PromotedScalar<
+				typename MatType::value_type, typename VecType::value_type
+			>::type > scratch( lhs.size() );
+			MultiplyTransposed< MatType >()( m, x, &scratch(0), pt);
+			AssignVecExpr< AssignType >::copyScratch( scratch, lhs, pt);
+		}
+	};
+
+
+	// Lazy function object for evaluating an element of the product of
+	// the transpose of a matrix and a vector, within an expression
+	// evaluated element by element, like dot( trans( A ) * x, y ) .
+	//
+	// The elements are read from the product computed by the transpose
+	// before the expression is evaluated, by TransProductGrammar
+	// in the reductions.
+	// Otherwise the whole product is scattered when the first element
+	// is requested, and kept.
+	template < typename MatType, typename VecType >
+	struct LazyTransMatVecMult
+	{
+		MatType const& m;
+		VecType const& v;
+
+		typedef typename PromotedScalar< typename MatType::value_type,
+				typename VecType::value_type >::type result_type;
+
+		// the product computed by the transpose, or nullptr
+		const typename MatType::value_type* const product;
+
+		mutable bool computed;
+		mutable BasicVector< result_type > cache;
+
+		explicit LazyTransMatVecMult( TransposedMatrix< MatType > const& t,
+									VecType const& vec) :
+			m( t.matrix()), v( vec), product( t.productWith( vec) ),
+			computed( false), cache( 0) {}
+
+		LazyTransMatVecMult( LazyTransMatVecMult const& lazy) :
+			m( lazy.m), v( lazy.v), product( lazy.product),
+			computed( false), cache( 0) {}
+
+		result_type operator()(int index) const
+		{
+			if ( product != nullptr ) return product[ index];
+			if ( ! computed ) {
+				BasicVector< result_type >( m.columnSize() ).swap( cache);
+				MultiplyTransposed< MatType >()( m, v, &cache(0),
+					PTT::SingleProcess< PTT::SingleThread< PTT::NoSIMD > >() );
+				computed = true;
+			}
+			return cache( index);
+		}
+	};
+
+
+	// Callable transform object to make the lazy functor
+	// a proto exression for evaluationg the multiplication
+	// of the transpose of a matrix and a vector
+	struct TransMatVecMult : proto::callable
+	{
+		template < typename Sig > struct result;
+
+		template < typename This, typename TransType, typename VecType >
+		struct result< This( TransType, VecType) >
+		{
+			typedef typename proto::terminal< LazyTransMatVecMult<
+				typename boost::remove_const<
+					typename boost::remove_reference< TransType >::type
+				>::type::matrix_type,
+				typename boost::remove_const<
+					typename boost::remove_reference< VecType >::type
+				>::type
+			> >::type type;
+		};
+
+		template < typename MatType, typename VecType >
+		typename proto::terminal< LazyTransMatVecMult< MatType, VecType > >::type
+		operator()( TransposedMatrix< MatType > const& transposed,
+					VecType const& vec) const
+		{
+			return proto::as_expr(
+					LazyTransMatVecMult< MatType, VecType >( transposed, vec) );
+		}
+	};
+
+}
+
+
+#endif /* DENSELINALG_TRANSPOSE_HPP_ */
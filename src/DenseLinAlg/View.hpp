@@ -0,0 +1,245 @@
+/*
+ * View.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef DENSELINALG_VIEW_HPP_
+#define DENSELINALG_VIEW_HPP_
+
+#include <math.h>
+
+#include <algorithm>
+#include <boost/proto/proto.hpp>
+
+#include <ParallelizationTypeTag/Default.hpp>
+
+#include <DenseLinAlg/Grammar.hpp>
+#include <DenseLinAlg/MatrixVector.hpp>
+
+
+namespace DenseLinAlg {
+
+	namespace proto = boost::proto;
+
+	namespace PTT = ParallelizationTypeTag;
+
+
+	// Vector wrapping an external array without copying it.
+	//
+	// The i'th element is data[ i * stride ].
+	// Copying a view makes another view of the same array,
+	// while assigning to a view writes into the array.
+	class VectorView {
+	private:
+		double* data;
+		int sz, stride;
+
+		template < typename VecType, typename SimdTag >
+		double _dot( const VecType& vec,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >&)
+		const
+		{
+			double d = 0.0;
+			for (int i = 0; i < sz; i++) d += data[i * stride] * vec(i);
+			return d;
+		}
+
+		template < typename VecType, typename SimdTag >
+		double _dot( const VecType& vec,
+				const PTT::SingleProcess< PTT::OpenMP< SimdTag > >&)
+		const
+		{
+			double d = 0.0;
+			#pragma omp parallel for reduction (+:d)
+			for (int i = 0; i < sz; i++) d += data[i * stride] * vec(i);
+			return d;
+		}
+
+		template < typename VecType, typename SimdTag >
+		double _dot( const VecType& vec,
+				const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >&)
+		const
+		{
+			const double* const d = data;
+			const int s = stride;
+			return PTT::WorkStealingPool::local().reduceBlocks(
+				sz, SimdBlockSize, 0.0,
+				[&vec, d, s]( int first, int last, double* partials) {
+					for (int b = first; b < last; b += SimdBlockSize) {
+						const int end = std::min( b + SimdBlockSize, last);
+						double acc = 0.0;
+						for (int i = b; i < end; i++) acc += d[i * s] * vec(i);
+						*partials++ = acc;
+					}
+				},
+				[]( double& acc, double partial) { acc += partial; } );
+		}
+
+		// The kernel is selected at run time.
+		struct DotCall {
+			const VectorView& self;
+
+			template < typename VecType, typename ParallelizationType >
+			double operator()( const VecType& vec,
+							const ParallelizationType& pt) const {
+				return self._dot( vec, pt);
+			}
+		};
+
+		template < typename VecType >
+		double _dot( const VecType& vec,
+					const PTT::SingleProcess< PTT::Runtime >&) const {
+			return PTT::dispatch( DotCall{ *this }, vec);
+		}
+
+		// The dot products of the rows of the processes are summed.
+		template < typename VecType, typename Multithreading >
+		double _dot( const VecType& vec,
+					const PTT::MPI< Multithreading >& pt) const {
+			return allreduceSum(
+				_dot( vec, PTT::SingleProcess< Multithreading >() ), pt);
+		}
+
+	public:
+		typedef double value_type;
+
+		template <typename Sig> struct result;
+
+		template <typename This, typename T>
+		struct result< This(T) > { typedef double type; };
+
+		explicit VectorView( double* externalData, int size,
+							int stride_ = 1) :
+			data( externalData), sz( size), stride( stride_) {}
+
+		// Viewing the buffer of a vector
+		explicit VectorView( Vector& vec) :
+			data( &vec(0)), sz( vec.size()), stride( 1) {}
+
+		VectorView( const VectorView& view) :
+			data( view.data), sz( view.sz), stride( view.stride) {}
+
+		int size() const { return sz; }
+		int rowSize() const { return 1; }
+		int columnSize() const { return sz; }
+
+		// whether the elements are adjacent in the array
+		bool contiguous() const { return stride == 1; }
+
+		template < typename VecType >
+		double dot( const VecType& vec) const
+		{
+			return _dot(vec, PTT::Specified());
+		}
+
+		double abs() const {
+			return sqrt( _dot( *this, PTT::Specified()) );
+		}
+
+		// accessing to an element of the external array
+		double& operator()(int i) { return data[i * stride]; }
+		const double& operator()(int i) const { return data[i * stride]; }
+
+		VectorView& operator=( const VectorView& rhs ) {
+			for (int i = 0; i < sz; i++) data[i * stride] = rhs(i);
+			return *this;
+		}
+
+		VectorView& operator=( const Vector& rhs ) {
+			for (int i = 0; i < sz; i++) data[i * stride] = rhs(i);
+			return *this;
+		}
+
+		// assigning the lhs of a vector expression into the external array
+		template < typename Expr >
+		VectorView& operator=( const ExprWrapper< Expr >& expr ) {
+			AssignVecExpr< AssignFunctor >()(
+					expr, VecExprTagGrammar()( expr),
+					*this, PTT::Specified()
+			);
+			return *this;
+		}
+
+		template <typename Expr>
+		VectorView& operator+=( const ExprWrapper< Expr >& expr ) {
+			AssignVecExpr< PlusAssignFunctor >()(
+					expr, VecExprTagGrammar()( expr),
+					*this, PTT::Specified()
+			);
+			return *this;
+		}
+
+		template <typename Expr>
+		VectorView& operator-=( const ExprWrapper< Expr >&expr ) {
+			AssignVecExpr< MinusAssignFunctor >()(
+					expr, VecExprTagGrammar()( expr),
+					*this, PTT::Specified()
+			);
+			return *this;
+		}
+	};
+
+
+	// Row-major matrix wrapping an external array without copying it.
+	//
+	// The element (ri, ci) is data[ ri * ld + ci ] .
+	class MatrixView
+	{
+	private:
+		double* data;
+		int rowSz, colSz, ld;
+
+	public:
+		typedef double value_type;
+
+		template <typename Sig> struct result;
+
+		template <typename This, typename T>
+		struct result< This(T,T) > { typedef double type; };
+
+		explicit MatrixView( double* externalData,
+							int rowSize, int columnSize) :
+			data( externalData), rowSz( rowSize), colSz( columnSize),
+			ld( columnSize) {}
+
+		explicit MatrixView( double* externalData,
+							int rowSize, int columnSize,
+							int leadingDimension) :
+			data( externalData), rowSz( rowSize), colSz( columnSize),
+			ld( leadingDimension) {}
+
+		// Viewing the buffer of a row-major matrix
+		explicit MatrixView( Matrix& mat) :
+			data( &mat(0, 0)), rowSz( mat.rowSize()),
+			colSz( mat.columnSize()), ld( mat.leadingDimension()) {}
+
+		MatrixView( const MatrixView& view) :
+			data( view.data), rowSz( view.rowSz), colSz( view.colSz),
+			ld( view.ld) {}
+
+		int rowSize() const { return rowSz; }
+		int columnSize() const { return colSz; }
+		int leadingDimension() const { return ld; }
+
+		// accesing to an element of the external array
+		double& operator()(int ri, int ci) { return data[ ri * ld + ci]; }
+		const double& operator()(int ri, int ci) const {
+			return data[ ri * ld + ci];
+		}
+
+		// assigning the lhs of a matrix expression into the external array
+		template<typename Expr>
+		MatrixView& operator=( const ExprWrapper< Expr >& expr ) {
+			for(int ri=0; ri < rowSz; ri++)
+				for (int ci=0; ci < colSz; ci++ )
+					data[ ri * ld + ci] = MatExprGrammar()( expr(ri, ci) );
+			return *this;
+		}
+	};
+
+}
+
+
+#endif /* DENSELINALG_VIEW_HPP_ */
@@ -11,6 +11,7 @@
 #include <math.h>
 
 #include <iostream>
+#include <stdexcept>
 
 #include <DenseLinAlg/DenseLinAlg.hpp>
 // #include <SparseLinAlg/SparseLinAlg.hpp>
@@ -19,12 +20,14 @@ namespace DLA = DenseLinAlg;
 // namespace SLA = SparseLinAlg;
 
 // invDiag = inverse matrix of ( diagonal part of coeff )
-inline void makePreconditioner(double * const invDiag, double** const coeff, int sz);
+inline void makePreconditioner(double * const invDiag,
+		double * const coeff, int ld, int sz);
 
 
 // resid = b - coeff * x
 inline void vecMinusMatMultVec(double * resid,
-		double * const b, double** const coeff, double * const x, int sz);
+		double * const b, double * const coeff, int ld,
+		double * const x, int sz);
 
 // z = invDiag * resid
 inline void precondition( double * const z,
@@ -35,7 +38,7 @@ inline void vectorCopy( double * const p, double * const z, int sz);
 
 // q = coeff * p
 inline void matMultVec( double * q,
-		double** const coeff, double * const p, int sz);
+		double * const coeff, int ld, double * const p, int sz);
 
 // dot product of p and q
 inline double dot( double * const p, double * const q, int sz);
@@ -60,30 +63,37 @@ namespace DenseLinAlg {
 				const DLA::Matrix & coeffMat,
 				const DLA::Vector & rhsVec,
 				const DLA::Vector & initGuessVec,
-				double convergenceCriterion)
+				double convergenceCriterion,
+				DiagPrecondConGradWorkspace & workspace)
 	{
 		double* ans = ansVec.data;
-		double** const coeff = coeffMat.m;
+		// row-major elements with the stride of the leading dimension
+		double* const coeff = coeffMat.data;
+		const int ld = coeffMat.ld;
 		double* const b = rhsVec.data;
 		double* initGuess = initGuessVec.data;
 		const int sz = rhsVec.sz;
 
-		double *invDiag = new double[ sz],
-			*resid = new double[ sz],
-			*z = new double[ sz],
-			*q = new double[ sz],
-			*p = new double[ sz];
+		if ( workspace.sz < sz )
+			throw std::length_error( "diagPrecondConGrad : the workspace "
+				"is smaller than the problem size." );
+
+		double * const invDiag = workspace.invDiag,
+			* const resid = workspace.resid,
+			* const z = workspace.z,
+			* const q = workspace.q,
+			* const p = workspace.p;
 
 
-		makePreconditioner(invDiag, coeff, sz);
+		makePreconditioner(invDiag, coeff, ld, sz);
 
-		vecMinusMatMultVec( resid, b, coeff, initGuess, sz);
+		vecMinusMatMultVec( resid, b, coeff, ld, initGuess, sz);
 		precondition( z, invDiag, resid, sz);
-		double rho = dot( resid, z, sz);
+		double rho = ::dot( resid, z, sz);
 
 		vectorCopy( p, z, sz);
-		matMultVec( q, coeff, p, sz);
-		double alpha = rho / dot( p, q, sz);
+		matMultVec( q, coeff, ld, p, sz);
+		double alpha = rho / ::dot( p, q, sz);
 
 		vecPlusScalarMultVec( ans, initGuess, alpha, p, sz);
 		assignAndPlusScalarMultVec( resid, - alpha, q, sz);
@@ -94,26 +104,31 @@ namespace DenseLinAlg {
 		{
 			precondition( z, invDiag, resid, sz);
 			double prevRho = rho;
-			rho = dot( resid, z, sz);
+			rho = ::dot( resid, z, sz);
 
 			double beta = rho / prevRho;
 			vecPlusScalarMultVec( p, z, beta, p, sz);
 
-			matMultVec( q, coeff, p, sz);
-			alpha = rho / dot( p, q, sz);
+			matMultVec( q, coeff, ld, p, sz);
+			alpha = rho / ::dot( p, q, sz);
 			assignAndPlusScalarMultVec( ans, alpha, p, sz);
 			assignAndPlusScalarMultVec( resid, -alpha, q, sz);
 		}
 
-		delete [] p;
-		delete [] q;
-		delete [] z;
-		delete [] resid;
-		delete [] invDiag;
-
 		return;
 	}
 
+	void diagPrecondConGrad( DLA::Vector & ansVec,
+				const DLA::Matrix & coeffMat,
+				const DLA::Vector & rhsVec,
+				const DLA::Vector & initGuessVec,
+				double convergenceCriterion)
+	{
+		DiagPrecondConGradWorkspace workspace( rhsVec.size());
+		diagPrecondConGrad( ansVec, coeffMat, rhsVec, initGuessVec,
+							convergenceCriterion, workspace);
+	}
+
 }
 
 
@@ -9,15 +9,17 @@
 
 
 // invDiag = inverse matrix of ( diagonal part of coeff )
-inline void makePreconditioner(double * const invDiag, double** const coeff, int sz)
+inline void makePreconditioner(double * const invDiag,
+		double * const coeff, int ld, int sz)
 {
 	#pragma omp parallel for
-	for (int i = 0; i < sz ; i++) invDiag[i] = 1.0 / coeff[i][i];
+	for (int i = 0; i < sz ; i++) invDiag[i] = 1.0 / coeff[i * ld + i];
 }
 
 // resid = b - coeff * x
 inline void vecMinusMatMultVec(double* resid,
-		double * const b, double** const coeff, double * const x, int sz)
+		double * const b, double * const coeff, int ld,
+		double * const x, int sz)
 {
 	int ri, ci;
 	double matVec;
@@ -28,8 +30,8 @@ inline void vecMinusMatMultVec(double* resid,
 	// http://stackoverflow.com/questions/13199398/
 	//            openmp-predetermined-shared-for-shared
 	for (ri = 0; ri < sz; ri++) {
-		matVec = coeff[ri][0] * x[0];
-		for (ci = 1; ci  < sz; ci++) matVec += coeff[ri][ci] * x[ci];
+		matVec = coeff[ri * ld] * x[0];
+		for (ci = 1; ci  < sz; ci++) matVec += coeff[ri * ld + ci] * x[ci];
 		resid[ri] = b[ri] - matVec;
 	}
 }
@@ -51,19 +53,21 @@ inline void vectorCopy( double * const p, double * const z, int sz)
 
 // q = coeff * p
 inline void matMultVec( double * q,
-		double** const coeff, double * const p, int sz)
+		double * const coeff, int ld, double * const p, int sz)
 {
 	int ri, ci;
 	double matVec;
 
-	#pragma omp parallel for default(none) \
+	// default(none) is not used, since whether const variables like
+	// coeff and p are predetermined shared depends on the compiler version.
+	#pragma omp parallel for \
 	            private( ri, ci, matVec) shared( sz, q)
 	// double * const q cannot be put into shared( ).
 	// http://stackoverflow.com/questions/13199398/
 	//            openmp-predetermined-shared-for-shared
 	for (ri = 0; ri < sz; ri++) {
-		matVec = coeff[ri][0] * p[0];
-		for (ci = 1; ci < sz; ci++)	matVec += coeff[ri][ci] * p[ci];
+		matVec = coeff[ri * ld] * p[0];
+		for (ci = 1; ci < sz; ci++)	matVec += coeff[ri * ld + ci] * p[ci];
 		q[ri] = matVec;
 	}
 }
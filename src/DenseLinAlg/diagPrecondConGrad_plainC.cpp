@@ -10,18 +10,20 @@
 
 
 // invDiag = inverse matrix of ( diagonal part of coeff )
-inline void makePreconditioner(double * invDiag, double** const coeff, int sz)
+inline void makePreconditioner(double * invDiag,
+		double * const coeff, int ld, int sz)
 {
-	for (int i = 0; i < sz ; i++) invDiag[i] = 1.0 / coeff[i][i];
+	for (int i = 0; i < sz ; i++) invDiag[i] = 1.0 / coeff[i * ld + i];
 }
 
 // resid = b - coeff * x
 inline void vecMinusMatMultVec(double* resid,
-		double * const b, double** const coeff, double * const x, int sz)
+		double * const b, double * const coeff, int ld,
+		double * const x, int sz)
 {
 	for (int ri = 0; ri < sz; ri++) {
-		double p = coeff[ri][0] * x[0];
-		for (int ci = 1; ci  < sz; ci++) p += coeff[ri][ci] * x[ci];
+		double p = coeff[ri * ld] * x[0];
+		for (int ci = 1; ci  < sz; ci++) p += coeff[ri * ld + ci] * x[ci];
 		resid[ri] = b[ri] - p;
 	}
 }
@@ -41,11 +43,11 @@ inline void vectorCopy( double* p, double * const z, int sz)
 
 // q = coeff * p
 inline void matMultVec( double* q,
-		double** const coeff, double * const p, int sz)
+		double * const coeff, int ld, double * const p, int sz)
 {
 	for (int ri = 0; ri < sz; ri++) {
-		q[ri] = coeff[ri][0] * p[0];
-		for (int ci = 1; ci < sz; ci++) q[ri] += coeff[ri][ci] * p[ci];
+		q[ri] = coeff[ri * ld] * p[0];
+		for (int ci = 1; ci < sz; ci++) q[ri] += coeff[ri * ld + ci] * p[ci];
 	}
 }
 
@@ -0,0 +1,226 @@
+/*
+ * Dispatch.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef PARALLELIZATIONTYPETAG_DISPATCH_HPP_
+#define PARALLELIZATIONTYPETAG_DISPATCH_HPP_
+
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <ParallelizationTypeTag/ParallelizationTypeTag.hpp>
+
+//
+// Selecting the parallelization type at run time
+//
+namespace ParallelizationTypeTag {
+
+	// The SIMD extensions selectable at run time, from the narrowest
+	enum RuntimeSimd {
+		RuntimeNoSIMD, RuntimeSSE2, RuntimeAVX, RuntimeAVX512
+	};
+
+	inline const char* runtimeSimdName( RuntimeSimd simd)
+	{
+		static const char* const names[] = {
+			"nosimd", "sse2", "avx", "avx512" };
+		return names[ simd];
+	}
+
+	// The SIMD extension and the number of the threads of the kernels.
+	// More than one thread selects OpenMP ,
+	// which is available only if the program is compiled with it.
+	struct RuntimeTarget
+	{
+		RuntimeSimd simd;
+		int threads;
+	};
+
+	// the widest SIMD extension of the processor, probed by cpuid
+	inline RuntimeSimd detectRuntimeSimd()
+	{
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+		__builtin_cpu_init();
+		if ( __builtin_cpu_supports( "avx512f") ) return RuntimeAVX512;
+		if ( __builtin_cpu_supports( "avx") ) return RuntimeAVX;
+		if ( __builtin_cpu_supports( "sse2") ) return RuntimeSSE2;
+#endif
+		return RuntimeNoSIMD;
+	}
+
+	// the number of the threads of the OpenMP runtime
+	inline int detectRuntimeThreads()
+	{
+#ifdef _OPENMP
+		return omp_get_max_threads();
+#else
+		return 1;
+#endif
+	}
+
+	namespace Detail {
+
+		// The target of the kernels tagged with Runtime ,
+		// detected when the program starts.
+		// The members of this class template are defined in the header
+		// without being declared inline, so that the compiler
+		// does not warn about calling them out of line
+		// from the code run once.
+		template < typename Dummy = void >
+		struct RuntimeTargetHolder
+		{
+			static RuntimeTarget target;
+
+			static RuntimeTarget clamp( RuntimeTarget t);
+			static RuntimeTarget detect();
+		};
+
+		template < typename Dummy >
+		RuntimeTarget RuntimeTargetHolder< Dummy >::target =
+			RuntimeTargetHolder< Dummy >::detect();
+
+		template < typename Dummy >
+		RuntimeTarget RuntimeTargetHolder< Dummy >::clamp( RuntimeTarget t)
+		{
+			const RuntimeSimd widest = detectRuntimeSimd();
+			if ( t.simd > widest ) t.simd = widest;
+			if ( t.simd < RuntimeNoSIMD ) t.simd = RuntimeNoSIMD;
+#ifdef _OPENMP
+			if ( t.threads < 1 ) t.threads = 1;
+#else
+			t.threads = 1;
+#endif
+			return t;
+		}
+
+		template < typename Dummy >
+		RuntimeTarget RuntimeTargetHolder< Dummy >::detect()
+		{
+			RuntimeTarget t = { detectRuntimeSimd(), detectRuntimeThreads() };
+
+			if ( const char* simd = std::getenv( "PTT_SIMD") )
+				for (int s = RuntimeNoSIMD; s <= RuntimeAVX512; s++)
+					if ( std::strcmp( simd,
+							runtimeSimdName( RuntimeSimd( s) ) ) == 0 )
+						t.simd = RuntimeSimd( s);
+			if ( const char* threads = std::getenv( "PTT_THREADS") )
+				if ( std::atoi( threads) > 0 ) t.threads = std::atoi( threads);
+
+			return clamp( t);
+		}
+
+#ifdef _OPENMP
+		// Setting the number of the threads of the parallel regions
+		// started by the calling thread, while this object is alive.
+		// The other threads and the code after the dispatched kernel
+		// keep their own number.
+		class ScopedNumThreads
+		{
+		private:
+			const int previous;
+
+		public:
+			explicit ScopedNumThreads( int threads) :
+				previous( omp_get_max_threads() ) {
+				omp_set_num_threads( threads);
+			}
+			ScopedNumThreads( const ScopedNumThreads& ) = delete;
+			ScopedNumThreads& operator=( const ScopedNumThreads& ) = delete;
+
+			~ScopedNumThreads() { omp_set_num_threads( previous); }
+		};
+#endif
+
+	}
+
+	// the target narrowed to what the processor and the program support
+	inline RuntimeTarget clampRuntimeTarget( RuntimeTarget t)
+	{
+		return Detail::RuntimeTargetHolder<>::clamp( t);
+	}
+
+	// The target detected on this processor.
+	// The environment variables PTT_SIMD ( nosimd, sse2, avx or avx512 )
+	// and PTT_THREADS override it, within what the processor supports.
+	inline RuntimeTarget detectRuntimeTarget()
+	{
+		return Detail::RuntimeTargetHolder<>::detect();
+	}
+
+	// The target of the kernels tagged with Runtime ,
+	// detected when the program starts.
+	// The OpenMP kernels are run by its threads,
+	// without changing the number of the threads of the other code.
+	inline const RuntimeTarget& runtimeTarget()
+	{
+		return Detail::RuntimeTargetHolder<>::target;
+	}
+
+	// overriding the target, e.g. for benchmarking.
+	// It should be called outside of the kernels.
+	inline void setRuntimeTarget( const RuntimeTarget& t)
+	{
+		Detail::RuntimeTargetHolder<>::target = clampRuntimeTarget( t);
+	}
+
+
+	// Calling f with the arguments followed by
+	// the parallelization type tag of the target, like
+	//
+	//   dispatch( AssignVector(), rhs, lhs)
+	//
+	// A SIMD tag whose kernels are not compiled falls back to
+	// the narrower ones by the overload resolution of f .
+	template < typename Func, typename... Args >
+	auto dispatch( const Func& f, Args&&... args )
+	-> decltype( f( std::forward< Args >( args)...,
+					SingleProcess< SingleThread< NoSIMD > >() ) )
+	{
+		const RuntimeTarget& t = runtimeTarget();
+#ifdef _OPENMP
+		if ( t.threads > 1 ) {
+			const Detail::ScopedNumThreads threads( t.threads);
+			switch ( t.simd ) {
+			case RuntimeAVX512 :
+				return f( std::forward< Args >( args)...,
+						SingleProcess< OpenMP< AVX512 > >() );
+			case RuntimeAVX :
+				return f( std::forward< Args >( args)...,
+						SingleProcess< OpenMP< AVX > >() );
+			case RuntimeSSE2 :
+				return f( std::forward< Args >( args)...,
+						SingleProcess< OpenMP< SSE2 > >() );
+			default :
+				return f( std::forward< Args >( args)...,
+						SingleProcess< OpenMP< NoSIMD > >() );
+			}
+		}
+#endif
+		switch ( t.simd ) {
+		case RuntimeAVX512 :
+			return f( std::forward< Args >( args)...,
+					SingleProcess< SingleThread< AVX512 > >() );
+		case RuntimeAVX :
+			return f( std::forward< Args >( args)...,
+					SingleProcess< SingleThread< AVX > >() );
+		case RuntimeSSE2 :
+			return f( std::forward< Args >( args)...,
+					SingleProcess< SingleThread< SSE2 > >() );
+		default :
+			return f( std::forward< Args >( args)...,
+					SingleProcess< SingleThread< NoSIMD > >() );
+		}
+	}
+
+}
+
+
+#endif /* PARALLELIZATIONTYPETAG_DISPATCH_HPP_ */
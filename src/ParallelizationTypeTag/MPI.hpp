@@ -0,0 +1,104 @@
+/*
+ * MPI.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef PARALLELIZATIONTYPETAG_MPI_HPP_
+#define PARALLELIZATIONTYPETAG_MPI_HPP_
+
+#include <mpi.h>
+
+#include <ParallelizationTypeTag/ParallelizationTypeTag.hpp>
+
+// The first of Default.hpp, OpenMP.hpp, Runtime.hpp, ThreadPool.hpp
+// and MPI.hpp included specifies the parallelization type.
+#ifndef PARALLELIZATIONTYPETAG_SPECIFIED_
+#define PARALLELIZATIONTYPETAG_SPECIFIED_
+
+namespace ParallelizationTypeTag {
+
+#ifdef _OPENMP
+	typedef MPI< OpenMP< NoSIMD > > Specified;
+#else
+	typedef MPI< SingleThread< NoSIMD > > Specified;
+#endif
+}
+
+#endif
+
+
+//
+// Collective operations of the kernels tagged with MPI
+//
+// Every process holds the rows of the distributed vectors it owns,
+// and the kernels tagged with MPI< Multithreading > evaluate them
+// by those tagged with SingleProcess< Multithreading > .
+// The reductions are then combined over the processes.
+// MPI is called only by the thread calling the kernels,
+// and should be initialized by MPI_Init_thread( ) with
+// MPI_THREAD_FUNNELED or higher for the multithreaded kernels.
+//
+namespace ParallelizationTypeTag {
+
+	namespace Detail {
+
+		inline MPI_Comm& selectedCommunicator()
+		{
+			static MPI_Comm comm = MPI_COMM_WORLD;
+			return comm;
+		}
+	}
+
+	// The communicator of the processes sharing the distributed vectors
+	inline MPI_Comm communicator() { return Detail::selectedCommunicator(); }
+
+	inline void setCommunicator( MPI_Comm comm)
+	{
+		Detail::selectedCommunicator() = comm;
+	}
+
+	// The MPI datatype of the scalar type
+	template < typename T > struct MpiDatatype;
+
+	template <> struct MpiDatatype< int > {
+		static MPI_Datatype type() { return MPI_INT; }
+	};
+	template <> struct MpiDatatype< float > {
+		static MPI_Datatype type() { return MPI_FLOAT; }
+	};
+	template <> struct MpiDatatype< double > {
+		static MPI_Datatype type() { return MPI_DOUBLE; }
+	};
+	template <> struct MpiDatatype< long double > {
+		static MPI_Datatype type() { return MPI_LONG_DOUBLE; }
+	};
+
+	// Summing the n values of all the processes in place
+	template < typename T, class Multithreading >
+	void allreduceSum( T* values, int n, const MPI< Multithreading >& )
+	{
+		MPI_Allreduce( MPI_IN_PLACE, values, n, MpiDatatype< T >::type(),
+						MPI_SUM, communicator() );
+	}
+
+	template < typename T, class Multithreading >
+	T allreduceSum( T value, const MPI< Multithreading >& pt)
+	{
+		allreduceSum( &value, 1, pt);
+		return value;
+	}
+
+	template < typename T, class Multithreading >
+	T allreduceMax( T value, const MPI< Multithreading >& )
+	{
+		MPI_Allreduce( MPI_IN_PLACE, &value, 1, MpiDatatype< T >::type(),
+						MPI_MAX, communicator() );
+		return value;
+	}
+
+}
+
+
+#endif /* PARALLELIZATIONTYPETAG_MPI_HPP_ */
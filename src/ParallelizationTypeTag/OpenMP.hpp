@@ -5,16 +5,22 @@
  *      Author: Masakatsu ITO
  */
 
-#ifndef PARALLELIZATIONTYPETAG_HPP_
-#define PARALLELIZATIONTYPETAG_HPP_
+#ifndef PARALLELIZATIONTYPETAG_OPENMP_HPP_
+#define PARALLELIZATIONTYPETAG_OPENMP_HPP_
 
 #include <ParallelizationTypeTag/ParallelizationTypeTag.hpp>
 
+// The first of Default.hpp, OpenMP.hpp, Runtime.hpp, ThreadPool.hpp
+// and MPI.hpp included specifies the parallelization type.
+#ifndef PARALLELIZATIONTYPETAG_SPECIFIED_
+#define PARALLELIZATIONTYPETAG_SPECIFIED_
+
 namespace ParallelizationTypeTag {
 
 	typedef SingleProcess< OpenMP< NoSIMD > > Specified;
-
 }
 
+#endif
+
 
-#endif /* PARALLELIZATIONTYPETAG_HPP_ */
+#endif /* PARALLELIZATIONTYPETAG_OPENMP_HPP_ */
@@ -22,18 +22,40 @@ namespace ParallelizationTypeTag {
 	struct SSE4_1 : SSE3 {};
 	struct SSE4_2 : SSE4_1 {};
 	struct AVX : SSE4_2 {};
+	struct AVX2 : AVX {};
+	struct AVX512 : AVX2 {};
 	// ?? Altivec ???
 
+	// The widest SIMD extension enabled for the compiler
+#if defined(__AVX512F__)
+	typedef AVX512 NativeSIMD;
+#elif defined(__AVX2__)
+	typedef AVX2 NativeSIMD;
+#elif defined(__AVX__)
+	typedef AVX NativeSIMD;
+#elif defined(__SSE2__)
+	typedef SSE2 NativeSIMD;
+#else
+	typedef NoSIMD NativeSIMD;
+#endif
+
 
 	// Multithreading types
 	template < class SimdTag > struct OpenMP : SimdTag {};
 	template < class SimdTag > class SingleThread : SimdTag {};
+	// threads of a work-stealing pool, see WorkStealingPool.hpp
+	template < class SimdTag > struct ThreadPool : SimdTag {};
 
 
 	// Multiprocessing types
 	template < class Multithreding > struct MPI : Multithreding {};
 	template < class Multithreding > struct SingleProcess : Multithreding {};
 
+
+	// The SIMD extension and the multithreading type
+	// selected at run time for each kernel, see Dispatch.hpp
+	struct Runtime {};
+
 }
 
 
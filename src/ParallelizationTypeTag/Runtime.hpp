@@ -0,0 +1,27 @@
+/*
+ * Runtime.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef PARALLELIZATIONTYPETAG_RUNTIME_HPP_
+#define PARALLELIZATIONTYPETAG_RUNTIME_HPP_
+
+#include <ParallelizationTypeTag/ParallelizationTypeTag.hpp>
+#include <ParallelizationTypeTag/Dispatch.hpp>
+
+// The first of Default.hpp, OpenMP.hpp, Runtime.hpp, ThreadPool.hpp
+// and MPI.hpp included specifies the parallelization type.
+#ifndef PARALLELIZATIONTYPETAG_SPECIFIED_
+#define PARALLELIZATIONTYPETAG_SPECIFIED_
+
+namespace ParallelizationTypeTag {
+
+	typedef SingleProcess< Runtime > Specified;
+}
+
+#endif
+
+
+#endif /* PARALLELIZATIONTYPETAG_RUNTIME_HPP_ */
@@ -0,0 +1,27 @@
+/*
+ * ThreadPool.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef PARALLELIZATIONTYPETAG_THREADPOOL_HPP_
+#define PARALLELIZATIONTYPETAG_THREADPOOL_HPP_
+
+#include <ParallelizationTypeTag/ParallelizationTypeTag.hpp>
+#include <ParallelizationTypeTag/WorkStealingPool.hpp>
+
+// The first of Default.hpp, OpenMP.hpp, Runtime.hpp, ThreadPool.hpp
+// and MPI.hpp included specifies the parallelization type.
+#ifndef PARALLELIZATIONTYPETAG_SPECIFIED_
+#define PARALLELIZATIONTYPETAG_SPECIFIED_
+
+namespace ParallelizationTypeTag {
+
+	typedef SingleProcess< ThreadPool< NoSIMD > > Specified;
+}
+
+#endif
+
+
+#endif /* PARALLELIZATIONTYPETAG_THREADPOOL_HPP_ */
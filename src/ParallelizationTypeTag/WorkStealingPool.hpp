@@ -0,0 +1,398 @@
+/*
+ * WorkStealingPool.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef PARALLELIZATIONTYPETAG_WORKSTEALINGPOOL_HPP_
+#define PARALLELIZATIONTYPETAG_WORKSTEALINGPOOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <ParallelizationTypeTag/ParallelizationTypeTag.hpp>
+
+//
+// Thread pool running the kernels tagged with ThreadPool
+//
+namespace ParallelizationTypeTag {
+
+	class TaskGroup;
+	template < typename State > class WorkerStates;
+
+	// Pool of the threads stealing the tasks of each other.
+	//
+	// Every thread has its own deque of the tasks.
+	// It pushes and pops its tasks at the back,
+	// and steals those of the others at the front when its deque is empty,
+	// so that the larger halves of the ranges split first are stolen.
+	// A thread waiting for its tasks runs the queued tasks meanwhile,
+	// and thus the kernels called in the tasks, like those of
+	// several solves run at the same time, do not oversubscribe the cores.
+	class WorkStealingPool
+	{
+	public:
+		typedef std::function< void() > Task;
+
+		// The ranges are split into this number of chunks per thread.
+		static const int ChunksPerThread = 4;
+
+	private:
+		struct Deque {
+			std::mutex mutex;
+			std::deque< Task > tasks;
+		};
+
+		// The deque 0 is shared by the threads outside of the pool,
+		// and the others are owned by the workers.
+		std::vector< std::unique_ptr< Deque > > deques;
+		std::vector< std::thread > workers;
+		std::atomic< int > queued;
+
+		std::mutex sleepMutex;
+		std::condition_variable wake;
+		bool stopping;
+
+		// the pool running the calling thread and the index of its deque
+		struct Current {
+			WorkStealingPool* pool;
+			int index;
+		};
+
+		static Current& current() {
+			static thread_local Current c = { nullptr, 0 };
+			return c;
+		}
+
+		int ownDeque() const {
+			const Current& c = current();
+			return c.pool == this ? c.index : 0;
+		}
+
+		void push( Task task)
+		{
+			Deque& d = *deques[ ownDeque() ];
+			{
+				std::lock_guard< std::mutex > lock( d.mutex);
+				d.tasks.push_back( std::move( task) );
+			}
+			queued++;
+			{
+				std::lock_guard< std::mutex > lock( sleepMutex);
+			}
+			wake.notify_one();
+		}
+
+		bool pop( Task& task)
+		{
+			if ( queued.load() == 0 ) return false;
+
+			const int n = numThreads(), self = ownDeque();
+			{
+				Deque& d = *deques[ self];
+				std::lock_guard< std::mutex > lock( d.mutex);
+				if ( ! d.tasks.empty() ) {
+					task = std::move( d.tasks.back() );
+					d.tasks.pop_back();
+					queued--;
+					return true;
+				}
+			}
+			for (int k = 1; k < n; k++) {
+				Deque& d = *deques[ ( self + k ) % n ];
+				std::lock_guard< std::mutex > lock( d.mutex);
+				if ( ! d.tasks.empty() ) {
+					task = std::move( d.tasks.front() );
+					d.tasks.pop_front();
+					queued--;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void work( int index)
+		{
+			current() = Current{ this, index };
+			Task task;
+			for (;;) {
+				if ( pop( task) ) {
+					task();
+					task = nullptr;
+					continue;
+				}
+				std::unique_lock< std::mutex > lock( sleepMutex);
+				wake.wait( lock, [this] { return stopping || queued.load() > 0; });
+				if ( stopping && queued.load() == 0 ) return;
+			}
+		}
+
+		template < typename Body >
+		static void split( TaskGroup& group, int first, int last, int grain,
+							const Body& body);
+
+		friend class TaskGroup;
+		template < typename State > friend class WorkerStates;
+
+	public:
+		// numThreads threads including the caller,
+		// which runs the tasks while waiting for them
+		explicit WorkStealingPool( int numThreads) :
+			queued( 0), stopping( false)
+		{
+			const int n = std::max( numThreads, 1);
+			for (int i = 0; i < n; i++) deques.emplace_back( new Deque);
+			for (int i = 1; i < n; i++)
+				workers.emplace_back( &WorkStealingPool::work, this, i);
+		}
+
+		WorkStealingPool( const WorkStealingPool&) = delete;
+		WorkStealingPool& operator=( const WorkStealingPool&) = delete;
+
+		~WorkStealingPool()
+		{
+			{
+				std::lock_guard< std::mutex > lock( sleepMutex);
+				stopping = true;
+			}
+			wake.notify_all();
+			for (std::thread& w : workers) w.join();
+		}
+
+		int numThreads() const { return int( deques.size() ); }
+
+		// running a queued task, if any, by the calling thread
+		bool runOne()
+		{
+			Current& c = current();
+			const Current saved = c;
+			if ( c.pool != this ) c = Current{ this, 0 };
+			Task task;
+			const bool found = pop( task);
+			if ( found ) task();
+			c = saved;
+			return found;
+		}
+
+		// The pool of the threads of the environment variable PTT_THREADS ,
+		// or of the cores
+		static WorkStealingPool& global()
+		{
+			static WorkStealingPool pool( defaultThreads() );
+			return pool;
+		}
+
+		static int defaultThreads()
+		{
+			if ( const char* threads = std::getenv( "PTT_THREADS") )
+				if ( std::atoi( threads) > 0 ) return std::atoi( threads);
+			return std::max( int( std::thread::hardware_concurrency() ), 1);
+		}
+
+		// The pool running the calling thread, or the global pool
+		// for the threads outside of the pools.
+		// The kernels tagged with ThreadPool run on this pool.
+		static WorkStealingPool& local()
+		{
+			const Current& c = current();
+			return c.pool ? *c.pool : global();
+		}
+
+		// the chunk of the numItems items run by a task
+		int chunkSize( int numItems) const
+		{
+			const int chunks = numThreads() * ChunksPerThread;
+			return std::max( 1, ( numItems + chunks - 1 ) / chunks );
+		}
+
+		// Calling body( f, l) on the subranges of [ first, last ) ,
+		// which are split in halves down to grain items.
+		template < typename Body >
+		void parallelFor( int first, int last, int grain, const Body& body);
+
+		// Calling body( f, l) on the chunks of [ 0, size ) ,
+		// whose boundaries are multiples of blockSize
+		template < typename Body >
+		void parallelForBlocks( int size, int blockSize, const Body& body)
+		{
+			const int numBlocks = ( size + blockSize - 1 ) / blockSize;
+			parallelFor( 0, numBlocks, chunkSize( numBlocks),
+				[&body, size, blockSize]( int firstBlock, int lastBlock) {
+					body( firstBlock * blockSize,
+						std::min( lastBlock * blockSize, size) );
+				} );
+		}
+
+		// Reducing [ 0, size ) in the blocks of blockSize items.
+		// The partial results of the blocks in the chunk [ f, l ) are
+		// stored into partials[ 0 ], partials[ 1 ], ... by
+		// body( f, l, partials), and combined by combine( acc, partial)
+		// in the order of the blocks.
+		// The result thus does not depend on the threads.
+		template < typename T, typename Body, typename Combine >
+		T reduceBlocks( int size, int blockSize, const T& identity,
+						const Body& body, const Combine& combine)
+		{
+			const int numBlocks = ( size + blockSize - 1 ) / blockSize;
+			std::vector< T > partials( numBlocks, identity);
+			T* const p = partials.data();
+			parallelForBlocks( size, blockSize,
+				[&body, p, blockSize]( int first, int last) {
+					body( first, last, p + first / blockSize);
+				} );
+
+			T acc = identity;
+			for (int b = 0; b < numBlocks; b++) combine( acc, partials[b]);
+			return acc;
+		}
+	};
+
+
+	// Tasks waited for together, like independent solves
+	//
+	//   PTT::TaskGroup solves( pool);
+	//   solves.run( [&]() { solver1.solveAndAssign( b1, x1); } );
+	//   solves.run( [&]() { solver2.solveAndAssign( b2, x2); } );
+	//   solves.wait();
+	//
+	// The tasks should not throw exceptions.
+	class TaskGroup
+	{
+	private:
+		WorkStealingPool& pool;
+		std::atomic< int > pending;
+
+	public:
+		explicit TaskGroup(
+			WorkStealingPool& p = WorkStealingPool::local() ) :
+			pool( p), pending( 0) {}
+
+		TaskGroup( const TaskGroup&) = delete;
+		TaskGroup& operator=( const TaskGroup&) = delete;
+
+		~TaskGroup() { wait(); }
+
+		template < typename Func >
+		void run( Func func)
+		{
+			pending++;
+			pool.push( [this, func]() {
+				func();
+				pending--;
+			} );
+		}
+
+		// running the queued tasks until those of this group are finished
+		void wait()
+		{
+			while ( pending.load() > 0 )
+				if ( ! pool.runOne() ) std::this_thread::yield();
+		}
+	};
+
+
+	// The states of the tasks of a loop, like the lazy evaluators with
+	// their caches, made once for every thread of the pool rather than
+	// once for every task.
+	//
+	//   PTT::WorkerStates< Evaluator > evaluators( pool);
+	//   pool.parallelForBlocks( size, blockSize, [&]( int f, int l) {
+	//       evaluators.run( [&]() { return new Evaluator( expr); },
+	//           [&]( Evaluator& e) { ... } );
+	//   } );
+	//
+	// A task borrows a state, made by make( ) when it is borrowed first,
+	// and gives it back when body( state) returns. The threads outside
+	// of the pool share the first state, so that a task finding every
+	// state borrowed makes one of its own.
+	template < typename State >
+	class WorkerStates
+	{
+	private:
+		const WorkStealingPool& pool;
+		std::unique_ptr< std::atomic< bool >[] > borrowed;
+		std::vector< std::unique_ptr< State > > states;
+
+	public:
+		explicit WorkerStates( const WorkStealingPool& p);
+		~WorkerStates();
+
+		WorkerStates( const WorkerStates&) = delete;
+		WorkerStates& operator=( const WorkerStates&) = delete;
+
+		template < typename Make, typename Body >
+		void run( const Make& make, const Body& body);
+	};
+
+
+	template < typename Body >
+	void WorkStealingPool::split( TaskGroup& group, int first, int last,
+								int grain, const Body& body)
+	{
+		while ( last - first > grain ) {
+			const int middle = first + ( last - first ) / 2;
+			group.run( [&group, &body, middle, last, grain]() {
+				split( group, middle, last, grain, body);
+			} );
+			last = middle;
+		}
+		body( first, last);
+	}
+
+	template < typename Body >
+	void WorkStealingPool::parallelFor( int first, int last, int grain,
+										const Body& body)
+	{
+		if ( first >= last ) return;
+		grain = std::max( grain, 1);
+		if ( numThreads() == 1 || last - first <= grain ) {
+			body( first, last);
+			return;
+		}
+		TaskGroup group( *this);
+		split( group, first, last, grain, body);
+		group.wait();
+	}
+
+	template < typename State >
+	WorkerStates< State >::WorkerStates( const WorkStealingPool& p) :
+		pool( p), borrowed( new std::atomic< bool >[ p.numThreads() ] ),
+		states( p.numThreads() )
+	{
+		for (int s = 0; s < p.numThreads(); s++) borrowed[s] = false;
+	}
+
+	template < typename State >
+	WorkerStates< State >::~WorkerStates() = default;
+
+	template < typename State >
+	template < typename Make, typename Body >
+	void WorkerStates< State >::run( const Make& make, const Body& body)
+	{
+		const int n = pool.numThreads(), self = pool.ownDeque();
+		for (int k = 0; k < n; k++) {
+			const int s = ( self + k ) % n;
+			if ( borrowed[s].exchange( true) ) continue;
+			if ( ! states[s] ) states[s].reset( make() );
+			body( *states[s] );
+			borrowed[s].store( false);
+			return;
+		}
+		const std::unique_ptr< State > own( make() );
+		body( *own);
+	}
+
+}
+
+
+#endif /* PARALLELIZATIONTYPETAG_WORKSTEALINGPOOL_HPP_ */
@@ -0,0 +1,218 @@
+/*
+ * BandedMatrix.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef SPARSELINALG_BANDEDMATRIX_HPP_
+#define SPARSELINALG_BANDEDMATRIX_HPP_
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/proto/proto.hpp>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+
+
+namespace SparseLinAlg {
+
+	namespace DLA = DenseLinAlg;
+	namespace PTT = ParallelizationTypeTag;
+	namespace proto = boost::proto;
+
+
+	template < typename VecType > struct LazyBandedMatVecMult;
+
+	// Banded matrix storing only its diagonals
+	//
+	// The diagonals are stored one after another (diagonal-major layout).
+	// The element (ri, ci) within the band is stored in
+	// data[ d * rowSz + ri ], where d = ci - ri + lowerBw is the index of
+	// the diagonal, 0 <= d < lowerBw + upperBw + 1 .
+	class BandedMatrix
+	{
+	private:
+		const int rowSz, colSz, lowerBw, upperBw, diagSz;
+		double* data;
+
+	public:
+		typedef double value_type;
+
+		explicit BandedMatrix(int rowSize, int columnSize,
+				int lowerBandwidth, int upperBandwidth,
+				double iniVal = 0.0) :
+			rowSz( rowSize), colSz( columnSize),
+			lowerBw( lowerBandwidth), upperBw( upperBandwidth),
+			diagSz( lowerBandwidth + upperBandwidth + 1),
+			data( DLA::DefaultAllocator::allocate< double >( diagSz * rowSz) )
+		{
+			// Every diagonal is divided among the threads by the rows.
+			for (int d = 0; d < diagSz; d++)
+				DLA::FillLines()( data + d * rowSz, rowSz, 1, iniVal,
+								PTT::Specified() );
+		}
+
+		BandedMatrix( const BandedMatrix & mat) :
+			rowSz( mat.rowSz), colSz( mat.colSz),
+			lowerBw( mat.lowerBw), upperBw( mat.upperBw),
+			diagSz( mat.diagSz),
+			data( DLA::DefaultAllocator::allocate< double >( diagSz * rowSz) )
+		{
+			for (int d = 0; d < diagSz; d++)
+				DLA::CopyLines()( data + d * rowSz, mat.data + d * rowSz,
+								rowSz, 1, PTT::Specified() );
+		}
+
+		BandedMatrix& operator=( const BandedMatrix & ) = delete;
+
+		~BandedMatrix()
+		{
+			DLA::DefaultAllocator::deallocate( data);
+		}
+
+		int rowSize() const { return rowSz; }
+		int columnSize() const { return colSz; }
+		int lowerBandwidth() const { return lowerBw; }
+		int upperBandwidth() const { return upperBw; }
+
+		// Interleaving the pages of the diagonals across the NUMA nodes.
+		// Returning false if the NUMA policy is not supported.
+		bool interleave() const {
+			return DLA::interleavePages( data, diagSz * rowSz);
+		}
+
+		// Accessing to a matrix element within the band.
+		// The elements out of the band are not stored,
+		// so that they are neither read nor written through this.
+		double& operator()(int ri, int ci)
+		{
+			const int d = ci - ri + lowerBw;
+			if ( ri < 0 || ri >= rowSz || ci < 0 || ci >= colSz ||
+				d < 0 || d >= diagSz )
+				throw std::out_of_range( "BandedMatrix : the element "
+					"is out of the matrix or out of the band." );
+			return data[ d * rowSz + ri];
+		}
+
+		// accessing to a matrix element,
+		// which is zero if it is out of the band.
+		double operator()(int ri, int ci) const
+		{
+			const int d = ci - ri + lowerBw;
+			return ( d >= 0 && d < diagSz ) ? data[ d * rowSz + ri] : 0.0;
+		}
+
+		template < typename VecType > friend struct LazyBandedMatVecMult;
+		friend struct DLA::TransposedMatVecKernel< BandedMatrix >;
+	};
+
+
+	// Lazy function object for evaluating an element of
+	// the resultant vector from the multiplication of
+	// a banded matrix and a vector.
+	//
+	// An expression like ( bandedMatrix * vector )(index) is transformed
+	// into the loop over the in-band elements of the index'th row.
+	template < typename VecType >
+	struct LazyBandedMatVecMult
+	{
+		BandedMatrix const& m;
+		VecType const& v;
+
+		typedef typename DLA::PromotedScalar< double,
+				typename VecType::value_type >::type result_type;
+
+		explicit LazyBandedMatVecMult(BandedMatrix const& mat,
+									VecType const& vec) :
+			m( mat), v( vec) {}
+
+		LazyBandedMatVecMult( LazyBandedMatVecMult const& lazy) :
+			m(lazy.m), v(lazy.v) {}
+
+		result_type operator()(int index) const
+		{
+			// the range of the diagonals whose column index
+			// ci = index + d - lowerBw is within [0, colSz)
+			const int dBegin = index < m.lowerBw ? m.lowerBw - index : 0;
+			const int dEnd = m.colSz - index + m.lowerBw < m.diagSz ?
+							 m.colSz - index + m.lowerBw : m.diagSz;
+			const int ciOffset = index - m.lowerBw;
+
+			result_type elm = 0.0;
+			for (int d = dBegin; d < dEnd; d++)
+				elm += m.data[ d * m.rowSz + index] * v( ciOffset + d);
+			return elm;
+		}
+	};
+
+
+	// Callable transform object to make the lazy functor
+	// a proto exression for lazily evaluationg the multiplication
+	// of a banded matrix and a vector .
+	struct BandedMatVecMult : proto::callable
+	{
+		template < typename Sig > struct result;
+
+		template < typename This, typename MatType, typename VecType >
+		struct result< This( MatType, VecType) >
+		{
+			typedef typename proto::terminal< LazyBandedMatVecMult<
+				typename boost::remove_const<
+					typename boost::remove_reference< VecType >::type
+				>::type
+			> >::type type;
+		};
+
+		template < typename VecType >
+		typename proto::terminal< LazyBandedMatVecMult< VecType > >::type
+		operator()( BandedMatrix const& mat, VecType const& vec) const
+		{
+			return proto::as_expr( LazyBandedMatVecMult< VecType >(mat, vec) );
+		}
+	};
+
+}
+
+
+namespace DenseLinAlg {
+
+	template<> struct IsExpr< SparseLinAlg::BandedMatrix > : mpl::true_  {};
+
+	// Scattering the diagonals of the rows of a banded matrix
+	// for the product of its transpose and a vector.
+	// Each diagonal is read contiguously, being added into
+	// the elements of y shifted by its offset.
+	template<>
+	struct TransposedMatVecKernel< SparseLinAlg::BandedMatrix >
+	{
+		static int blocks( const SparseLinAlg::BandedMatrix& m) {
+			return m.rowSz;
+		}
+
+		template < typename VecType, typename Scalar >
+		static void add( const SparseLinAlg::BandedMatrix& m,
+						int first, int last, const VecType& x, Scalar* y)
+		{
+			for (int d = 0; d < m.diagSz; d++) {
+				// the rows whose column index ci = ri + d - lowerBw
+				// is within [0, colSz)
+				const int ciOffset = d - m.lowerBw;
+				const int riBegin = std::max( first, - ciOffset),
+						riEnd = std::min( last, m.colSz - ciOffset);
+				const double* const diag = m.data + d * m.rowSz;
+				for (int ri = riBegin; ri < riEnd; ri++)
+					y[ ri + ciOffset] += diag[ri] * x( ri);
+			}
+		}
+	};
+
+	template< typename VecType >
+	struct IsExpr< SparseLinAlg::LazyBandedMatVecMult< VecType > >
+		: mpl::true_  {};
+
+}
+
+
+#endif /* SPARSELINALG_BANDEDMATRIX_HPP_ */
@@ -0,0 +1,360 @@
+/*
+ * CsrMatrix.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef SPARSELINALG_CSRMATRIX_HPP_
+#define SPARSELINALG_CSRMATRIX_HPP_
+
+#include <stdexcept>
+
+#include <boost/proto/proto.hpp>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+
+
+namespace SparseLinAlg {
+
+	namespace DLA = DenseLinAlg;
+	namespace proto = boost::proto;
+
+
+	template < typename VecType > struct LazyCsrMatVecMult;
+	template < typename MultiVecType > struct LazyCsrMatMultiVecMult;
+	class SellMatrix;
+	class DistCsrMatrix;
+
+	// Sparse matrix in the compressed sparse row (CSR) format
+	//
+	// The nonzero elements are stored row by row. The elements of
+	// the ri'th row are val[ k ], colIdx[ k ]
+	// for rowPtr[ ri ] <= k < rowPtr[ ri + 1 ] .
+	class CsrMatrix
+	{
+	private:
+		const int rowSz, colSz, nnz;
+		int* rowPtr;
+		int* colIdx;
+		double* val;
+
+		// the number of elements inserted so far, and
+		// the row index of the last inserted element
+		int filledSz, lastRow;
+
+		static int countNonZeros( const DLA::Matrix & mat)
+		{
+			int n = 0;
+			for (int ri = 0; ri < mat.rowSize(); ri++)
+				for (int ci = 0; ci < mat.columnSize(); ci++)
+					if ( mat(ri, ci) != 0.0 ) n++;
+			return n;
+		}
+
+	public:
+		typedef double value_type;
+
+		// Allocating a matrix having nonZeroSize elements.
+		// The elements should be inserted afterward
+		// with insert() in the row-major order, and then
+		// assemble() checks that all of them are inserted.
+		explicit CsrMatrix(int rowSize, int columnSize, int nonZeroSize) :
+			rowSz( rowSize), colSz( columnSize), nnz( nonZeroSize),
+			rowPtr( DLA::DefaultAllocator::allocate< int >( rowSz + 1) ),
+			colIdx( DLA::DefaultAllocator::allocate< int >( nnz) ),
+			val( DLA::DefaultAllocator::allocate< double >( nnz) ),
+			filledSz( 0), lastRow( -1)
+		{
+			// The rows not yet reached by insert() are empty
+			// and start at the end of the element arrays.
+			rowPtr[0] = 0;
+			for (int ri = 1; ri <= rowSz; ri++) rowPtr[ri] = nnz;
+		}
+
+		// Converting a dense matrix, dropping its zero elements
+		explicit CsrMatrix( const DLA::Matrix & mat) :
+			rowSz( mat.rowSize()), colSz( mat.columnSize()),
+			nnz( countNonZeros( mat)),
+			rowPtr( DLA::DefaultAllocator::allocate< int >( rowSz + 1) ),
+			colIdx( DLA::DefaultAllocator::allocate< int >( nnz) ),
+			val( DLA::DefaultAllocator::allocate< double >( nnz) ),
+			filledSz( 0), lastRow( -1)
+		{
+			rowPtr[0] = 0;
+			for (int ri = 1; ri <= rowSz; ri++) rowPtr[ri] = nnz;
+
+			for (int ri = 0; ri < rowSz; ri++)
+				for (int ci = 0; ci < colSz; ci++)
+					if ( mat(ri, ci) != 0.0 ) insert( ri, ci, mat(ri, ci));
+			assemble();
+		}
+
+		CsrMatrix( const CsrMatrix & mat) :
+			rowSz( mat.rowSz), colSz( mat.colSz), nnz( mat.nnz),
+			rowPtr( DLA::DefaultAllocator::allocate< int >( rowSz + 1) ),
+			colIdx( DLA::DefaultAllocator::allocate< int >( nnz) ),
+			val( DLA::DefaultAllocator::allocate< double >( nnz) ),
+			filledSz( mat.filledSz), lastRow( mat.lastRow)
+		{
+			for (int ri = 0; ri <= rowSz; ri++) rowPtr[ri] = mat.rowPtr[ri];
+			for (int k = 0; k < nnz; k++) {
+				colIdx[k] = mat.colIdx[k];
+				val[k] = mat.val[k];
+			}
+		}
+
+		CsrMatrix& operator=( const CsrMatrix & ) = delete;
+
+		~CsrMatrix()
+		{
+			DLA::DefaultAllocator::deallocate( val);
+			DLA::DefaultAllocator::deallocate( colIdx);
+			DLA::DefaultAllocator::deallocate( rowPtr);
+		}
+
+		int rowSize() const { return rowSz; }
+		int columnSize() const { return colSz; }
+		int nonZeroSize() const { return nnz; }
+
+		// Interleaving the pages of the arrays across the NUMA nodes,
+		// since the elements are inserted by a thread.
+		// Returning false if the NUMA policy is not supported.
+		bool interleave() const {
+			return DLA::interleavePages( rowPtr, rowSz + 1)
+				&& DLA::interleavePages( colIdx, nnz)
+				&& DLA::interleavePages( val, nnz);
+		}
+
+		// Inserting a nonzero element.
+		// The row indices should be in the ascending order, and
+		// so should be the column indices within a row.
+		void insert(int ri, int ci, double v)
+		{
+			if ( filledSz == nnz )
+				throw std::length_error( "CsrMatrix : more elements are "
+					"inserted than the nonzero size." );
+			if ( ri < lastRow || ri >= rowSz )
+				throw std::out_of_range( "CsrMatrix : the row index "
+					"is out of range or not in the ascending order." );
+			if ( ci < 0 || ci >= colSz )
+				throw std::out_of_range( "CsrMatrix : the column index "
+					"is out of range." );
+			// operator()( ri, ci) finds the columns by the binary search.
+			if ( ri == lastRow && ci <= colIdx[ filledSz - 1] )
+				throw std::out_of_range( "CsrMatrix : the column index "
+					"is not in the ascending order within the row." );
+
+			for (int r = lastRow + 1; r <= ri; r++) rowPtr[r] = filledSz;
+			lastRow = ri;
+
+			colIdx[ filledSz] = ci;
+			val[ filledSz] = v;
+			filledSz++;
+		}
+
+		// Checking that the nonzero size of elements are inserted,
+		// since the rows after the last inserted element
+		// start at the end of the element arrays.
+		void assemble() const
+		{
+			if ( filledSz != nnz )
+				throw std::logic_error( "CsrMatrix : fewer elements are "
+					"inserted than the nonzero size." );
+		}
+
+		// accessing to a matrix element,
+		// which is zero if it is not stored.
+		double operator()(int ri, int ci) const
+		{
+			int lo = rowPtr[ri], hi = rowPtr[ri + 1];
+			while ( lo < hi ) {
+				const int mid = (lo + hi) / 2;
+				if ( colIdx[mid] < ci ) lo = mid + 1;
+				else hi = mid;
+			}
+			return ( lo < rowPtr[ri + 1] && colIdx[lo] == ci ) ?
+					val[lo] : 0.0;
+		}
+
+		template < typename VecType > friend struct LazyCsrMatVecMult;
+		template < typename MultiVecType >
+		friend struct LazyCsrMatMultiVecMult;
+		friend class SellMatrix;
+		friend class DistCsrMatrix;
+		friend struct DLA::TransposedMatVecKernel< CsrMatrix >;
+	};
+
+
+	// Lazy function object for evaluating an element of
+	// the resultant vector from the multiplication of
+	// a CSR matrix and a vector.
+	//
+	// An expression like ( csrMatrix * vector )(index) is transformed
+	// into the loop over the nonzero elements of the index'th row.
+	template < typename VecType >
+	struct LazyCsrMatVecMult
+	{
+		CsrMatrix const& m;
+		VecType const& v;
+
+		typedef typename DLA::PromotedScalar< double,
+				typename VecType::value_type >::type result_type;
+
+		explicit LazyCsrMatVecMult(CsrMatrix const& mat,
+									VecType const& vec) :
+			m( mat), v( vec) {}
+
+		LazyCsrMatVecMult( LazyCsrMatVecMult const& lazy) :
+			m(lazy.m), v(lazy.v) {}
+
+		result_type operator()(int index) const
+		{
+			result_type elm = 0.0;
+			const int end = m.rowPtr[index + 1];
+			for (int k = m.rowPtr[index]; k < end; k++)
+				elm += m.val[k] * v( m.colIdx[k]);
+			return elm;
+		}
+	};
+
+
+	// Callable transform object to make the lazy functor
+	// a proto exression for lazily evaluationg the multiplication
+	// of a CSR matrix and a vector .
+	struct CsrMatVecMult : proto::callable
+	{
+		template < typename Sig > struct result;
+
+		template < typename This, typename MatType, typename VecType >
+		struct result< This( MatType, VecType) >
+		{
+			typedef typename proto::terminal< LazyCsrMatVecMult<
+				typename boost::remove_const<
+					typename boost::remove_reference< VecType >::type
+				>::type
+			> >::type type;
+		};
+
+		template < typename VecType >
+		typename proto::terminal< LazyCsrMatVecMult< VecType > >::type
+		operator()( CsrMatrix const& mat, VecType const& vec) const
+		{
+			return proto::as_expr( LazyCsrMatVecMult< VecType >(mat, vec) );
+		}
+	};
+
+
+	// Lazy function object for evaluating an element of
+	// the resultant multivector from the multiplication of
+	// a CSR matrix and a multivector.
+	//
+	// The whole row of the result is computed when an element of
+	// a new row is requested, so that the nonzero elements of the row
+	// are read only once for all the vectors.
+	template < typename MultiVecType >
+	struct LazyCsrMatMultiVecMult
+	{
+		CsrMatrix const& m;
+		MultiVecType const& x;
+		const int numVecs;
+		mutable int cachedRow;
+		mutable DLA::Vector rowCache;
+
+		typedef double result_type;
+
+		explicit LazyCsrMatMultiVecMult(CsrMatrix const& mat,
+										MultiVecType const& mv) :
+			m( mat), x( mv), numVecs( mv.numVectors()), cachedRow( -1),
+			rowCache( mv.numVectors()) {}
+
+		LazyCsrMatMultiVecMult( LazyCsrMatMultiVecMult const& lazy) :
+			m( lazy.m), x( lazy.x), numVecs( lazy.numVecs), cachedRow( -1),
+			rowCache( lazy.numVecs) {}
+
+		result_type operator()(int ri, int j) const
+		{
+			if ( ri != cachedRow ) {
+				double* const y = &rowCache(0);
+				for (int vi = 0; vi < numVecs; vi++) y[vi] = 0.0;
+				const int end = m.rowPtr[ri + 1];
+				for (int k = m.rowPtr[ri]; k < end; k++) {
+					const double a = m.val[k];
+					const double* const xRow = x.row( m.colIdx[k]);
+					for (int vi = 0; vi < numVecs; vi++) y[vi] += a * xRow[vi];
+				}
+				cachedRow = ri;
+			}
+			return rowCache( j);
+		}
+	};
+
+
+	// Callable transform object to make the lazy functor
+	// a proto exression for lazily evaluationg the multiplication
+	// of a CSR matrix and a multivector .
+	struct CsrMatMultiVecMult : proto::callable
+	{
+		template < typename Sig > struct result;
+
+		template < typename This, typename MatType, typename MultiVecType >
+		struct result< This( MatType, MultiVecType) >
+		{
+			typedef typename proto::terminal< LazyCsrMatMultiVecMult<
+				typename boost::remove_const<
+					typename boost::remove_reference< MultiVecType >::type
+				>::type
+			> >::type type;
+		};
+
+		template < typename MultiVecType >
+		typename proto::terminal<
+			LazyCsrMatMultiVecMult< MultiVecType > >::type
+		operator()( CsrMatrix const& mat, MultiVecType const& mv) const
+		{
+			return proto::as_expr(
+				LazyCsrMatMultiVecMult< MultiVecType >(mat, mv) );
+		}
+	};
+
+}
+
+
+namespace DenseLinAlg {
+
+	template<> struct IsExpr< SparseLinAlg::CsrMatrix > : mpl::true_  {};
+
+	// Scattering the nonzero elements of the rows of a CSR matrix
+	// for the product of its transpose and a vector
+	template<>
+	struct TransposedMatVecKernel< SparseLinAlg::CsrMatrix >
+	{
+		static int blocks( const SparseLinAlg::CsrMatrix& m) {
+			return m.rowSz;
+		}
+
+		template < typename VecType, typename Scalar >
+		static void add( const SparseLinAlg::CsrMatrix& m, int first, int last,
+						const VecType& x, Scalar* y)
+		{
+			for (int ri = first; ri < last; ri++) {
+				const typename VecType::value_type xr = x( ri);
+				const int end = m.rowPtr[ri + 1];
+				for (int k = m.rowPtr[ri]; k < end; k++)
+					y[ m.colIdx[k] ] += m.val[k] * xr;
+			}
+		}
+	};
+
+	template< typename VecType >
+	struct IsExpr< SparseLinAlg::LazyCsrMatVecMult< VecType > >
+		: mpl::true_  {};
+
+	template< typename MultiVecType >
+	struct IsExpr< SparseLinAlg::LazyCsrMatMultiVecMult< MultiVecType > >
+		: mpl::true_  {};
+
+}
+
+
+#endif /* SPARSELINALG_CSRMATRIX_HPP_ */
@@ -0,0 +1,485 @@
+/*
+ * DistCsrMatrix.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef SPARSELINALG_DISTCSRMATRIX_HPP_
+#define SPARSELINALG_DISTCSRMATRIX_HPP_
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/proto/proto.hpp>
+
+#include <ParallelizationTypeTag/MPI.hpp>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/CsrMatrix.hpp>
+
+
+namespace SparseLinAlg {
+
+	namespace DLA = DenseLinAlg;
+	namespace PTT = ParallelizationTypeTag;
+	namespace proto = boost::proto;
+
+
+	// Partition of the rows of the distributed vectors and matrices
+	// into the processes of a communicator
+	//
+	// The process of the rank r owns the rows from firstRow( r )
+	// to firstRow( r + 1 ) - 1 .
+	// Its part of a distributed vector is a DLA::Vector
+	// of those localSize( ) rows.
+	class RowPartition
+	{
+	private:
+		MPI_Comm comm;
+		int rank, numProcs;
+		std::vector< int > offsets;
+
+	public:
+		// dividing the rows as evenly as possible
+		explicit RowPartition( int globalSize,
+							MPI_Comm communicator = PTT::communicator() ) :
+			comm( communicator)
+		{
+			MPI_Comm_rank( comm, &rank);
+			MPI_Comm_size( comm, &numProcs);
+			offsets.resize( numProcs + 1);
+			for (int r = 0; r <= numProcs; r++)
+				offsets[r] = int( long( globalSize) * r / numProcs );
+		}
+
+		MPI_Comm communicator() const { return comm; }
+		int processRank() const { return rank; }
+		int numProcesses() const { return numProcs; }
+
+		int globalSize() const { return offsets[ numProcs]; }
+		int firstRow( int r) const { return offsets[r]; }
+		int firstRow() const { return offsets[ rank]; }
+		int localSize() const { return offsets[ rank + 1] - offsets[ rank]; }
+
+		// the rank of the process owning the row
+		int owner( int globalRow) const
+		{
+			return int( std::upper_bound( offsets.begin(), offsets.end(),
+											globalRow) - offsets.begin() ) - 1;
+		}
+	};
+
+
+	template < typename VecType > struct LazyDistCsrMatVecMult;
+
+	namespace Detail {
+
+		// The containers of DistCsrMatrix .
+		// The destructor of this class template is defined in the header
+		// without being declared inline, so that the compiler
+		// does not warn about calling it out of line
+		// from the paths of the exceptions.
+		template < typename Dummy = void >
+		struct DistCsrMembers
+		{
+			const RowPartition rows;
+
+			// the elements inserted until assemble( ) ,
+			// by the local row indices and the global column indices
+			std::vector< int > insertedRows, insertedCols;
+			std::vector< double > insertedVals;
+
+			std::unique_ptr< CsrMatrix > diag, offDiag;
+
+			// the global indices of the halo columns in the ascending order
+			std::vector< int > haloCols;
+
+			// The halo columns of the process recvProcs[ n ] are
+			// from recvOffsets[ n ] to recvOffsets[ n + 1 ] - 1 .
+			// The rows sendRows[ k ] for
+			// sendOffsets[ n ] <= k < sendOffsets[ n + 1 ]
+			// are sent to the process sendProcs[ n ] .
+			std::vector< int > recvProcs, recvOffsets;
+			std::vector< int > sendProcs, sendOffsets, sendRows;
+
+			mutable std::vector< double > sendBuffer;
+			mutable std::vector< MPI_Request > requests;
+
+			// The halos of the vectors multiplied in the expression evaluated,
+			// by their addresses, from exchangeHalo( ) to releaseHalo( ) .
+			// The buffers released are reused by the next exchanges, so that
+			// there are only as many of them as the vectors multiplied
+			// in an expression.
+			// The elements of a deque are not moved by push_back( ) .
+			struct Halo {
+				const void* vec;
+				DLA::Vector elements;
+			};
+			mutable std::deque< Halo > halos;
+
+			// the halo of a matrix without the halo columns
+			const DLA::Vector noHalo;
+
+			explicit DistCsrMembers( const RowPartition& partition) :
+				rows( partition), noHalo( 0) {}
+			~DistCsrMembers();
+		};
+
+		template < typename Dummy >
+		DistCsrMembers< Dummy >::~DistCsrMembers() {}
+
+	}
+
+	// Sparse matrix in the CSR format distributed by the rows
+	//
+	// Every process holds the rows it owns by the row partition,
+	// which also divides the columns like the vectors multiplied.
+	// They are stored in two CSR matrices, the diagonal block of
+	// the columns owned by the process, and the off-diagonal block
+	// of the columns owned by the others, the halo columns.
+	//
+	// The sizes and the elements accessed are those of the diagonal block,
+	// so that the rows of this process are evaluated
+	// like those of the other matrices, e.g. by DiagonalPreconditioner .
+	//
+	// The halo of a vector, its elements of the halo columns,
+	// is received from the other processes before
+	// the product with the vector is evaluated.
+	// It is exchanged by the kernels tagged with PTT::MPI ,
+	// which should thus evaluate the expressions
+	// multiplying a distributed matrix on more than one process.
+	class DistCsrMatrix : private Detail::DistCsrMembers<>
+	{
+	private:
+		static const int HaloTag = 1;
+
+		const int nnzCap;
+
+		Halo* findHalo( const void* vec) const
+		{
+			for (Halo& h : halos)
+				if ( h.vec == vec ) return &h;
+			return nullptr;
+		}
+
+		// compressing the counts of the processes into
+		// the processes of nonzero counts and their offsets
+		static void compress( const std::vector< int >& counts,
+				std::vector< int >& procs, std::vector< int >& offsets)
+		{
+			offsets.assign( 1, 0);
+			for (int r = 0; r < int( counts.size() ); r++)
+				if ( counts[r] > 0 ) {
+					procs.push_back( r);
+					offsets.push_back( offsets.back() + counts[r]);
+				}
+		}
+
+	public:
+		typedef double value_type;
+
+		// Allocating the rows of this process
+		// having localNonZeroSize elements.
+		// The elements should be inserted afterward with insert( )
+		// in the row-major order, and then assemble( ) is called
+		// by all the processes.
+		explicit DistCsrMatrix( const RowPartition& partition,
+								int localNonZeroSize) :
+			DistCsrMembers( partition), nnzCap( localNonZeroSize)
+		{
+			insertedRows.reserve( nnzCap);
+			insertedCols.reserve( nnzCap);
+			insertedVals.reserve( nnzCap);
+		}
+
+		// Distributing a matrix every process has.
+		// This is a collective operation.
+		explicit DistCsrMatrix( const CsrMatrix& mat,
+								const RowPartition& partition) :
+			DistCsrMembers( partition),
+			nnzCap( mat.rowPtr[ partition.firstRow() + partition.localSize() ]
+					- mat.rowPtr[ partition.firstRow() ])
+		{
+			insertedRows.reserve( nnzCap);
+			insertedCols.reserve( nnzCap);
+			insertedVals.reserve( nnzCap);
+			const int first = rows.firstRow();
+			for (int ri = first; ri < first + rows.localSize(); ri++)
+				for (int k = mat.rowPtr[ri]; k < mat.rowPtr[ri + 1]; k++)
+					insert( ri, mat.colIdx[k], mat.val[k]);
+			assemble();
+		}
+
+		DistCsrMatrix( const DistCsrMatrix & ) = delete;
+		DistCsrMatrix& operator=( const DistCsrMatrix & ) = delete;
+
+		const RowPartition& partition() const { return rows; }
+
+		int rowSize() const { return rows.localSize(); }
+		int columnSize() const { return rows.localSize(); }
+		int globalRowSize() const { return rows.globalSize(); }
+		int haloSize() const { return int( haloCols.size() ); }
+
+		// Inserting a nonzero element of a row of this process
+		// by the global indices.
+		// The row indices should be in the ascending order, and
+		// so should be the column indices within a row.
+		// They are checked here, since assemble( ) is collective.
+		void insert( int globalRow, int globalCol, double v)
+		{
+			if ( int( insertedVals.size() ) == nnzCap )
+				throw std::length_error( "DistCsrMatrix : more elements are "
+					"inserted than the local nonzero size." );
+			const int ri = globalRow - rows.firstRow(),
+					lastRow = insertedRows.empty() ? 0 : insertedRows.back();
+			if ( ri < lastRow || ri >= rows.localSize() )
+				throw std::out_of_range( "DistCsrMatrix : the row index "
+					"is not of this process or not in the ascending order." );
+			// rows.owner( ) of the halo columns indexes the processes.
+			if ( globalCol < 0 || globalCol >= globalRowSize() )
+				throw std::out_of_range( "DistCsrMatrix : the column index "
+					"is out of range." );
+			if ( ! insertedRows.empty() && ri == lastRow &&
+					globalCol <= insertedCols.back() )
+				throw std::out_of_range( "DistCsrMatrix : the column index "
+					"is not in the ascending order within the row." );
+
+			insertedRows.push_back( ri);
+			insertedCols.push_back( globalCol);
+			insertedVals.push_back( v);
+		}
+
+		// Splitting the inserted elements into the blocks, and
+		// telling the other processes the rows they send in the halos.
+		// This is a collective operation.
+		void assemble()
+		{
+			const int first = rows.firstRow(), localSz = rows.localSize(),
+					numProcs = rows.numProcesses();
+			const int n = int( insertedVals.size() );
+			MPI_Comm comm = rows.communicator();
+
+			// the halo columns in the ascending order, and thus
+			// in the order of their owners
+			for (int k = 0; k < n; k++)
+				if ( insertedCols[k] < first || insertedCols[k] >= first + localSz )
+					haloCols.push_back( insertedCols[k]);
+			std::sort( haloCols.begin(), haloCols.end() );
+			haloCols.erase( std::unique( haloCols.begin(), haloCols.end() ),
+							haloCols.end() );
+			const int diagSz = n - int( std::count_if( insertedCols.begin(),
+				insertedCols.end(), [first, localSz]( int c) {
+					return c < first || c >= first + localSz; } ) );
+
+			diag.reset( new CsrMatrix( localSz, localSz, diagSz) );
+			offDiag.reset( new CsrMatrix( localSz, int( haloCols.size() ),
+											n - diagSz) );
+			for (int k = 0; k < n; k++) {
+				const int c = insertedCols[k];
+				if ( c >= first && c < first + localSz )
+					diag->insert( insertedRows[k], c - first, insertedVals[k]);
+				else
+					offDiag->insert( insertedRows[k],
+						int( std::lower_bound( haloCols.begin(), haloCols.end(), c)
+							- haloCols.begin() ), insertedVals[k]);
+			}
+			diag->assemble();
+			offDiag->assemble();
+			std::vector< int >().swap( insertedRows);
+			std::vector< int >().swap( insertedCols);
+			std::vector< double >().swap( insertedVals);
+
+			// Every process tells the owners the halo columns it receives.
+			std::vector< int > recvCounts( numProcs, 0), sendCounts( numProcs);
+			for (int c : haloCols) recvCounts[ rows.owner( c) ]++;
+			MPI_Alltoall( recvCounts.data(), 1, MPI_INT,
+						sendCounts.data(), 1, MPI_INT, comm);
+
+			std::vector< int > recvDispls( numProcs, 0), sendDispls( numProcs, 0);
+			for (int r = 1; r < numProcs; r++) {
+				recvDispls[r] = recvDispls[r - 1] + recvCounts[r - 1];
+				sendDispls[r] = sendDispls[r - 1] + sendCounts[r - 1];
+			}
+			sendRows.resize( sendDispls[ numProcs - 1] + sendCounts[ numProcs - 1]);
+			MPI_Alltoallv( haloCols.data(), recvCounts.data(), recvDispls.data(),
+				MPI_INT, sendRows.data(), sendCounts.data(), sendDispls.data(),
+				MPI_INT, comm);
+			for (int& r : sendRows) r -= first;
+
+			compress( recvCounts, recvProcs, recvOffsets);
+			compress( sendCounts, sendProcs, sendOffsets);
+			sendBuffer.resize( sendRows.size() );
+			requests.resize( recvProcs.size() + sendProcs.size() );
+		}
+
+		// Receiving the halo of the vector of the rows of this process
+		// from the other processes, and sending those of theirs.
+		// This is a collective operation.
+		template < typename VecType >
+		void exchangeHalo( const VecType& vec) const
+		{
+			Halo* h = findHalo( &vec);
+			if ( ! h ) h = findHalo( nullptr);
+			if ( ! h ) {
+				halos.push_back(
+					Halo{ nullptr, DLA::Vector( int( haloCols.size() ) ) } );
+				h = &halos.back();
+			}
+			h->vec = &vec;
+			DLA::Vector& halo = h->elements;
+			MPI_Comm comm = rows.communicator();
+			int r = 0;
+			for (int n = 0; n < int( recvProcs.size() ); n++)
+				MPI_Irecv( &halo( recvOffsets[n]),
+					recvOffsets[n + 1] - recvOffsets[n], MPI_DOUBLE,
+					recvProcs[n], HaloTag, comm, &requests[ r++]);
+
+			for (int k = 0; k < int( sendRows.size() ); k++)
+				sendBuffer[k] = vec( sendRows[k]);
+			for (int n = 0; n < int( sendProcs.size() ); n++)
+				MPI_Isend( sendBuffer.data() + sendOffsets[n],
+					sendOffsets[n + 1] - sendOffsets[n], MPI_DOUBLE,
+					sendProcs[n], HaloTag, comm, &requests[ r++]);
+
+			MPI_Waitall( r, requests.data(), MPI_STATUSES_IGNORE);
+		}
+
+		// Releasing the halo of the vector after the expression
+		// multiplying it is evaluated,
+		// so that it is not read when the vector has been changed.
+		template < typename VecType >
+		void releaseHalo( const VecType& vec) const
+		{
+			if ( Halo* h = findHalo( &vec) ) h->vec = nullptr;
+		}
+
+		// The halo of the vector exchanged and not yet released.
+		// A matrix without the halo columns does not need to exchange it.
+		template < typename VecType >
+		const DLA::Vector& halo( const VecType& vec) const
+		{
+			if ( const Halo* h = findHalo( &vec) ) return h->elements;
+			if ( haloCols.empty() ) return noHalo;
+			throw std::logic_error( "DistCsrMatrix : the halo of the vector "
+				"is not exchanged. The product should be evaluated "
+				"by the kernels tagged with PTT::MPI ." );
+		}
+
+		const CsrMatrix& diagonalBlock() const { return *diag; }
+		const CsrMatrix& offDiagonalBlock() const { return *offDiag; }
+
+		// accessing to an element of the diagonal block
+		// by the local indices
+		double operator()(int ri, int ci) const { return (*diag)( ri, ci); }
+
+		// Interleaving the pages of the blocks across the NUMA nodes.
+		bool interleave() const {
+			return diag->interleave() && offDiag->interleave();
+		}
+	};
+
+
+	// Lazy function object for evaluating an element of
+	// the resultant vector from the multiplication of
+	// a distributed CSR matrix and a vector.
+	//
+	// An element is the sum of the products of
+	// the diagonal block and the vector, and
+	// the off-diagonal block and the halo of the vector.
+	template < typename VecType >
+	struct LazyDistCsrMatVecMult
+	{
+		LazyCsrMatVecMult< VecType > diag;
+		LazyCsrMatVecMult< DLA::Vector > offDiag;
+
+		typedef typename LazyCsrMatVecMult< VecType >::result_type result_type;
+
+		explicit LazyDistCsrMatVecMult(DistCsrMatrix const& mat,
+										VecType const& vec) :
+			diag( mat.diagonalBlock(), vec),
+			offDiag( mat.offDiagonalBlock(), mat.halo( vec) ) {}
+
+		LazyDistCsrMatVecMult( LazyDistCsrMatVecMult const& lazy) :
+			diag( lazy.diag), offDiag( lazy.offDiag) {}
+
+		result_type operator()(int index) const
+		{
+			return diag( index) + offDiag( index);
+		}
+	};
+
+
+	// Callable transform object to make the lazy functor
+	// a proto exression for lazily evaluationg the multiplication
+	// of a distributed CSR matrix and a vector .
+	struct DistCsrMatVecMult : proto::callable
+	{
+		template < typename Sig > struct result;
+
+		template < typename This, typename MatType, typename VecType >
+		struct result< This( MatType, VecType) >
+		{
+			typedef typename proto::terminal< LazyDistCsrMatVecMult<
+				typename boost::remove_const<
+					typename boost::remove_reference< VecType >::type
+				>::type
+			> >::type type;
+		};
+
+		template < typename VecType >
+		typename proto::terminal< LazyDistCsrMatVecMult< VecType > >::type
+		operator()( DistCsrMatrix const& mat, VecType const& vec) const
+		{
+			return proto::as_expr( LazyDistCsrMatVecMult< VecType >(mat, vec) );
+		}
+	};
+
+	// Callable transform object exchanging the halo of the vector
+	// in HaloExchangeGrammar , which returns the state as it is
+	struct DistCsrExchangeHalo : proto::callable
+	{
+		typedef int result_type;
+
+		template < typename VecType >
+		int operator()( DistCsrMatrix const& mat, VecType const& vec,
+						int state) const
+		{
+			mat.exchangeHalo( vec);
+			return state;
+		}
+	};
+
+	// Callable transform object releasing the halo of the vector
+	// in HaloReleaseGrammar , which returns the state as it is
+	struct DistCsrReleaseHalo : proto::callable
+	{
+		typedef int result_type;
+
+		template < typename VecType >
+		int operator()( DistCsrMatrix const& mat, VecType const& vec,
+						int state) const
+		{
+			mat.releaseHalo( vec);
+			return state;
+		}
+	};
+
+}
+
+
+namespace DenseLinAlg {
+
+	template<> struct IsExpr< SparseLinAlg::DistCsrMatrix > : mpl::true_  {};
+
+	template< typename VecType >
+	struct IsExpr< SparseLinAlg::LazyDistCsrMatVecMult< VecType > >
+		: mpl::true_  {};
+
+}
+
+
+#endif /* SPARSELINALG_DISTCSRMATRIX_HPP_ */
@@ -8,9 +8,20 @@
 #ifndef SPARSELINALG_ITERSOLVER_HPP_
 #define SPARSELINALG_ITERSOLVER_HPP_
 
+#include <cmath>
+#include <cstddef>
 #include <limits>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/Preconditioner.hpp>
 
 namespace DLA = DenseLinAlg;
 
@@ -69,6 +80,85 @@ namespace SparseLinAlg {
 	}
 
 
+	// Temporary vectors of the conjugate gradient method,
+	// which are kept between solves of the same problem size.
+	class ConjugateGradientWorkspace
+	{
+	private :
+		int sz;
+
+	public :
+		DLA::Vector resid, z, q, p;
+
+		explicit ConjugateGradientWorkspace( int problemSize = 0) :
+			sz( problemSize), resid( problemSize), z( problemSize),
+			q( problemSize), p( problemSize) {}
+
+		int size() const { return sz; }
+
+		// Reallocating the vectors only if the problem size is changed
+		void reserve( int problemSize)
+		{
+			if ( problemSize == sz ) return;
+			sz = problemSize;
+			resid = DLA::Vector( sz);
+			z = DLA::Vector( sz);
+			q = DLA::Vector( sz);
+			p = DLA::Vector( sz);
+		}
+
+		// Peak memory of the workspace for the problem size
+		static std::size_t bytes( int problemSize)
+		{
+			return 4 * sizeof( double) * std::size_t( problemSize);
+		}
+	};
+
+
+	// Partial sums of the threads of a parallel region,
+	// which are combined in the region.
+	//
+	// Every thread stores its partial sums into its own cache line,
+	// and after a barrier adds up those of all the threads
+	// in the order of the threads.
+	// The two sets of the slots are used in turn, so that
+	// a set is not overwritten until all the threads have read it.
+	class RegionPartialSums
+	{
+	private :
+		static const int Stride = 8;
+
+		const int maxThreads;
+		std::vector< double > slots;
+
+	public :
+		explicit RegionPartialSums( int maxNumThreads) :
+			maxThreads( maxNumThreads), slots( 2 * maxNumThreads * Stride) {}
+
+		// Combining the sums of the thread t of numThreads threads
+		// in the round'th reduction of the region.
+		// All the threads should call it in the same rounds.
+		template < int N >
+		void reduce( double ( &sums)[ N], int t, int numThreads, int round)
+		{
+			static_assert( N <= Stride, "Too many sums are reduced at once.");
+			double* const set = slots.data() + ( round % 2 ) * maxThreads * Stride;
+			for (int k = 0; k < N; k++) set[ t * Stride + k] = sums[k];
+			#pragma omp barrier
+			for (int k = 0; k < N; k++) {
+				sums[k] = 0.0;
+				for (int u = 0; u < numThreads; u++)
+					sums[k] += set[ u * Stride + k];
+			}
+		}
+	};
+
+
+	// Conjugate gradient method
+	//
+	// The solves without a workspace argument use the workspace of
+	// this solver, and thus are not thread-safe; the threads solving
+	// with the same solver at once should pass their own workspaces.
 	template <typename MatType, typename PreType>
 	class ConjugateGradient : public AbstIterSolver
 	{
@@ -76,10 +166,48 @@ namespace SparseLinAlg {
 		const MatType & coeff;
 		const PreType & precond;
 
+		// The workspace is owned by this solver unless it is passed in,
+		// and is pointed to by workspacePtr in either case.
+		const std::unique_ptr< ConjugateGradientWorkspace > ownedWorkspace;
+		ConjugateGradientWorkspace * const workspacePtr;
+
+		ConjugateGradientWorkspace & workspace() const
+		{
+			return *workspacePtr;
+		}
+
 	public :
 		explicit ConjugateGradient(const MatType & coefficients,
 				const PreType & preconditioner ) :
-				coeff( coefficients), precond( preconditioner) {}
+				coeff( coefficients), precond( preconditioner),
+				ownedWorkspace( new ConjugateGradientWorkspace(
+									coefficients.rowSize() ) ),
+				workspacePtr( ownedWorkspace.get() ) {}
+
+		explicit ConjugateGradient(const MatType & coefficients,
+				const PreType & preconditioner,
+				ConjugateGradientWorkspace & externalWorkspace) :
+				coeff( coefficients), precond( preconditioner),
+				workspacePtr( &externalWorkspace) {}
+
+		// A copy shares the workspace passed in, or
+		// owns a new workspace of the same size.
+		ConjugateGradient( const ConjugateGradient & solver) :
+				AbstIterSolver(),
+				coeff( solver.coeff), precond( solver.precond),
+				ownedWorkspace( solver.ownedWorkspace ?
+					new ConjugateGradientWorkspace( solver.workspacePtr->size() )
+					: nullptr ),
+				workspacePtr( ownedWorkspace ?
+					ownedWorkspace.get() : solver.workspacePtr ) {}
+
+		ConjugateGradient & operator=( const ConjugateGradient & ) = delete;
+
+		// Peak memory of the temporary vectors for the problem size
+		static std::size_t workspaceBytes( int problemSize)
+		{
+			return ConjugateGradientWorkspace::bytes( problemSize);
+		}
 
 		virtual void solveAndAssign( const DLA::Vector & b,
 					const DLA::Vector & iniGuess,
@@ -87,24 +215,253 @@ namespace SparseLinAlg {
 					const double convgergenceCriterion,
 					const int maxIter = std::numeric_limits<int>::max()) const
 		{
-			DLA::Vector resid( b.columnSize()), z( b.columnSize()),
-					q( b.columnSize());
+			solveAndAssign< DLA::Vector, DLA::Vector, DLA::Vector >(
+					b, iniGuess, lhs, convgergenceCriterion, maxIter);
+		}
+
+		// Solving with the vectors of any type in the vector grammar,
+		// e.g. DLA::VectorView wrapping arrays of the caller,
+		// so that they are not copied.
+		template < typename BType, typename GuessType, typename LhsType >
+		void solveAndAssign( const BType & b,
+					const GuessType & iniGuess,
+					LhsType & lhs,
+					const double convgergenceCriterion,
+					const int maxIter = std::numeric_limits<int>::max()) const
+		{
+			_solveAndAssign( b, iniGuess, lhs, convgergenceCriterion, maxIter,
+							workspace(), PTT::Specified());
+		}
+
+		// solving by the parallelization type pt
+		template < typename BType, typename GuessType, typename LhsType,
+					typename ParallelizationType >
+		void solveAndAssign( const BType & b,
+					const GuessType & iniGuess,
+					LhsType & lhs,
+					const double convgergenceCriterion,
+					const int maxIter,
+					const ParallelizationType & pt) const
+		{
+			_solveAndAssign( b, iniGuess, lhs, convgergenceCriterion, maxIter,
+							workspace(), pt);
+		}
+
+		// solving with the workspace of the caller ,
+		// which may be called by more than one thread at once
+		template < typename BType, typename GuessType, typename LhsType,
+					typename ParallelizationType >
+		void solveAndAssign( const BType & b,
+					const GuessType & iniGuess,
+					LhsType & lhs,
+					const double convgergenceCriterion,
+					const int maxIter,
+					const ParallelizationType & pt,
+					ConjugateGradientWorkspace & ws) const
+		{
+			_solveAndAssign( b, iniGuess, lhs, convgergenceCriterion, maxIter,
+							ws, pt);
+		}
+
+	private :
+		template < typename BType, typename GuessType, typename LhsType,
+					typename ParallelizationType >
+		void _solveAndAssign( const BType & b,
+					const GuessType & iniGuess,
+					LhsType & lhs,
+					const double convgergenceCriterion,
+					const int maxIter,
+					ConjugateGradientWorkspace & ws,
+					const ParallelizationType &) const
+		{
+			solveByKernels( b, iniGuess, lhs, convgergenceCriterion, maxIter,
+							ws);
+		}
+
+		// With OpenMP , the whole solve runs in a single parallel region
+		// if the preconditioner is evaluated row by row.
+		template < typename BType, typename GuessType, typename LhsType,
+					typename SimdTag >
+		void _solveAndAssign( const BType & b,
+					const GuessType & iniGuess,
+					LhsType & lhs,
+					const double convgergenceCriterion,
+					const int maxIter,
+					ConjugateGradientWorkspace & ws,
+					const PTT::SingleProcess< PTT::OpenMP< SimdTag > > &) const
+		{
+			solveInParallelRegion( b, iniGuess, lhs,
+				convgergenceCriterion, maxIter, ws, SimdTag(),
+				std::integral_constant< bool,
+					std::is_same< PreType, DiagonalPreconditioner >::value >() );
+		}
+
+		template < typename BType, typename GuessType, typename LhsType,
+					typename SimdTag >
+		void solveInParallelRegion( const BType & b,
+					const GuessType & iniGuess,
+					LhsType & lhs,
+					const double convgergenceCriterion,
+					const int maxIter,
+					ConjugateGradientWorkspace & ws,
+					const SimdTag &,
+					std::false_type) const
+		{
+			solveByKernels( b, iniGuess, lhs, convgergenceCriterion, maxIter,
+							ws);
+		}
+
+		// Every thread updates the same rows of the vectors
+		// in all the iterations, and the dot products are combined
+		// in the region by RegionPartialSums .
+		// An iteration thus waits at three barriers,
+		// after updating p , after p.dot( q ) , and after
+		// the fused updates of lhs , resid and z with
+		// the norm of resid and resid.dot( z ) .
+		template < typename BType, typename GuessType, typename LhsType,
+					typename SimdTag >
+		void solveInParallelRegion( const BType & b,
+					const GuessType & iniGuess,
+					LhsType & lhs,
+					const double convgergenceCriterion,
+					const int maxIter,
+					ConjugateGradientWorkspace & ws,
+					const SimdTag & simd,
+					std::true_type) const
+		{
+			const int sz = b.columnSize();
+			ws.reserve( sz);
+			DLA::Vector & resid = ws.resid, & z = ws.z,
+					& q = ws.q, & p = ws.p;
+			const DiagonalPreconditioner & diag = precond;
+
+#ifdef _OPENMP
+			RegionPartialSums partials( omp_get_max_threads());
+#else
+			RegionPartialSums partials( 1);
+#endif
+
+			#pragma omp parallel
+			{
+#ifdef _OPENMP
+				const int numThreads = omp_get_num_threads(),
+						t = omp_get_thread_num();
+#else
+				const int numThreads = 1, t = 0;
+#endif
+				const int first = int( long( sz) * t / numThreads ),
+						last = int( long( sz) * ( t + 1 ) / numThreads );
+				int round = 0;
+
+				assignRows( b - coeff * iniGuess, resid, first, last, simd);
+				double sums[2] = { 0.0, 0.0 };
+				for (int i = first; i < last; i++) {
+					z(i) = diag.inverseDiagonal( i) * resid(i);
+					p(i) = z(i);
+					sums[0] += resid(i) * z(i);
+					sums[1] += b(i) * b(i);
+				}
+				partials.reduce( sums, t, numThreads, round++);
+				double rho = sums[0];
+				const double bAbs = std::sqrt( sums[1]);
+
+				assignRows( coeff * p, q, first, last, simd);
+				double pq[1] = { 0.0 };
+				for (int i = first; i < last; i++) pq[0] += p(i) * q(i);
+				partials.reduce( pq, t, numThreads, round++);
+				double alpha = rho / pq[0];
+
+				sums[0] = sums[1] = 0.0;
+				for (int i = first; i < last; i++) {
+					lhs(i) = iniGuess(i) + alpha * p(i);
+					resid(i) -= alpha * q(i);
+					z(i) = diag.inverseDiagonal( i) * resid(i);
+					sums[0] += resid(i) * resid(i);
+					sums[1] += resid(i) * z(i);
+				}
+				partials.reduce( sums, t, numThreads, round++);
+				double residAbs = std::sqrt( sums[0]), residDotZ = sums[1];
+
+				// All the threads leave the loop at the same iteration,
+				// since they have the same sums.
+				for (int iter = 0;
+						iter < maxIter &&
+						residAbs / bAbs >  convgergenceCriterion ;
+						iter++ )
+				{
+					const double prevRho = rho;
+					rho = residDotZ;
+					const double beta = rho / prevRho;
+					for (int i = first; i < last; i++) p(i) = z(i) + beta * p(i);
+					#pragma omp barrier
+
+					assignRows( coeff * p, q, first, last, simd);
+					pq[0] = 0.0;
+					for (int i = first; i < last; i++) pq[0] += p(i) * q(i);
+					partials.reduce( pq, t, numThreads, round++);
+					alpha = rho / pq[0];
+
+					sums[0] = sums[1] = 0.0;
+					for (int i = first; i < last; i++) {
+						lhs(i) += alpha * p(i);
+						resid(i) -= alpha * q(i);
+						z(i) = diag.inverseDiagonal( i) * resid(i);
+						sums[0] += resid(i) * resid(i);
+						sums[1] += resid(i) * z(i);
+					}
+					partials.reduce( sums, t, numThreads, round++);
+					residAbs = std::sqrt( sums[0]);
+					residDotZ = sums[1];
+				}
+			}
+		}
+
+		// Evaluating the elements from first to last of
+		// a vector expression by the lazy function objects of
+		// the calling thread for the SIMD extension SimdTag
+		template < typename Expr, typename VecType, typename SimdTag >
+		static void assignRows( const Expr & expr, VecType & lhs,
+								int first, int last, const SimdTag &)
+		{
+			DLA::VecExprMemo memo;
+			auto lazyExpr =
+				DLA::VecLazyGrammar< SimdTag >()( expr, expr, memo);
+			for (int i = first; i < last; i++)
+				lhs(i) = DLA::VecExprGrammar()( lazyExpr( i) );
+		}
+
+		// Every vector operation is a kernel of its own.
+		template < typename BType, typename GuessType, typename LhsType >
+		void solveByKernels( const BType & b,
+					const GuessType & iniGuess,
+					LhsType & lhs,
+					const double convgergenceCriterion,
+					const int maxIter,
+					ConjugateGradientWorkspace & ws) const
+		{
+			ws.reserve( b.columnSize());
+			DLA::Vector & resid = ws.resid, & z = ws.z,
+					& q = ws.q, & p = ws.p;
 
 			resid = b - coeff * iniGuess;
 			z = precond.solve( resid);
 			double rho = resid.dot( z);
 
-			DLA::Vector p = z;
+			p = z;
 			q = coeff * p;
 			double alpha = rho / p.dot(q);
 
-			lhs = iniGuess + alpha * p;
-			resid -= alpha * q;
+			// The updates of the solution and the residual are fused
+			// with the norm of the residual into a single loop.
+			double residAbs = std::get< 2 >( DLA::fuse(
+					DLA::deferred( lhs) = iniGuess + alpha * p,
+					DLA::deferred( resid) -= alpha * q,
+					DLA::norm2( resid) ) );
 
 			const double bAbs = b.abs();
 			for (int iter = 0;
 					iter < maxIter &&
-					resid.abs() / bAbs >  convgergenceCriterion ;
+					residAbs / bAbs >  convgergenceCriterion ;
 					iter++ )
 			{
 				z = precond.solve( resid);
@@ -116,10 +473,211 @@ namespace SparseLinAlg {
 
 				q = coeff * p;
 				alpha = rho / p.dot(q);
-				lhs += alpha * p;
-				resid -= alpha * q;
+				residAbs = std::get< 2 >( DLA::fuse(
+						DLA::deferred( lhs) += alpha * p,
+						DLA::deferred( resid) -= alpha * q,
+						DLA::norm2( resid) ) );
+			}
+
+		}
+	};
+
+
+	// Temporary multivectors and per-system scalars of
+	// the block conjugate gradient method,
+	// which are kept between solves of the same problem size.
+	class BlockConjugateGradientWorkspace
+	{
+	private :
+		int sz, numVecs;
+
+	public :
+		DLA::MultiVector resid, z, q, p;
+		DLA::DiagonalMatrix alpha, beta;
+		DLA::Vector rho, prevRho, pq, residAbs, bAbs;
+
+		explicit BlockConjugateGradientWorkspace( int problemSize = 0,
+												int numSystems = 1) :
+			sz( problemSize), numVecs( numSystems),
+			resid( problemSize, numSystems), z( problemSize, numSystems),
+			q( problemSize, numSystems), p( problemSize, numSystems),
+			alpha( numSystems), beta( numSystems), rho( numSystems),
+			prevRho( numSystems), pq( numSystems), residAbs( numSystems),
+			bAbs( numSystems) {}
+
+		int size() const { return sz; }
+		int numSystems() const { return numVecs; }
+
+		// Reallocating only if the problem size or
+		// the number of systems is changed
+		void reserve( int problemSize, int numSystems)
+		{
+			if ( problemSize == sz && numSystems == numVecs ) return;
+			sz = problemSize;
+			numVecs = numSystems;
+			DLA::MultiVector( sz, numVecs).swap( resid);
+			DLA::MultiVector( sz, numVecs).swap( z);
+			DLA::MultiVector( sz, numVecs).swap( q);
+			DLA::MultiVector( sz, numVecs).swap( p);
+			DLA::DiagonalMatrix( numVecs).swap( alpha);
+			DLA::DiagonalMatrix( numVecs).swap( beta);
+			DLA::Vector( numVecs).swap( rho);
+			DLA::Vector( numVecs).swap( prevRho);
+			DLA::Vector( numVecs).swap( pq);
+			DLA::Vector( numVecs).swap( residAbs);
+			DLA::Vector( numVecs).swap( bAbs);
+		}
+
+		// Peak memory of the workspace for the problem size
+		static std::size_t bytes( int problemSize, int numSystems)
+		{
+			return ( 4 * std::size_t( problemSize) + 7 ) *
+					sizeof( double) * std::size_t( numSystems);
+		}
+	};
+
+
+	// Conjugate gradient method advancing numSystems linear systems
+	// with the same coefficient matrix together.
+	//
+	// The right hand sides and the solutions are the vectors of
+	// multivectors, so that every matrix multivector multiplication
+	// reads the matrix once for all the systems.
+	// The systems are independent of each other; every system has
+	// its own step sizes, and stops being updated once it converges.
+	//
+	// The solves without a workspace argument use the workspace of
+	// this solver, and thus are not thread-safe; the threads solving
+	// with the same solver at once should pass their own workspaces.
+	template <typename MatType, typename PreType>
+	class BlockConjugateGradient
+	{
+	private :
+		const MatType & coeff;
+		const PreType & precond;
+
+		// The workspace is owned by this solver unless it is passed in,
+		// and is pointed to by workspacePtr in either case.
+		const std::unique_ptr< BlockConjugateGradientWorkspace > ownedWorkspace;
+		BlockConjugateGradientWorkspace * const workspacePtr;
+
+		// Updating the step sizes of the systems not converged yet,
+		// and returning whether all the systems are converged.
+		static bool updateConvergence( BlockConjugateGradientWorkspace & ws,
+										const double convgergenceCriterion)
+		{
+			bool converged = true;
+			for (int j = 0; j < ws.numSystems(); j++) {
+				if ( ws.residAbs(j) / ws.bAbs(j) > convgergenceCriterion ) {
+					converged = false;
+				} else {
+					ws.alpha(j) = 0.0;
+					ws.beta(j) = 0.0;
+				}
 			}
+			return converged;
+		}
+
+	public :
+		explicit BlockConjugateGradient(const MatType & coefficients,
+				const PreType & preconditioner ) :
+				coeff( coefficients), precond( preconditioner),
+				ownedWorkspace( new BlockConjugateGradientWorkspace(
+									coefficients.rowSize() ) ),
+				workspacePtr( ownedWorkspace.get() ) {}
+
+		explicit BlockConjugateGradient(const MatType & coefficients,
+				const PreType & preconditioner,
+				BlockConjugateGradientWorkspace & externalWorkspace) :
+				coeff( coefficients), precond( preconditioner),
+				workspacePtr( &externalWorkspace) {}
+
+		// A copy shares the workspace passed in, or
+		// owns a new workspace of the same size.
+		BlockConjugateGradient( const BlockConjugateGradient & solver) :
+				coeff( solver.coeff), precond( solver.precond),
+				ownedWorkspace( solver.ownedWorkspace ?
+					new BlockConjugateGradientWorkspace(
+						solver.workspacePtr->size(),
+						solver.workspacePtr->numSystems() )
+					: nullptr ),
+				workspacePtr( ownedWorkspace ?
+					ownedWorkspace.get() : solver.workspacePtr ) {}
+
+		BlockConjugateGradient &
+		operator=( const BlockConjugateGradient & ) = delete;
+
+		// Peak memory of the temporaries for the problem size
+		static std::size_t workspaceBytes( int problemSize, int numSystems)
+		{
+			return BlockConjugateGradientWorkspace::bytes(
+					problemSize, numSystems);
+		}
+
+		void solveAndAssign( const DLA::MultiVector & b,
+					const DLA::MultiVector & iniGuess,
+					DLA::MultiVector & lhs,
+					const double convgergenceCriterion,
+					const int maxIter = std::numeric_limits<int>::max()) const
+		{
+			solveAndAssign( b, iniGuess, lhs, convgergenceCriterion, maxIter,
+							*workspacePtr);
+		}
 
+		// solving with the workspace of the caller ,
+		// which may be called by more than one thread at once
+		void solveAndAssign( const DLA::MultiVector & b,
+					const DLA::MultiVector & iniGuess,
+					DLA::MultiVector & lhs,
+					const double convgergenceCriterion,
+					const int maxIter,
+					BlockConjugateGradientWorkspace & ws) const
+		{
+			const int k = b.numVectors();
+			ws.reserve( b.size(), k);
+			DLA::MultiVector & resid = ws.resid, & z = ws.z,
+					& q = ws.q, & p = ws.p;
+			DLA::DiagonalMatrix & alpha = ws.alpha, & beta = ws.beta;
+			DLA::Vector & rho = ws.rho, & prevRho = ws.prevRho, & pq = ws.pq;
+
+			b.abs( ws.bAbs);
+
+			resid = b - coeff * iniGuess;
+			precond.solveAndAssign( resid, z);
+			resid.dot( z, rho);
+
+			p = z;
+			q = coeff * p;
+			p.dot( q, pq);
+			for (int j = 0; j < k; j++) alpha(j) = rho(j) / pq(j);
+
+			lhs = iniGuess + p * alpha;
+			resid -= q * alpha;
+
+			resid.abs( ws.residAbs);
+			for (int iter = 0;
+					iter < maxIter &&
+					! updateConvergence( ws, convgergenceCriterion);
+					iter++ )
+			{
+				precond.solveAndAssign( resid, z);
+				prevRho = rho;
+				resid.dot( z, rho);
+
+				for (int j = 0; j < k; j++)
+					// alpha(j) is zero for the converged systems
+					if ( alpha(j) != 0.0 ) beta(j) = rho(j) / prevRho(j);
+				p = z + p * beta;
+
+				q = coeff * p;
+				p.dot( q, pq);
+				for (int j = 0; j < k; j++)
+					if ( alpha(j) != 0.0 ) alpha(j) = rho(j) / pq(j);
+				lhs += p * alpha;
+				resid -= q * alpha;
+
+				resid.abs( ws.residAbs);
+			}
 		}
 	};
 
@@ -8,6 +8,8 @@
 #ifndef SPARSELINALG_PRECONDITIONER_HPP_
 #define SPARSELINALG_PRECONDITIONER_HPP_
 
+#include <algorithm>
+
 #include <ParallelizationTypeTag/Default.hpp>
 
 #include <DenseLinAlg/DenseLinAlg.hpp>
@@ -63,38 +65,167 @@ namespace SparseLinAlg {
 		const int sz;
 		double *diagInv;
 
-		template < typename MatType >
+		template < typename MatType, typename SimdTag >
 		void init( const MatType & mat,
-			const PTT::SingleProcess< PTT::SingleThread< PTT::NoSIMD > >&)
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >&)
 		{
 			for (int i = 0; i < sz; i++) diagInv[ i] = 1.0 / mat(i, i);
 		}
 
-		template < typename MatType >
+		template < typename MatType, typename SimdTag >
 		void init( const MatType & mat,
-				const PTT::SingleProcess< PTT::OpenMP< PTT::NoSIMD > >&)
+				const PTT::SingleProcess< PTT::OpenMP< SimdTag > >&)
 		{
 			#pragma omp parallel for
 			for (int i = 0; i < sz; i++) diagInv[ i] = 1.0 / mat(i, i);
 			// std::cout << "OpenMP preconditioner init" << std::endl;
 		}
 
+		template < typename MatType, typename SimdTag >
+		void init( const MatType & mat,
+				const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >&)
+		{
+			double* const d = diagInv;
+			PTT::WorkStealingPool::local().parallelForBlocks(
+				sz, DLA::SimdBlockSize, [&mat, d]( int first, int last) {
+					for (int i = first; i < last; i++) d[ i] = 1.0 / mat(i, i);
+				} );
+		}
+
+		// The kernels are selected at run time.
+		struct InitCall {
+			DiagonalPreconditioner& self;
+
+			template < typename MatType, typename ParallelizationType >
+			void operator()( const MatType& mat,
+							const ParallelizationType& pt) const {
+				self.init( mat, pt);
+			}
+		};
+
+		template < typename MatType >
+		void init( const MatType & mat,
+				const PTT::SingleProcess< PTT::Runtime >&)
+		{
+			PTT::dispatch( InitCall{ *this }, mat);
+		}
+
+		// Every process inverts the diagonal elements of its rows.
+		template < typename MatType, typename Multithreading >
+		void init( const MatType & mat,
+				const PTT::MPI< Multithreading >&)
+		{
+			init( mat, PTT::SingleProcess< Multithreading >() );
+		}
+
+		// The SIMD extension of SimdTag , or the narrower one available,
+		// multiplies a pack of the elements at a time.
+		template < typename SimdTag >
 		void _solveAndAssign(const DLA::Vector & b, DLA::Vector & lhs,
-			const PTT::SingleProcess< PTT::SingleThread< PTT::NoSIMD > >&)
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >&)
 		const
 		{
-			for (int i = 0; i < sz; i++) lhs(i) = diagInv[i] * b(i);
+			if ( sz == 0 ) return;
+			DLA::simdMultiply( &lhs(0), diagInv, &b(0), 0, sz,
+				(typename DLA::SimdOpsOf< double, SimdTag >::type*)nullptr );
 		}
 
+		template < typename SimdTag >
 		void _solveAndAssign(const DLA::Vector & b, DLA::Vector & lhs,
-			const PTT::SingleProcess< PTT::OpenMP< PTT::NoSIMD > >&)
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >&)
 		const
 		{
+			if ( sz == 0 ) return;
+			typedef typename DLA::SimdOpsOf< double, SimdTag >::type Ops;
+			const int blocks = ( sz + DLA::SimdBlockSize - 1 ) / DLA::SimdBlockSize;
+			double* const l = &lhs(0);
+			const double* const r = &b(0);
 			#pragma omp parallel for
-			for (int i = 0; i < sz; i++) lhs(i) = diagInv[i] * b(i);
+			for (int bi = 0; bi < blocks; bi++)
+				DLA::simdMultiply( l, diagInv, r, bi * DLA::SimdBlockSize,
+					std::min( sz, ( bi + 1 ) * DLA::SimdBlockSize ), (Ops*)nullptr );
 			// std::cout << "OpenMP preconditioner solve" << std::endl;
 		}
 
+		template < typename SimdTag >
+		void _solveAndAssign(const DLA::Vector & b, DLA::Vector & lhs,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >&)
+		const
+		{
+			typedef typename DLA::SimdOpsOf< double, SimdTag >::type Ops;
+			double* const l = sz > 0 ? &lhs(0) : nullptr;
+			const double* const r = sz > 0 ? &b(0) : nullptr;
+			const double* const d = diagInv;
+			PTT::WorkStealingPool::local().parallelForBlocks(
+				sz, DLA::SimdBlockSize, [l, d, r]( int first, int last) {
+					DLA::simdMultiply( l, d, r, first, last, (Ops*)nullptr );
+				} );
+		}
+
+		template < typename SimdTag >
+		void _solveAndAssign(const DLA::MultiVector & b,
+			DLA::MultiVector & lhs,
+			const PTT::SingleProcess< PTT::SingleThread< SimdTag > >&)
+		const
+		{
+			const int k = b.numVectors();
+			for (int i = 0; i < sz; i++)
+				for (int j = 0; j < k; j++) lhs(i, j) = diagInv[i] * b(i, j);
+		}
+
+		template < typename SimdTag >
+		void _solveAndAssign(const DLA::MultiVector & b,
+			DLA::MultiVector & lhs,
+			const PTT::SingleProcess< PTT::OpenMP< SimdTag > >&)
+		const
+		{
+			const int k = b.numVectors();
+			#pragma omp parallel for
+			for (int i = 0; i < sz; i++)
+				for (int j = 0; j < k; j++) lhs(i, j) = diagInv[i] * b(i, j);
+		}
+
+		template < typename SimdTag >
+		void _solveAndAssign(const DLA::MultiVector & b,
+			DLA::MultiVector & lhs,
+			const PTT::SingleProcess< PTT::ThreadPool< SimdTag > >&)
+		const
+		{
+			const int k = b.numVectors();
+			const double* const d = diagInv;
+			PTT::WorkStealingPool::local().parallelForBlocks(
+				sz, DLA::SimdBlockSize, [&b, &lhs, d, k]( int first, int last) {
+					for (int i = first; i < last; i++)
+						for (int j = 0; j < k; j++) lhs(i, j) = d[i] * b(i, j);
+				} );
+		}
+
+		struct SolveCall {
+			const DiagonalPreconditioner& self;
+
+			template < typename VecType, typename ParallelizationType >
+			void operator()( const VecType& b, VecType& lhs,
+							const ParallelizationType& pt) const {
+				self._solveAndAssign( b, lhs, pt);
+			}
+		};
+
+		template < typename VecType >
+		void _solveAndAssign(const VecType & b, VecType & lhs,
+			const PTT::SingleProcess< PTT::Runtime >&)
+		const
+		{
+			PTT::dispatch( SolveCall{ *this }, b, lhs);
+		}
+
+		template < typename VecType, typename Multithreading >
+		void _solveAndAssign(const VecType & b, VecType & lhs,
+			const PTT::MPI< Multithreading >&)
+		const
+		{
+			_solveAndAssign( b, lhs, PTT::SingleProcess< Multithreading >() );
+		}
+
 	public :
 		template < typename MatType >
 		explicit DiagonalPreconditioner(const MatType & mat) :
@@ -113,6 +244,25 @@ namespace SparseLinAlg {
 		{
 			_solveAndAssign( b, lhs, PTT::Specified());
 		}
+
+		// preconditioning by the parallelization type pt
+		template < typename ParallelizationType >
+		void solveAndAssign(const DLA::Vector & b, DLA::Vector & lhs,
+							const ParallelizationType& pt) const
+		{
+			_solveAndAssign( b, lhs, pt);
+		}
+
+		// preconditioning all the vectors of a multivector
+		void solveAndAssign(const DLA::MultiVector & b,
+							DLA::MultiVector & lhs) const
+		{
+			_solveAndAssign( b, lhs, PTT::Specified());
+		}
+
+		// the inverse of the i'th diagonal element,
+		// e.g. for preconditioning the rows of a thread
+		double inverseDiagonal( int i) const { return diagInv[ i]; }
 	};
 
 
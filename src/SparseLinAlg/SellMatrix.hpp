@@ -0,0 +1,448 @@
+/*
+ * SellMatrix.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifndef SPARSELINALG_SELLMATRIX_HPP_
+#define SPARSELINALG_SELLMATRIX_HPP_
+
+#include <algorithm>
+#include <type_traits>
+
+#include <boost/proto/proto.hpp>
+
+#include <ParallelizationTypeTag/ParallelizationTypeTag.hpp>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/CsrMatrix.hpp>
+
+
+namespace SparseLinAlg {
+
+	namespace DLA = DenseLinAlg;
+	namespace proto = boost::proto;
+	namespace PTT = ParallelizationTypeTag;
+
+
+	template < typename VecType > struct LazySellMatVecMult;
+	template < typename VecType, typename SimdTag >
+	struct LazySellWindowMatVecMult;
+
+	// Sparse matrix in the sliced ELLPACK (SELL-C-sigma) format
+	//
+	// The rows are sorted by their lengths in the descending order
+	// within every window of sigma rows, and the sorted rows are
+	// grouped into chunks of C rows. The s'th sorted row is the
+	// perm[ s ]'th row of the original matrix.
+	// A chunk is padded to its longest row and stored column-major, so that
+	// the k'th elements of the C rows of the chunk c are adjacent,
+	// val[ chunkPtr[ c ] + k * C + l ], colIdx[ chunkPtr[ c ] + k * C + l ]
+	// for 0 <= l < C . The padded elements are zeros at the column 0 .
+	//
+	// The C rows of a chunk are multiplied together by SIMD instructions
+	// if C is a multiple of their width.
+	class SellMatrix
+	{
+	private:
+		const int rowSz, colSz, chunkSz, sigma, numChunks;
+		int* perm;
+		int* slot;
+		int* chunkPtr;
+		int* colIdx;
+		double* val;
+
+		// the number of double-precision lanes of the SIMD kernels
+		static int simdLanes( void* ) { return 1; }
+		template < typename SimdTag >
+		static int simdLanes( DLA::SimdDoubleOps< SimdTag >* ) {
+			return DLA::SimdDoubleOps< SimdTag >::width;
+		}
+
+		static int roundUp( int n, int unit) {
+			return ( n + unit - 1 ) / unit * unit;
+		}
+
+		void allocateElements()
+		{
+			colIdx = DLA::DefaultAllocator::allocate< int >(
+												chunkPtr[ numChunks] );
+			val = DLA::DefaultAllocator::allocate< double >(
+												chunkPtr[ numChunks] );
+		}
+
+		// multiplying the rows of the chunk c and the vector x,
+		// y[ l ] being the product of its l'th row
+		template < typename VecType >
+		void multiplyChunk( int c, const VecType& x, double* y, void* ) const
+		{
+			for (int l = 0; l < chunkSz; l++) {
+				double elm = 0.0;
+				for (int k = chunkPtr[c] + l; k < chunkPtr[c + 1]; k += chunkSz)
+					elm += val[k] * x( colIdx[k]);
+				y[l] = elm;
+			}
+		}
+
+		// The rows are multiplied a register at a time
+		// by the kernel of the SIMD extension,
+		// in the same order as the scalar code.
+		template < typename SimdTag >
+		void multiplyChunk( int c, const DLA::Vector& x, double* y,
+							DLA::SimdDoubleOps< SimdTag >* ) const
+		{
+			typedef DLA::SimdDoubleOps< SimdTag > Ops;
+			if ( chunkSz % Ops::width != 0 ) {
+				multiplyChunk( c, x, y, (void*)nullptr );
+				return;
+			}
+			Ops::multiplySlice( y, val + chunkPtr[c], colIdx + chunkPtr[c],
+				&x(0), chunkSz, chunkPtr[c + 1] - chunkPtr[c]);
+		}
+
+	public:
+		typedef double value_type;
+
+		// the chunk height matching the widest SIMD kernels
+		// compiled for this binary, which may be selected at run time
+		static int defaultChunkHeight() {
+			return simdLanes( (typename DLA::SimdOpsOf< double,
+									PTT::AVX512 >::type*)nullptr );
+		}
+
+		// Converting a CSR matrix.
+		// The sorting scope is rounded up to a multiple of the chunk height.
+		explicit SellMatrix( const CsrMatrix & mat,
+				int chunkHeight = defaultChunkHeight(),
+				int sortingScope = 32 * defaultChunkHeight() ) :
+			rowSz( mat.rowSz), colSz( mat.colSz), chunkSz( chunkHeight),
+			sigma( roundUp( sortingScope, chunkHeight) ),
+			numChunks( ( mat.rowSz + chunkHeight - 1 ) / chunkHeight ),
+			perm( DLA::DefaultAllocator::allocate< int >(
+												numChunks * chunkSz) ),
+			slot( DLA::DefaultAllocator::allocate< int >( rowSz) ),
+			chunkPtr( DLA::DefaultAllocator::allocate< int >( numChunks + 1) ),
+			colIdx( nullptr), val( nullptr)
+		{
+			const int* const rowPtr = mat.rowPtr;
+
+			// sorting the rows by their lengths within every window
+			for (int s = 0; s < numChunks * chunkSz; s++)
+				perm[s] = s < rowSz ? s : -1;
+			for (int begin = 0; begin < rowSz; begin += sigma)
+				std::stable_sort( perm + begin,
+					perm + std::min( begin + sigma, rowSz),
+					[rowPtr]( int r0, int r1) {
+						return rowPtr[r0 + 1] - rowPtr[r0] >
+								rowPtr[r1 + 1] - rowPtr[r1];
+					} );
+			for (int s = 0; s < rowSz; s++) slot[ perm[s] ] = s;
+
+			// padding every chunk to its longest row
+			chunkPtr[0] = 0;
+			for (int c = 0; c < numChunks; c++) {
+				int width = 0;
+				for (int s = c * chunkSz; s < (c + 1) * chunkSz; s++)
+					if ( perm[s] >= 0 )
+						width = std::max( width,
+								rowPtr[ perm[s] + 1] - rowPtr[ perm[s] ] );
+				chunkPtr[c + 1] = chunkPtr[c] + width * chunkSz;
+			}
+
+			allocateElements();
+			for (int c = 0; c < numChunks; c++)
+				for (int k = chunkPtr[c]; k < chunkPtr[c + 1]; k++) {
+					const int s = c * chunkSz + ( k - chunkPtr[c] ) % chunkSz,
+							e = ( k - chunkPtr[c] ) / chunkSz;
+					const int r = perm[s];
+					if ( r >= 0 && e < rowPtr[r + 1] - rowPtr[r] ) {
+						colIdx[k] = mat.colIdx[ rowPtr[r] + e];
+						val[k] = mat.val[ rowPtr[r] + e];
+					} else {
+						colIdx[k] = 0;
+						val[k] = 0.0;
+					}
+				}
+		}
+
+		SellMatrix( const SellMatrix & mat) :
+			rowSz( mat.rowSz), colSz( mat.colSz), chunkSz( mat.chunkSz),
+			sigma( mat.sigma), numChunks( mat.numChunks),
+			perm( DLA::DefaultAllocator::allocate< int >(
+												numChunks * chunkSz) ),
+			slot( DLA::DefaultAllocator::allocate< int >( rowSz) ),
+			chunkPtr( DLA::DefaultAllocator::allocate< int >( numChunks + 1) ),
+			colIdx( nullptr), val( nullptr)
+		{
+			for (int s = 0; s < numChunks * chunkSz; s++) perm[s] = mat.perm[s];
+			for (int ri = 0; ri < rowSz; ri++) slot[ri] = mat.slot[ri];
+			for (int c = 0; c <= numChunks; c++) chunkPtr[c] = mat.chunkPtr[c];
+
+			allocateElements();
+			for (int k = 0; k < chunkPtr[ numChunks]; k++) {
+				colIdx[k] = mat.colIdx[k];
+				val[k] = mat.val[k];
+			}
+		}
+
+		SellMatrix& operator=( const SellMatrix & ) = delete;
+
+		~SellMatrix()
+		{
+			DLA::DefaultAllocator::deallocate( val);
+			DLA::DefaultAllocator::deallocate( colIdx);
+			DLA::DefaultAllocator::deallocate( chunkPtr);
+			DLA::DefaultAllocator::deallocate( slot);
+			DLA::DefaultAllocator::deallocate( perm);
+		}
+
+		int rowSize() const { return rowSz; }
+		int columnSize() const { return colSz; }
+		int chunkHeight() const { return chunkSz; }
+		int sortingScope() const { return sigma; }
+
+		// the number of the stored elements including the padded zeros
+		int storedSize() const { return chunkPtr[ numChunks]; }
+
+		// Interleaving the pages of the arrays across the NUMA nodes,
+		// since the matrix is converted by a thread.
+		// Returning false if the NUMA policy is not supported.
+		bool interleave() const {
+			return DLA::interleavePages( perm, numChunks * chunkSz)
+				&& DLA::interleavePages( slot, rowSz)
+				&& DLA::interleavePages( chunkPtr, numChunks + 1)
+				&& DLA::interleavePages( colIdx, storedSize() )
+				&& DLA::interleavePages( val, storedSize() );
+		}
+
+		// accessing to a matrix element,
+		// which is zero if it is not stored.
+		double operator()(int ri, int ci) const
+		{
+			const int c = slot[ri] / chunkSz, l = slot[ri] % chunkSz;
+			double elm = 0.0;
+			for (int k = chunkPtr[c] + l; k < chunkPtr[c + 1]; k += chunkSz)
+				if ( colIdx[k] == ci ) elm += val[k];
+			return elm;
+		}
+
+		// the number of the windows of the sorted rows
+		int numWindows() const { return ( rowSz + sigma - 1 ) / sigma; }
+
+		// Multiplying the rows of the w'th window and the vector x
+		// by the kernels of the SIMD extension SimdTag .
+		// The product of the row at the position p of the window
+		// is stored in y[ p ] .
+		template < typename VecType, typename SimdTag >
+		void multiplyWindow( int w, const VecType& x, double* y,
+							const SimdTag& ) const
+		{
+			const int cBegin = w * sigma / chunkSz,
+					cEnd = std::min( ( w + 1 ) * sigma / chunkSz, numChunks);
+			for (int c = cBegin; c < cEnd; c++)
+				multiplyChunk( c, x, y + ( c - cBegin ) * chunkSz,
+					(typename DLA::SimdOpsOf< double, SimdTag >::type*)nullptr );
+		}
+
+		// Multiplying this matrix and the vector x into y
+		// by the SIMD instructions specified by simd
+		template < typename VecType, typename SimdTag >
+		void multiply( const VecType& x, DLA::Vector& y,
+						const SimdTag& simd) const
+		{
+			DLA::Vector windowResult( sigma);
+			for (int w = 0; w < numWindows(); w++) {
+				multiplyWindow( w, x, &windowResult(0), simd);
+				const int end = std::min( ( w + 1 ) * sigma, rowSz);
+				for (int s = w * sigma; s < end; s++)
+					y( perm[s] ) = windowResult( s - w * sigma);
+			}
+		}
+
+		template < typename VecType > friend struct LazySellMatVecMult;
+		template < typename VecType, typename SimdTag >
+		friend struct LazySellWindowMatVecMult;
+		friend struct DLA::TransposedMatVecKernel< SellMatrix >;
+	};
+
+
+	// Lazy function object for evaluating an element of
+	// the resultant vector from the multiplication of
+	// a SELL matrix and a vector.
+	//
+	// An expression like ( sellMatrix * vector )(index) is transformed
+	// into the loop over the elements of the index'th row in its chunk.
+	template < typename VecType >
+	struct LazySellMatVecMult
+	{
+		SellMatrix const& m;
+		VecType const& v;
+
+		typedef typename DLA::PromotedScalar< double,
+				typename VecType::value_type >::type result_type;
+
+		explicit LazySellMatVecMult(SellMatrix const& mat,
+									VecType const& vec) :
+			m( mat), v( vec) {}
+
+		LazySellMatVecMult( LazySellMatVecMult const& lazy) :
+			m(lazy.m), v(lazy.v) {}
+
+		result_type operator()(int index) const
+		{
+			const int c = m.slot[index] / m.chunkSz,
+					l = m.slot[index] % m.chunkSz;
+			result_type elm = 0.0;
+			for (int k = m.chunkPtr[c] + l; k < m.chunkPtr[c + 1];
+					k += m.chunkSz)
+				elm += m.val[k] * v( m.colIdx[k]);
+			return elm;
+		}
+	};
+
+
+	// Callable transform object to make the lazy functor
+	// a proto exression for lazily evaluationg the multiplication
+	// of a SELL matrix and a vector .
+	struct SellMatVecMult : proto::callable
+	{
+		template < typename Sig > struct result;
+
+		template < typename This, typename MatType, typename VecType >
+		struct result< This( MatType, VecType) >
+		{
+			typedef typename proto::terminal< LazySellMatVecMult<
+				typename boost::remove_const<
+					typename boost::remove_reference< VecType >::type
+				>::type
+			> >::type type;
+		};
+
+		template < typename VecType >
+		typename proto::terminal< LazySellMatVecMult< VecType > >::type
+		operator()( SellMatrix const& mat, VecType const& vec) const
+		{
+			return proto::as_expr( LazySellMatVecMult< VecType >(mat, vec) );
+		}
+	};
+
+
+	// Lazy function object for evaluating an element of
+	// the resultant vector from the multiplication of
+	// a SELL matrix and a vector, a window at a time.
+	//
+	// The whole window containing the requested element is computed
+	// by the kernel of the chunks for the SIMD extension SimdTag ,
+	// that of the kernel evaluating the expression, and kept
+	// until an element of another window is requested.
+	// Every thread should make its own object.
+	template < typename VecType, typename SimdTag >
+	struct LazySellWindowMatVecMult
+	{
+		SellMatrix const& m;
+		VecType const& v;
+		// the first sorted row of the cached window
+		mutable int cachedBegin;
+		mutable DLA::Vector windowCache;
+
+		typedef double result_type;
+
+		explicit LazySellWindowMatVecMult(SellMatrix const& mat,
+											VecType const& vec) :
+			m( mat), v( vec), cachedBegin( - mat.sigma),
+			windowCache( mat.sigma) {}
+
+		LazySellWindowMatVecMult( LazySellWindowMatVecMult const& lazy) :
+			m( lazy.m), v( lazy.v), cachedBegin( - lazy.m.sigma),
+			windowCache( lazy.m.sigma) {}
+
+		result_type operator()(int index) const
+		{
+			const int s = m.slot[index];
+			if ( s < cachedBegin || s >= cachedBegin + m.sigma ) {
+				const int w = s / m.sigma;
+				m.multiplyWindow( w, v, &windowCache(0), SimdTag() );
+				cachedBegin = w * m.sigma;
+			}
+			return windowCache( s - cachedBegin);
+		}
+	};
+
+
+	// Callable transform object to make the lazy functor
+	// a proto exression for evaluationg the multiplication
+	// of a SELL matrix and a vector a window at a time
+	// by the kernels of the SIMD extension given last.
+	struct SellWindowMatVecMult : proto::callable
+	{
+		template < typename Sig > struct result;
+
+		template < typename This, typename MatType, typename VecType,
+					typename SimdTag >
+		struct result< This( MatType, VecType, SimdTag) >
+		{
+			typedef typename proto::terminal< LazySellWindowMatVecMult<
+				typename boost::remove_const<
+					typename boost::remove_reference< VecType >::type
+				>::type,
+				typename std::decay< SimdTag >::type
+			> >::type type;
+		};
+
+		template < typename VecType, typename SimdTag >
+		typename proto::terminal<
+			LazySellWindowMatVecMult< VecType, SimdTag > >::type
+		operator()( SellMatrix const& mat, VecType const& vec,
+					const SimdTag& ) const
+		{
+			return proto::as_expr(
+				LazySellWindowMatVecMult< VecType, SimdTag >(mat, vec) );
+		}
+	};
+
+}
+
+
+namespace DenseLinAlg {
+
+	template<> struct IsExpr< SparseLinAlg::SellMatrix > : mpl::true_  {};
+
+	// Scattering the chunks of a SELL matrix
+	// for the product of its transpose and a vector.
+	// The padded rows are skipped, while the padded zeros are added.
+	template<>
+	struct TransposedMatVecKernel< SparseLinAlg::SellMatrix >
+	{
+		static int blocks( const SparseLinAlg::SellMatrix& m) {
+			return m.numChunks;
+		}
+
+		template < typename VecType, typename Scalar >
+		static void add( const SparseLinAlg::SellMatrix& m,
+						int first, int last, const VecType& x, Scalar* y)
+		{
+			for (int c = first; c < last; c++)
+				for (int l = 0; l < m.chunkSz; l++) {
+					const int r = m.perm[ c * m.chunkSz + l];
+					if ( r < 0 ) continue;
+					const typename VecType::value_type xr = x( r);
+					for (int k = m.chunkPtr[c] + l; k < m.chunkPtr[c + 1];
+							k += m.chunkSz)
+						y[ m.colIdx[k] ] += m.val[k] * xr;
+				}
+		}
+	};
+
+	template< typename VecType >
+	struct IsExpr< SparseLinAlg::LazySellMatVecMult< VecType > >
+		: mpl::true_  {};
+
+	template< typename VecType, typename SimdTag >
+	struct IsExpr< SparseLinAlg::LazySellWindowMatVecMult< VecType, SimdTag > >
+		: mpl::true_  {};
+
+}
+
+
+#endif /* SPARSELINALG_SELLMATRIX_HPP_ */
@@ -9,6 +9,9 @@
 #define SPARSELINALG_SPARSELINALG_HPP_
 
 
+#include <SparseLinAlg/CsrMatrix.hpp>
+#include <SparseLinAlg/BandedMatrix.hpp>
+#include <SparseLinAlg/SellMatrix.hpp>
 #include <SparseLinAlg/IterSolver.hpp>
 #include <SparseLinAlg/Preconditioner.hpp>
 
@@ -0,0 +1,156 @@
+/*
+ * benchmarkingSimdVecExprs.cpp
+ *
+ *  Evaluating the vector expressions and the reductions
+ *  by the SIMD extensions of the tags NoSIMD, SSE2, AVX and AVX512,
+ *  falling back to the narrower ones unless the compiler enables them.
+ *  The maps and the map-reductions should be equal to
+ *  those of the scalar code, and the dot products and the norms
+ *  should be so up to the rounding errors.
+ *  The maps of the views of every second element, whose packs are
+ *  gathered, should be equal to those of the vectors.
+ *  The elapsed time of each tag is measured.
+ *  The map-reductions are evaluated by the scalar code for any tag,
+ *  since their matrix vector products are evaluated element by element.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/SparseLinAlg.hpp>
+
+#include "vectorDifference.hpp"
+
+namespace DLA = DenseLinAlg;
+namespace SLA = SparseLinAlg;
+namespace PTT = ParallelizationTypeTag;
+
+#ifdef _OPENMP
+template < typename SimdTag >
+struct Multithreaded { typedef PTT::OpenMP< SimdTag > type; };
+#else
+template < typename SimdTag >
+struct Multithreaded { typedef PTT::SingleThread< SimdTag > type; };
+#endif
+
+const int NumRepeat = 200;
+
+// The function is called through std::function , so that
+// the compiler does not hoist the evaluations out of the loop.
+double milliseconds( const std::function< void() >& f)
+{
+	auto start = std::chrono::system_clock::now();
+	for (int n = 0; n < NumRepeat; n++) f();
+	auto end = std::chrono::system_clock::now();
+	return double( std::chrono::duration_cast< std::chrono::microseconds >(
+						end - start ).count() ) / 1000.0;
+}
+
+// assigning expr into lhs by the parallelization type pt
+template < typename Expr, typename ParallelizationType >
+void assign( const Expr& expr, DLA::Vector& lhs,
+			const ParallelizationType& pt)
+{
+	DLA::AssignVecExpr< DLA::AssignFunctor >()(
+		expr, DLA::VecExprTagGrammar()( expr), lhs, pt);
+}
+
+// Each of the expressions is evaluated by the SIMD extension of SimdTag
+// and compared with the scalar code.
+template < typename SimdTag >
+void benchmark( const char* name, const DLA::Vector& x, const DLA::Vector& z,
+				const DLA::VectorView& strided, const SLA::BandedMatrix& a,
+				const SLA::DiagonalPreconditioner& precond)
+{
+	typedef PTT::SingleProcess< typename Multithreaded< SimdTag >::type > PT;
+	typedef PTT::SingleProcess< typename Multithreaded< PTT::NoSIMD >::type >
+		ScalarPT;
+	const int sz = x.size();
+	DLA::Vector y( sz), ref( sz);
+
+	// map
+	const double two = 2.0, half = 0.5;
+	assign( two * x + z - x * half, ref, ScalarPT() );
+	const double mapTime = milliseconds( [&]() {
+		assign( two * x + z - x * half, y, PT() );
+	} );
+	const double mapDiff = maxDiff( y, ref);
+
+	// map of a strided view, whose elements are those of x
+	assign( two * strided + z, y, PT() );
+	assign( two * x + z, ref, ScalarPT() );
+	const double stridedDiff = maxDiff( y, ref);
+
+	// map-reduce, whose matrix vector product is gathered
+	assign( z - a * x, ref, ScalarPT() );
+	const double mapReduceTime = milliseconds( [&]() {
+		assign( z - a * x, y, PT() );
+	} );
+	const double mapReduceDiff = maxDiff( y, ref);
+
+	// dot product and norm
+	double d = 0.0, n = 0.0;
+	const double dotTime = milliseconds( [&]() { d = x.dot( z, PT() ); } );
+	const double dotError =
+		std::fabs( d - x.dot( z, ScalarPT() ) ) / std::fabs( d);
+	const double absTime = milliseconds( [&]() { n = x.abs( PT() ); } );
+	const double absError = std::fabs( n - x.abs( ScalarPT() ) ) / n;
+
+	// diagonal preconditioning
+	precond.solveAndAssign( z, ref, ScalarPT() );
+	const double precondTime = milliseconds( [&]() {
+		precond.solveAndAssign( z, y, PT() );
+	} );
+	const double precondDiff = maxDiff( y, ref);
+
+	std::cout << name << " : " << mapDiff << " " << stridedDiff << " "
+		<< mapReduceDiff << " "
+		<< ( dotError < 1.0e-12 ) << " " << ( absError < 1.0e-12 ) << " "
+		<< precondDiff << std::endl;
+	std::cout << name << " elapsed time [ms] of map = "
+		<< mapTime / NumRepeat << ", map-reduce = "
+		<< mapReduceTime / NumRepeat << ", dot = "
+		<< dotTime / NumRepeat << ", norm = "
+		<< absTime / NumRepeat << ", preconditioning = "
+		<< precondTime / NumRepeat << std::endl;
+}
+
+int main()
+{
+	// odd, so that the remainders of the packs are evaluated
+	const int sz = 200003;
+	DLA::Vector x( sz), z( sz), everyOther( 2 * sz, -1.0);
+	SLA::BandedMatrix a( sz, sz, 1, 1);
+	for (int i = 0; i < sz; i++) {
+		x(i) = std::sin( 0.001 * i);
+		everyOther( 2 * i) = x(i);
+		z(i) = std::cos( 0.002 * i) + 0.5;
+		a( i, i) = 4.0 + 0.001 * ( i % 7 );
+		if ( i > 0 ) a( i, i - 1) = -1.0;
+		if ( i < sz - 1 ) a( i, i + 1) = -1.0;
+	}
+	const SLA::DiagonalPreconditioner precond( a);
+	const DLA::VectorView strided( &everyOther(0), sz, 2);
+
+	benchmark< PTT::NoSIMD >( "NoSIMD", x, z, strided, a, precond);
+	// NoSIMD : 0 0 0 1 1 0
+	benchmark< PTT::SSE2 >( "SSE2", x, z, strided, a, precond);
+	// SSE2 : 0 0 0 1 1 0
+	benchmark< PTT::AVX >( "AVX", x, z, strided, a, precond);
+	// AVX : 0 0 0 1 1 0
+	benchmark< PTT::AVX512 >( "AVX512", x, z, strided, a, precond);
+	// AVX512 : 0 0 0 1 1 0
+
+	return 0;
+}
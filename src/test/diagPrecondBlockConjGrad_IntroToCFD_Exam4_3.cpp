@@ -0,0 +1,156 @@
+/*
+ * diagPrecondBlockConjGrad_IntroToCFD_Exam4_3.cpp
+ *
+ * ref) H. K. Versteeg and W. Malalasekera,
+ *     "An Introduction  to Computational Fluid Dynamics,
+ *     The Finite Volume Method", 2nd Ed.
+ *     Pearson Educational Limited 1995, 2007.
+ *
+ *     Example 4.3
+ *
+ *  Solving the problem for several hot temperatures together
+ *  by the block conjugate gradient method.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include "airCooledCylinder.hpp"
+
+
+int main(int argc, char *argv[]) {
+
+	int NumCtrlVol = 5, NumMeasurement = 1, NumSystems = 3;
+	if ( argc > 1 ) NumCtrlVol = atoi( argv[1] );
+	std::cout << "The num. of grid points = " << NumCtrlVol << std::endl;
+
+	if ( argc > 2 ) NumMeasurement = atoi( argv[2] );
+	std::cout << "The num. of measurment = " << NumMeasurement << std::endl;
+
+	if ( argc > 3 ) NumSystems = atoi( argv[3] );
+	std::cout << "The num. of systems = " << NumSystems << std::endl;
+
+	double elapsedTimeSum = 0.0;
+
+	for (int iM = 0; iM < NumMeasurement; iM++ ) {
+
+		// tridiagonal coefficients in the CSR format
+		SLA::CsrMatrix coeffMat( NumCtrlVol, NumCtrlVol, 3 * NumCtrlVol - 2);
+
+		double deltaX = CylinderLength / NumCtrlVol,
+				deltaDirichlet = deltaX / 2.0;
+
+		const double scale = - ThermalConductivity * Area;
+
+		const double nSqr =  ConvectiveHeatTransCoeff * Circumference /
+							( ThermalConductivity * Area );
+
+		const double diagFirst = ( 1.0 / deltaDirichlet // Dirichlet condition term
+						  + 1.0 / deltaX + nSqr * deltaX ) * scale;
+
+		const double diagLast = ( 2.0 / deltaX
+				  - 1.0 / deltaX // Neumann condition term
+				  + nSqr * deltaX ) * scale;
+
+		const double diagInner = ( 2.0 / deltaX + nSqr * deltaX) * scale,
+				offDiag = - 1.0 / deltaX * scale;
+
+		coeffMat.insert( 0, 0, diagFirst);
+		coeffMat.insert( 0, 1, offDiag);
+
+		int i;
+		for (i = 1; i < NumCtrlVol-1; i++) {
+			coeffMat.insert( i, i-1, offDiag);
+			coeffMat.insert( i, i, diagInner);
+			coeffMat.insert( i, i+1, offDiag);
+		}
+
+		coeffMat.insert( NumCtrlVol-1, NumCtrlVol-2, offDiag);
+		coeffMat.insert( NumCtrlVol-1, NumCtrlVol-1, diagLast);
+		coeffMat.assemble();
+
+		// The j'th system has the hot temperature of HotTemperature * (j+1) .
+		DLA::MultiVector rhsVecs( NumCtrlVol, NumSystems);
+
+		for (int j = 0; j < NumSystems; j++) {
+			rhsVecs(0, j) = ( 2.0 / deltaX * HotTemperature * (j + 1)
+						  + nSqr * deltaX * AmbientTemperature ) * scale;
+			for (i = 1; i < NumCtrlVol; i++)
+				rhsVecs( i, j) = nSqr * deltaX * AmbientTemperature * scale;
+		}
+
+		SLA::DiagonalPreconditioner precond( coeffMat);
+		SLA::BlockConjugateGradient< SLA::CsrMatrix,
+						SLA::DiagonalPreconditioner > cg( coeffMat, precond);
+
+		const DLA::MultiVector tempGuess( NumCtrlVol, NumSystems,
+											(100.0 + 20.0) / 2.0);
+
+		DLA::MultiVector temperatures( NumCtrlVol, NumSystems);
+
+		// Measuring the elapsed time of our conjugate gradient procedure
+		auto start = std::chrono::system_clock::now();
+
+		cg.solveAndAssign( rhsVecs, tempGuess, temperatures,
+							convergenceCriterion);
+
+		auto end = std::chrono::system_clock::now();
+		auto diff = end - start;
+
+		elapsedTimeSum +=
+			double( std::chrono::duration_cast<std::chrono::milliseconds>
+														(diff).count() );
+
+		if ( NumMeasurement < 2 ) {
+			std::cout << "# stationary temperature distributions" << std::endl;
+			std::cout << "#     x      FVM       exact " << std::endl;
+			for (int j = 0; j < NumSystems; j++) {
+				ExactTempDist exactDist(CylinderLength,
+							AmbientTemperature, HotTemperature * (j + 1),
+							ThermalConductivity, Area,
+							ConvectiveHeatTransCoeff, Circumference);
+
+				std::cout << "# HotTemperature = " << std::fixed <<
+						std::setprecision(1) <<
+						HotTemperature * (j + 1) << std::endl;
+				for (i = 0; i < NumCtrlVol; i++) {
+					double x = CylinderLength / NumCtrlVol * (i + 0.5);
+					std::cout << std::setw( 8) << std::fixed <<
+							std::setprecision(2) << x;
+					std::cout << std::setw(10) << std::fixed <<
+							std::setprecision(3) << temperatures( i, j);
+					std::cout << std::setw(10) << std::fixed <<
+							std::setprecision(3) << exactDist( x) << std::endl;
+				}
+			}
+
+			// The residuals should be almost zero,
+			// below the convergence criterion.
+			DLA::MultiVector resid( NumCtrlVol, NumSystems);
+			resid = rhsVecs - coeffMat * temperatures;
+
+			DLA::Vector residAbs( NumSystems), rhsAbs( NumSystems);
+			resid.abs( residAbs);
+			rhsVecs.abs( rhsAbs);
+			std::cout << "# relative residuals, converged" << std::endl;
+			for (int j = 0; j < NumSystems; j++)
+				std::cout << std::scientific << std::setprecision(2) <<
+						residAbs(j) / rhsAbs(j) << " " <<
+						( residAbs(j) / rhsAbs(j) < convergenceCriterion) <<
+						std::endl;
+			std::cout << std::fixed << std::setprecision(3);
+		}
+	}
+
+	std::cout << std::endl;
+	std::cout << "elapsed time of block conjugate gradient = "
+	  << elapsedTimeSum / NumMeasurement
+	  << " msec."
+	  << std::endl;
+
+	return 0;
+}
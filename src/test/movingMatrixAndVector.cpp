@@ -0,0 +1,70 @@
+/*
+ * movingMatrixAndVector.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#include <iostream>
+#include <utility>
+#include <boost/proto/proto.hpp>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+
+namespace DLA = DenseLinAlg;
+
+// A factory function returning a vector without copying its buffer
+DLA::Vector makeVector( double v0, double v1, double v2)
+{
+	DLA::Vector vec(3);
+	vec(0) = v0; vec(1) = v1; vec(2) = v2;
+	return vec;
+}
+
+int main()
+{
+	DLA::Vector a = makeVector( 1.0, 2.0, 3.0),
+				b = makeVector( 4.0, 5.0, 6.0);
+
+	swap( a, b);
+
+	// The results should be ( 4, 5, 6) and ( 1, 2, 3).
+	std::cout << a(0) << " " << a(1) << " " << a(2) << std::endl;
+	std::cout << b(0) << " " << b(1) << " " << b(2) << std::endl;
+
+	DLA::Vector c( std::move( a));
+	a = std::move( b);
+
+	// The results should be ( 4, 5, 6) and ( 1, 2, 3) and 0.
+	std::cout << c(0) << " " << c(1) << " " << c(2) << std::endl;
+	std::cout << a(0) << " " << a(1) << " " << a(2) << std::endl;
+	std::cout << b.size() << std::endl;
+
+	// The results should be 0 and 0 for the empty vector.
+	std::cout << b.dot( b) << " " << b.abs() << std::endl;
+
+	// copying into a vector of another size.
+	// The result should be 3 and ( 4, 5, 6).
+	DLA::Vector d(5, 0.0);
+	d = c;
+	std::cout << d.size() << " " <<
+			d(0) << " " << d(1) << " " << d(2) << std::endl;
+
+	DLA::DiagonalMatrix diag(3);
+	diag(0) = 1.0; diag(1) = 2.0; diag(2) = 3.0;
+
+	DLA::DiagonalMatrix diagCopied( diag);
+	diag(0) = 10.0;
+
+	// The result should be 1 and 10.
+	std::cout << diagCopied(0) << " " << diag(0) << std::endl;
+
+	DLA::Matrix mat(2, 2, 1.0), matMoved(1, 1);
+	matMoved = std::move( mat);
+
+	// The result should be 2 2 1.
+	std::cout << matMoved.rowSize() << " " << matMoved.columnSize() << " " <<
+			matMoved(1, 1) << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,175 @@
+/*
+ * runtimeDispatchingKernels.cpp
+ *
+ *  Evaluating the vector expressions, the reductions, the matrix vector
+ *  and matrix matrix products and the preconditioner
+ *  by the kernels selected at run time,
+ *  which should agree with those of the scalar code
+ *  up to the rounding errors.
+ *  The program is compiled without the options enabling
+ *  the SIMD extensions, so that its kernels of all the extensions
+ *  are selected by the processor running it.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#include <ParallelizationTypeTag/Runtime.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <tuple>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/SparseLinAlg.hpp>
+
+namespace DLA = DenseLinAlg;
+namespace SLA = SparseLinAlg;
+namespace PTT = ParallelizationTypeTag;
+
+typedef PTT::SingleProcess< PTT::SingleThread< PTT::NoSIMD > > ScalarPT;
+
+bool close( double a, double b)
+{
+	return std::fabs( a - b) <= 1.0e-12 * std::max( 1.0, std::fabs( b) );
+}
+
+bool close( const DLA::Vector& a, const DLA::Vector& b)
+{
+	for (int i = 0; i < a.size(); i++)
+		if ( ! close( a(i), b(i)) ) return false;
+	return true;
+}
+
+bool close( const DLA::Matrix& a, const DLA::Matrix& b)
+{
+	for (int ri = 0; ri < a.rowSize(); ri++)
+		for (int ci = 0; ci < a.columnSize(); ci++)
+			if ( ! close( a( ri, ci), b( ri, ci)) ) return false;
+	return true;
+}
+
+// The kernels of the target are compared with the scalar code.
+void check( const PTT::RuntimeTarget& target,
+			const DLA::Vector& x, const DLA::Vector& z,
+			const SLA::BandedMatrix& a,
+			const SLA::DiagonalPreconditioner& precond,
+			const DLA::Matrix& pre, const DLA::Matrix& post)
+{
+	PTT::setRuntimeTarget( target);
+	const int sz = x.size();
+	DLA::Vector y( sz), ref( sz);
+
+	// map and map-reduce
+	y = 2.0 * x + z;
+	DLA::AssignVecExpr< DLA::AssignFunctor >()(
+		2.0 * x + z, DLA::VecExprTagGrammar()( 2.0 * x + z), ref, ScalarPT() );
+	const bool map = close( y, ref);
+
+	y = z - a * x;
+	DLA::AssignVecExpr< DLA::AssignFunctor >()(
+		z - a * x, DLA::VecExprTagGrammar()( z - a * x), ref, ScalarPT() );
+	const bool mapReduce = close( y, ref);
+
+	// copy, dot product, norm and reductions
+	y = x;
+	const bool copy = close( y, x);
+	const bool dot = close( x.dot( z), x.dot( z, ScalarPT()) );
+	const bool norm = close( x.abs(), x.abs( ScalarPT()) );
+	const bool reduction = close( DLA::norm2( z - a * x), ref.abs( ScalarPT()) );
+
+	// fused update and reduction
+	DLA::Vector w( z);
+	const double fused = std::get< 1 >( DLA::fuse(
+		DLA::deferred( w) -= 0.5 * x, DLA::dot( w, x) ) );
+	ref = z - 0.5 * x;
+	const bool fusion = close( w, ref) && close( fused, ref.dot( x, ScalarPT()) );
+
+	// diagonal preconditioning
+	precond.solveAndAssign( z, y);
+	precond.solveAndAssign( z, ref, ScalarPT() );
+	const bool precondition = close( y, ref);
+
+	// matrix matrix product
+	DLA::Matrix product( pre.rowSize(), post.columnSize()),
+			refProduct( pre.rowSize(), post.columnSize());
+	product = pre * post;
+	DLA::AssignMatExpr< DLA::AssignFunctor >()( pre * post, refProduct,
+												ScalarPT() );
+	const bool gemm = close( product, refProduct);
+
+	std::cout << map << " " << mapReduce << " " << copy << " " << dot << " "
+		<< norm << " " << reduction << " " << fusion << " " << precondition
+		<< " " << gemm << std::endl;
+}
+
+int main()
+{
+	// odd, so that the remainders of the packs are evaluated
+	const int sz = 10007;
+	DLA::Vector x( sz), z( sz);
+	SLA::BandedMatrix a( sz, sz, 1, 1);
+	for (int i = 0; i < sz; i++) {
+		x(i) = std::sin( 0.001 * i);
+		z(i) = std::cos( 0.002 * i) + 0.5;
+		a( i, i) = 4.0 + 0.001 * ( i % 7 );
+		if ( i > 0 ) a( i, i - 1) = -1.0;
+		if ( i < sz - 1 ) a( i, i + 1) = -1.0;
+	}
+	const SLA::DiagonalPreconditioner precond( a);
+
+	// larger than a tile and not multiples of the register blocks
+	DLA::Matrix pre( 75, 130), post( 130, 70);
+	for (int ri = 0; ri < 75; ri++)
+		for (int k = 0; k < 130; k++)
+			pre( ri, k) = std::sin( 0.1 * ri + 0.2 * k);
+	for (int k = 0; k < 130; k++)
+		for (int ci = 0; ci < 70; ci++)
+			post( k, ci) = std::cos( 0.3 * k - 0.1 * ci);
+
+	// the target detected first
+	check( PTT::runtimeTarget(), x, z, a, precond, pre, post);
+	// 1 1 1 1 1 1 1 1 1
+
+	// every SIMD extension, single or multithreaded
+	for (int s = PTT::RuntimeNoSIMD; s <= PTT::RuntimeAVX512; s++)
+		for (int t = 1; t <= 2; t++) {
+			const PTT::RuntimeTarget target = { PTT::RuntimeSimd( s), t };
+			check( target, x, z, a, precond, pre, post);
+		}
+	// 1 1 1 1 1 1 1 1 1 ( 8 times )
+
+	// The threads of the target run only the dispatched kernels.
+	bool threadsKept = true;
+#ifdef _OPENMP
+	const int maxThreads = omp_get_max_threads();
+	const PTT::RuntimeTarget twoThreads = { PTT::RuntimeNoSIMD, 2 };
+	PTT::setRuntimeTarget( twoThreads);
+	check( PTT::runtimeTarget(), x, z, a, precond, pre, post);
+	threadsKept = omp_get_max_threads() == maxThreads;
+#else
+	check( PTT::runtimeTarget(), x, z, a, precond, pre, post);
+#endif
+	std::cout << threadsKept << std::endl;
+	// 1 1 1 1 1 1 1 1 1
+	// 1
+
+	// An extension the processor lacks is not selected.
+	const PTT::RuntimeTarget widest = { PTT::RuntimeAVX512, 2 };
+	PTT::setRuntimeTarget( widest);
+	std::cout << ( PTT::runtimeTarget().simd == PTT::detectRuntimeSimd() )
+		<< std::endl;
+	// 1
+
+	// The environment variables override the detected target.
+	setenv( "PTT_SIMD", "nosimd", 1);
+	setenv( "PTT_THREADS", "2", 1);
+	const PTT::RuntimeTarget overridden = PTT::detectRuntimeTarget();
+	std::cout << PTT::runtimeSimdName( overridden.simd) << " "
+		<< overridden.threads << std::endl;
+	// nosimd 2 ( nosimd 1 without OpenMP )
+
+	return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * solvingConjGradInParallelRegion.cpp
+ *
+ *  Solving a diagonally dominant tridiagonal system by
+ *  the conjugate gradient method in a single OpenMP parallel region,
+ *  and by a kernel per vector operation.
+ *  Both should converge to the same solution
+ *  for any number of the threads.
+ *  The elapsed time of each is measured.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/SparseLinAlg.hpp>
+
+#include "vectorDifference.hpp"
+
+namespace DLA = DenseLinAlg;
+namespace SLA = SparseLinAlg;
+namespace PTT = ParallelizationTypeTag;
+
+typedef SLA::ConjugateGradient< SLA::BandedMatrix,
+								SLA::DiagonalPreconditioner > Solver;
+
+const int NumRepeat = 20;
+
+// solving NumRepeat times by the parallelization type pt,
+// returning the elapsed time [ms] of a solve
+template < typename ParallelizationType >
+double solve( const Solver& cg, const DLA::Vector& b,
+			const DLA::Vector& guess, DLA::Vector& x,
+			const ParallelizationType& pt)
+{
+	auto start = std::chrono::system_clock::now();
+	for (int n = 0; n < NumRepeat; n++)
+		cg.solveAndAssign( b, guess, x, 1.0e-10, 1000, pt);
+	auto end = std::chrono::system_clock::now();
+	return double( std::chrono::duration_cast< std::chrono::microseconds >(
+						end - start ).count() ) / 1000.0 / NumRepeat;
+}
+
+int main()
+{
+	const int sz = 100001;
+	SLA::BandedMatrix a( sz, sz, 1, 1);
+	DLA::Vector b( sz);
+	for (int i = 0; i < sz; i++) {
+		a( i, i) = 2.5 + 0.001 * ( i % 7 );
+		if ( i > 0 ) a( i, i - 1) = -1.0;
+		if ( i < sz - 1 ) a( i, i + 1) = -1.0;
+		b(i) = std::sin( 0.001 * i) + 1.0;
+	}
+	const SLA::DiagonalPreconditioner precond( a);
+	const Solver cg( a, precond);
+	const DLA::Vector guess( sz, 0.0);
+	DLA::Vector region( sz), kernels( sz), resid( sz);
+
+	// The region is run by one thread without OpenMP .
+	const int maxThreads =
+#ifdef _OPENMP
+		4;
+#else
+		1;
+#endif
+
+	for (int n = 1; n <= maxThreads; n *= 2) {
+#ifdef _OPENMP
+		omp_set_num_threads( n);
+#endif
+		const double regionTime = solve( cg, b, guess, region,
+			PTT::SingleProcess< PTT::OpenMP< PTT::NoSIMD > >() );
+		const double kernelsTime = solve( cg, b, guess, kernels,
+			PTT::SingleProcess< PTT::SingleThread< PTT::NoSIMD > >() );
+
+		resid = b - a * region;
+		std::cout << "region and kernels : " << ( maxDiff( region, kernels) < 1.0e-8 )
+			<< " " << ( resid.abs() / b.abs() < 1.0e-9 ) << std::endl;
+		std::cout << n << " threads elapsed time [ms] of region = "
+			<< regionTime << ", kernels = " << kernelsTime << std::endl;
+	}
+	// region and kernels : 1 1
+	// ( for 1, 2 and 4 threads with OpenMP )
+
+	return 0;
+}
@@ -0,0 +1,192 @@
+/*
+ * solvingDistributedConjGrad.cpp
+ *
+ *  Solving a diagonally dominant tridiagonal system by
+ *  the conjugate gradient method, whose vectors and matrix are
+ *  distributed by the rows over the MPI processes.
+ *  The dot product, the norm and the matrix vector product
+ *  of the distributed vectors should be those of the whole vectors,
+ *  and the solution should be that of the Thomas algorithm,
+ *  for any number of the processes, e.g.
+ *
+ *    mpirun -np 4 ./solvingDistributedConjGrad
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#include <ParallelizationTypeTag/MPI.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/SparseLinAlg.hpp>
+#include <SparseLinAlg/DistCsrMatrix.hpp>
+
+namespace DLA = DenseLinAlg;
+namespace SLA = SparseLinAlg;
+namespace PTT = ParallelizationTypeTag;
+
+typedef PTT::SingleProcess< PTT::SingleThread< PTT::NoSIMD > > ScalarPT;
+
+typedef SLA::ConjugateGradient< SLA::DistCsrMatrix,
+								SLA::DiagonalPreconditioner > Solver;
+
+double diagonal( int i) { return 2.5 + 0.01 * ( i % 7 ); }
+
+// solving the tridiagonal system by the Thomas algorithm
+std::vector< double > solveTridiagonal( const std::vector< double >& b)
+{
+	const int sz = int( b.size() );
+	std::vector< double > c( sz), x( b);
+	c[0] = -1.0 / diagonal( 0);
+	x[0] /= diagonal( 0);
+	for (int i = 1; i < sz; i++) {
+		const double m = diagonal( i) + c[i - 1];
+		c[i] = -1.0 / m;
+		x[i] = ( x[i] + x[i - 1] ) / m;
+	}
+	for (int i = sz - 2; i >= 0; i--) x[i] -= c[i] * x[i + 1];
+	return x;
+}
+
+int main( int argc, char* argv[])
+{
+	int provided;
+	MPI_Init_thread( &argc, &argv, MPI_THREAD_FUNNELED, &provided);
+	{
+		const int sz = 1001;
+		const SLA::RowPartition rows( sz);
+		const int first = rows.firstRow(), localSz = rows.localSize();
+		const bool root = rows.processRank() == 0;
+
+		// the rows of this process inserted by the global indices
+		SLA::DistCsrMatrix a( rows, 3 * localSz);
+		for (int i = first; i < first + localSz; i++) {
+			if ( i > 0 ) a.insert( i, i - 1, -1.0);
+			a.insert( i, i, diagonal( i));
+			if ( i < sz - 1 ) a.insert( i, i + 1, -1.0);
+		}
+		a.assemble();
+
+		// the same matrix distributed from the whole one
+		SLA::CsrMatrix whole( sz, sz, 3 * sz - 2);
+		for (int i = 0; i < sz; i++) {
+			if ( i > 0 ) whole.insert( i, i - 1, -1.0);
+			whole.insert( i, i, diagonal( i));
+			if ( i < sz - 1 ) whole.insert( i, i + 1, -1.0);
+		}
+		whole.assemble();
+		const SLA::DistCsrMatrix distributed( whole, rows);
+
+		DLA::Vector ones( localSz, 1.0), idx( localSz), b( localSz);
+		std::vector< double > wholeB( sz);
+		for (int i = 0; i < sz; i++) wholeB[i] = std::sin( 0.01 * i) + 1.0;
+		for (int i = 0; i < localSz; i++) {
+			idx(i) = first + i;
+			b(i) = wholeB[ first + i];
+		}
+
+		const double dot = ones.dot( idx), abs = ones.abs();
+		if ( root )
+			std::cout << "dot and abs : "
+				<< ( dot == 0.5 * sz * ( sz - 1 ) ) << " "
+				<< ( std::fabs( abs - std::sqrt( double( sz) ) ) < 1.0e-12 )
+				<< std::endl;
+		// dot and abs : 1 1
+
+		// The rows at the boundaries of the processes need the halos.
+		DLA::Vector y( localSz), z( localSz);
+		y = a * idx;
+		z = 2.0 * ( distributed * idx ) - y;
+		bool matVec = true;
+		for (int i = first; i < first + localSz; i++) {
+			double expected = diagonal( i) * i;
+			if ( i > 0 ) expected -= i - 1;
+			if ( i < sz - 1 ) expected -= i + 1;
+			matVec = matVec && y( i - first) == expected &&
+					z( i - first) == expected;
+		}
+		int allMatVec = matVec;
+		MPI_Allreduce( MPI_IN_PLACE, &allMatVec, 1, MPI_INT, MPI_LAND,
+						PTT::communicator() );
+		if ( root ) std::cout << "matvec : " << allMatVec << std::endl;
+		// matvec : 1
+
+		// The halos of two vectors are exchanged for an expression,
+		// and released after it is evaluated, so that the kernels
+		// without the exchange do not read them stale.
+		DLA::Vector w( localSz);
+		w = a * ones;
+		z = a * idx - a * ones;
+		int twoHalos = true;
+		for (int i = 0; i < localSz; i++)
+			twoHalos = twoHalos && z(i) == y(i) - w(i);
+		int released = a.haloSize() == 0;
+		try {
+			DLA::AssignVecExpr< DLA::AssignFunctor >()( a * idx,
+				DLA::VecExprTagGrammar()( a * idx), z, ScalarPT() );
+		} catch ( const std::logic_error& ) {
+			released = true;
+		}
+		MPI_Allreduce( MPI_IN_PLACE, &twoHalos, 1, MPI_INT, MPI_LAND,
+						PTT::communicator() );
+		MPI_Allreduce( MPI_IN_PLACE, &released, 1, MPI_INT, MPI_LAND,
+						PTT::communicator() );
+		if ( root )
+			std::cout << "halos : " << twoHalos << " " << released << std::endl;
+		// halos : 1 1
+
+		// The elements out of the rows of the process or the columns
+		// of the matrix, or beyond its local nonzero size, are rejected
+		// before assemble( ) .
+		SLA::DistCsrMatrix single( rows, 1);
+		int rejected = 0;
+		try {
+			single.insert( first + localSz, first, 1.0);
+		} catch ( const std::out_of_range& ) {
+			rejected++;
+		}
+		try {
+			single.insert( first, sz, 1.0);
+		} catch ( const std::out_of_range& ) {
+			rejected++;
+		}
+		single.insert( first, first, 1.0);
+		try {
+			single.insert( first, first + 1, 1.0);
+		} catch ( const std::length_error& ) {
+			rejected++;
+		}
+		MPI_Allreduce( MPI_IN_PLACE, &rejected, 1, MPI_INT, MPI_MIN,
+						PTT::communicator() );
+		if ( root )
+			std::cout << "rejected elements : " << rejected << std::endl;
+		// rejected elements : 3
+
+		const SLA::DiagonalPreconditioner precond( a);
+		const Solver cg( a, precond);
+		const DLA::Vector guess( localSz, 0.0);
+		DLA::Vector x( localSz), resid( localSz);
+		cg.solveAndAssign( b, guess, x, 1.0e-10, 1000);
+
+		resid = b - a * x;
+		const std::vector< double > expected = solveTridiagonal( wholeB);
+		double diff = 0.0;
+		for (int i = 0; i < localSz; i++)
+			diff = std::max( diff, std::fabs( x(i) - expected[ first + i] ) );
+		diff = PTT::allreduceMax( diff, PTT::Specified() );
+		const double relResid = resid.abs() / b.abs();
+		if ( root )
+			std::cout << "conjugate gradient : " << ( relResid < 1.0e-9 )
+				<< " " << ( diff < 1.0e-8 ) << std::endl;
+		// conjugate gradient : 1 1
+	}
+	MPI_Finalize();
+
+	return 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * solvingWithVectorAndMatrixViews.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include <iostream>
+#include <boost/proto/proto.hpp>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/SparseLinAlg.hpp>
+
+namespace DLA = DenseLinAlg;
+namespace SLA = SparseLinAlg;
+
+int main()
+{
+	// arrays owned by the caller, e.g. fields of a mesh
+	double coeff[3][3] = { {  4.0, -1.0,  0.0 },
+						   { -1.0,  4.0, -1.0 },
+						   {  0.0, -1.0,  4.0 } };
+	double rhs[3] = { 2.0, 4.0, 10.0 };
+	double guess[3] = { 0.0, 0.0, 0.0 };
+
+	// every other element is used
+	double answer[6] = { -1.0, -1.0, -1.0, -1.0, -1.0, -1.0 };
+
+	DLA::MatrixView coeffView( &coeff[0][0], 3, 3);
+	DLA::VectorView rhsView( rhs, 3), guessView( guess, 3),
+					answerView( answer, 3, 2);
+
+	SLA::DiagonalPreconditioner precond( coeffView);
+	SLA::ConjugateGradient< DLA::MatrixView, SLA::DiagonalPreconditioner >
+												cg( coeffView, precond);
+
+	cg.solveAndAssign( rhsView, guessView, answerView, 1.0e-10);
+
+	// The result should be ( 1, 2, 3) in the even elements,
+	// leaving the odd elements -1.
+	for (int i = 0; i < 6; i++) std::cout << answer[i] << " ";
+	std::cout << std::endl;
+
+	// The residual should be ( 0, 0, 0).
+	DLA::Vector resid(3);
+	resid = rhsView - coeffView * answerView;
+	std::cout << resid(0) << " " << resid(1) << " " << resid(2) << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,183 @@
+/*
+ * solvingWithWorkStealingPool.cpp
+ *
+ *  Evaluating the vector expressions, the reductions and the
+ *  preconditioned conjugate gradient by the tasks of work-stealing pools.
+ *  The reductions should not depend on the number of the threads,
+ *  and the independent solves run at the same time on a pool should
+ *  agree with those solved one by one.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#include <ParallelizationTypeTag/ThreadPool.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/SparseLinAlg.hpp>
+
+#include "vectorDifference.hpp"
+
+namespace DLA = DenseLinAlg;
+namespace SLA = SparseLinAlg;
+namespace PTT = ParallelizationTypeTag;
+
+typedef PTT::SingleProcess< PTT::SingleThread< PTT::NoSIMD > > ScalarPT;
+
+const int MaxThreads = 4;
+
+bool close( double a, double b)
+{
+	return std::fabs( a - b) <= 1.0e-12 * std::max( 1.0, std::fabs( b) );
+}
+
+// the results of the kernels run by a task of the pool
+struct Results
+{
+	DLA::Vector map, mapReduce, precond;
+	double dot, norm, fusedNorm;
+
+	explicit Results( int sz) :
+		map( sz), mapReduce( sz), precond( sz),
+		dot( 0.0), norm( 0.0), fusedNorm( 0.0) {}
+	~Results();
+};
+
+Results::~Results() = default;
+
+void compute( PTT::WorkStealingPool& pool, Results& r,
+	const DLA::Vector& x, const DLA::Vector& z, const SLA::BandedMatrix& a,
+	const SLA::DiagonalPreconditioner& precond)
+{
+	PTT::TaskGroup group( pool);
+	group.run( [&]() {
+		r.map = 2.0 * x + z;
+		r.mapReduce = z - a * x;
+		r.dot = x.dot( z);
+		r.norm = DLA::norm2( z - a * x);
+		DLA::Vector w( z);
+		r.fusedNorm = std::get< 1 >( DLA::fuse(
+			DLA::deferred( w) -= 0.5 * x, DLA::norm2( w) ) );
+		precond.solveAndAssign( z, r.precond);
+	} );
+	group.wait();
+}
+
+// The pools of 1 to MaxThreads threads
+// are compared with the scalar code and with each other.
+void compareThreads( const DLA::Vector& x, const DLA::Vector& z,
+	const SLA::BandedMatrix& a, const SLA::DiagonalPreconditioner& precond)
+{
+	const int sz = x.size();
+	Results first( sz);
+	for (int n = 1; n <= MaxThreads; n++) {
+		PTT::WorkStealingPool pool( n);
+		Results r( sz);
+		compute( pool, r, x, z, a, precond);
+		if ( n == 1 ) first = r;
+
+		DLA::Vector ref( sz);
+		DLA::AssignVecExpr< DLA::AssignFunctor >()( 2.0 * x + z,
+			DLA::VecExprTagGrammar()( 2.0 * x + z), ref, ScalarPT() );
+		const double mapDiff = maxDiff( r.map, ref);
+		DLA::AssignVecExpr< DLA::AssignFunctor >()( z - a * x,
+			DLA::VecExprTagGrammar()( z - a * x), ref, ScalarPT() );
+		const double mapReduceDiff = maxDiff( r.mapReduce, ref);
+		precond.solveAndAssign( z, ref, ScalarPT() );
+		const double precondDiff = maxDiff( r.precond, ref);
+
+		std::cout << pool.numThreads() << " threads : " << mapDiff << " "
+			<< mapReduceDiff << " " << precondDiff << " "
+			<< close( r.dot, x.dot( z, ScalarPT()) ) << " "
+			<< ( r.dot == first.dot && r.norm == first.norm &&
+				r.fusedNorm == first.fusedNorm ) << std::endl;
+	}
+}
+
+typedef SLA::ConjugateGradient< SLA::BandedMatrix,
+		SLA::DiagonalPreconditioner > ConjGrad;
+
+// Solving the systems at the same time on a pool by a solver,
+// with the workspaces of the tasks
+void solveConcurrently( const ConjGrad& cg, const DLA::Vector* rhs,
+	const DLA::Vector& guess, DLA::Vector* solutions, int numSolves)
+{
+	std::vector< SLA::ConjugateGradientWorkspace > workspaces( numSolves);
+	PTT::WorkStealingPool pool( MaxThreads);
+	PTT::TaskGroup solves( pool);
+	for (int s = 0; s < numSolves; s++)
+		solves.run( [&, s]() {
+			cg.solveAndAssign( rhs[s], guess, solutions[s], 1.0e-10,
+				std::numeric_limits< int >::max(), PTT::Specified(),
+				workspaces[s] );
+		} );
+	solves.wait();
+}
+
+int main()
+{
+	// odd, so that the last block is partial
+	const int sz = 100003;
+	DLA::Vector x( sz), z( sz);
+	SLA::BandedMatrix a( sz, sz, 1, 1);
+	for (int i = 0; i < sz; i++) {
+		x(i) = std::sin( 0.001 * i);
+		z(i) = std::cos( 0.002 * i) + 0.5;
+		a( i, i) = 4.0 + 0.001 * ( i % 7 );
+		if ( i > 0 ) a( i, i - 1) = -1.0;
+		if ( i < sz - 1 ) a( i, i + 1) = -1.0;
+	}
+	const SLA::DiagonalPreconditioner precond( a);
+
+	compareThreads( x, z, a, precond);
+	// 1 threads : 0 0 0 1 1
+	// 2 threads : 0 0 0 1 1
+	// 3 threads : 0 0 0 1 1
+	// 4 threads : 0 0 0 1 1
+
+	// Three systems of different right hand sides are solved
+	// at the same time on a pool by a solver, with the workspaces
+	// of the tasks, and one by one by a copy of the solver.
+	const int NumSolves = 3;
+	const ConjGrad cg( a, precond);
+	const DLA::Vector guess( sz, 0.0);
+	DLA::Vector rhs[ NumSolves ] = { DLA::Vector( sz), DLA::Vector( sz),
+									DLA::Vector( sz) },
+		concurrent[ NumSolves ] = { DLA::Vector( sz), DLA::Vector( sz),
+									DLA::Vector( sz) },
+		sequential[ NumSolves ] = { DLA::Vector( sz), DLA::Vector( sz),
+									DLA::Vector( sz) };
+	for (int s = 0; s < NumSolves; s++)
+		rhs[s] = ( 1.0 + s ) * z - x;
+
+	solveConcurrently( cg, rhs, guess, concurrent, NumSolves);
+
+	// A copy of the solver has a workspace of its own.
+	const ConjGrad copied( cg);
+
+	for (int s = 0; s < NumSolves; s++) {
+		PTT::WorkStealingPool pool( 1);
+		PTT::TaskGroup solve( pool);
+		solve.run( [&, s]() {
+			copied.solveAndAssign( rhs[s], guess, sequential[s], 1.0e-10);
+		} );
+		solve.wait();
+
+		DLA::Vector resid( sz);
+		resid = rhs[s] - a * concurrent[s];
+		std::cout << "solve " << s << " : "
+			<< maxDiff( concurrent[s], sequential[s] ) << " "
+			<< ( resid.abs() < 1.0e-8 * rhs[s].abs() ) << std::endl;
+	}
+	// solve 0 : 0 1
+	// solve 1 : 0 1
+	// solve 2 : 0 1
+
+	return 0;
+}
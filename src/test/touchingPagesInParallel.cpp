@@ -0,0 +1,119 @@
+/*
+ * touchingPagesInParallel.cpp
+ *
+ *  Constructing the vectors and the matrices, whose pages are touched first
+ *  by the threads evaluating their elements, and interleaving the pages
+ *  of the matrices across the NUMA nodes.
+ *  The elements should not depend on the parallelization type,
+ *  nor be changed by the interleaving.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#include <omp.h>
+#endif
+
+#include <iostream>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/SparseLinAlg.hpp>
+
+namespace DLA = DenseLinAlg;
+namespace SLA = SparseLinAlg;
+namespace PTT = ParallelizationTypeTag;
+
+// filling and copying a buffer of numLines lines by the type pt
+template < typename ParallelizationType >
+bool fillAndCopy( int numLines, int lineSz, const ParallelizationType& pt)
+{
+	const int sz = numLines * lineSz;
+	double* const src = DLA::DefaultAllocator::allocate( sz);
+	double* const dst = DLA::DefaultAllocator::allocate( sz);
+	DLA::TouchLines()( src, numLines, lineSz, pt);
+	DLA::FillLines()( src, numLines, lineSz, 2.5, pt);
+	for (int i = 0; i < sz; i += 3) src[i] = i;
+	DLA::CopyLines()( dst, src, numLines, lineSz, pt);
+
+	bool same = true;
+	for (int i = 0; i < sz; i++)
+		same = same && dst[i] == ( i % 3 == 0 ? double( i) : 2.5 );
+	DLA::DefaultAllocator::deallocate( dst);
+	DLA::DefaultAllocator::deallocate( src);
+	return same;
+}
+
+int main()
+{
+#ifdef _OPENMP
+	omp_set_num_threads( 3);
+#endif
+	// more lines than a block, and the last block partial
+	const int numLines = 3 * DLA::SimdBlockSize + 5;
+
+	std::cout << "fill and copy : "
+		<< fillAndCopy( numLines, 1,
+				PTT::SingleProcess< PTT::SingleThread< PTT::NoSIMD > >() ) << " "
+		<< fillAndCopy( numLines, 3,
+				PTT::SingleProcess< PTT::OpenMP< PTT::NoSIMD > >() ) << " "
+		<< fillAndCopy( numLines, 3,
+				PTT::SingleProcess< PTT::OpenMP< PTT::AVX > >() ) << " "
+		<< fillAndCopy( numLines, 1,
+				PTT::SingleProcess< PTT::Runtime >() ) << std::endl;
+	// fill and copy : 1 1 1 1
+
+	// the containers initialized by the specified type
+	DLA::Vector v( numLines, 1.5), w( v), u( numLines);
+	u = 2.0 * v + w;
+	bool vectors = true;
+	for (int i = 0; i < numLines; i++)
+		vectors = vectors && w(i) == 1.5 && u(i) == 4.5;
+
+	DLA::DiagonalMatrix d( numLines, -1.0), e( d);
+	bool diagonals = true;
+	for (int i = 0; i < numLines; i++) diagonals = diagonals && e(i) == -1.0;
+
+	DLA::Matrix a( numLines, 5, 0.5);
+	DLA::BasicMatrix< DLA::ColumnMajor > c( 7, numLines, 0.25);
+	a( numLines - 1, 4) = 3.0;
+	c( 6, numLines - 1) = 3.0;
+	const DLA::Matrix b( a);
+	DLA::BasicMatrix< DLA::ColumnMajor > f( 7, numLines);
+	f = c;
+	bool matrices = b( numLines - 1, 4) == 3.0 && f( 6, numLines - 1) == 3.0;
+	for (int ri = 0; ri < numLines - 1; ri++)
+		for (int ci = 0; ci < 5; ci++)
+			matrices = matrices && b( ri, ci) == 0.5 && f( ci, ri) == 0.25;
+
+	DLA::MultiVector m( numLines, 3, 1.0), n( m), o( numLines, 3);
+	o = n;
+	bool multiVectors = true;
+	for (int i = 0; i < numLines; i++)
+		for (int j = 0; j < 3; j++)
+			multiVectors = multiVectors && o( i, j) == 1.0;
+
+	std::cout << "containers : " << vectors << " " << diagonals << " "
+		<< matrices << " " << multiVectors << std::endl;
+	// containers : 1 1 1 1
+
+	// The interleaving moves the pages, but not the elements.
+	SLA::BandedMatrix banded( numLines, numLines, 1, 1, 2.0);
+	const SLA::BandedMatrix copied( banded);
+	SLA::CsrMatrix csr( 3, 3, 3);
+	for (int i = 0; i < 3; i++) csr.insert( i, i, 4.0);
+	csr.assemble();
+	const SLA::SellMatrix sell( csr);
+
+	const bool interleaved = b.interleave() && copied.interleave() &&
+							csr.interleave() && sell.interleave();
+	bool unchanged = b( numLines - 1, 4) == 3.0 && b( 0, 0) == 0.5;
+	for (int i = 1; i < numLines; i++)
+		unchanged = unchanged && copied( i, i) == 2.0 && copied( i, i - 1) == 2.0;
+	std::cout << "interleaved : " << interleaved << " " << unchanged << std::endl;
+	// interleaved : 1 1
+	// ( interleaved : 0 1 where the NUMA policy is not supported )
+
+	return 0;
+}
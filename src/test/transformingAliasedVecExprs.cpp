@@ -0,0 +1,78 @@
+/*
+ * transformingAliasedVecExprs.cpp
+ *
+ *  Assigning vector expressions multiplying the left hand side
+ *  by a matrix.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include <iostream>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/SparseLinAlg.hpp>
+
+namespace DLA = DenseLinAlg;
+namespace SLA = SparseLinAlg;
+
+
+void print( const DLA::Vector& v)
+{
+	for (int i = 0; i < v.size(); i++) std::cout << v(i) << " ";
+	std::cout << std::endl;
+}
+
+int main()
+{
+	const int n = 4;
+
+	DLA::Matrix mat( n, n, 0.0);
+	for (int i = 0; i < n; i++) {
+		mat( i, i) = 2.0;
+		if ( i > 0 ) mat( i, i - 1) = -1.0;
+		if ( i < n - 1 ) mat( i, i + 1) = -1.0;
+	}
+	const SLA::CsrMatrix csr( mat);
+	const SLA::SellMatrix sell( csr);
+
+	DLA::Vector x( n), b( n, 1.0);
+	for (int i = 0; i < n; i++) x(i) = i + 1.0;
+
+	// A * ( 1, 2, 3, 4 ) = ( 0, 0, 0, 5 )
+	x = mat * x;
+	print( x);
+	// 0 0 0 5
+
+	// A * ( 0, 0, 0, 5 ) = ( 0, 0, -5, 10 )
+	x = b + csr * x - b;
+	print( x);
+	// 0 0 -5 10
+
+	// A * ( 0, 0, -5, 10 ) = ( 0, 5, -20, 25 )
+	x += sell * x;
+	print( x);
+	// 0 5 -25 35
+
+	// A * ( 0, 5, -25, 35 ) = ( -5, 35, -90, 95 )
+	x -= 2.0 * x + mat * x;
+	print( x);
+	// 5 -40 115 -130
+
+	// The elementwise expressions are evaluated in place.
+	x = b + 2.0 * x;
+	print( x);
+	// 11 -79 231 -259
+
+	// The view of the left hand side is also gathered.
+	DLA::VectorView xView( x);
+	x = mat * xView;
+	print( x);
+	// 101 -400 800 -749
+
+	return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * transformingCommonSubexprs.cpp
+ *
+ *  Evaluating the matrix vector multiplications repeated
+ *  in a vector expression only once for every element.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include <iostream>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/SparseLinAlg.hpp>
+
+namespace DLA = DenseLinAlg;
+namespace SLA = SparseLinAlg;
+
+
+int main()
+{
+	const int n = 4;
+
+	DLA::Matrix mat( n, n, 0.0);
+	for (int i = 0; i < n; i++) {
+		mat( i, i) = 2.0;
+		if ( i > 0 ) mat( i, i - 1) = -1.0;
+		if ( i < n - 1 ) mat( i, i + 1) = -1.0;
+	}
+	const SLA::CsrMatrix csr( mat);
+	const SLA::SellMatrix sell( csr);
+
+	DLA::Vector x( n), y( n, 1.0), b( n, 1.0), r( n);
+	for (int i = 0; i < n; i++) x(i) = i + 1.0;
+
+	// A * x = ( 0, 0, 0, 5 ) , A * y = ( 1, 0, 0, 1 )
+	r = b - mat * x + 0.5 * ( mat * x );
+	for (int i = 0; i < n; i++) std::cout << r(i) << " ";
+	std::cout << std::endl;
+	// 1 1 1 -1.5
+
+	r = csr * x - csr * x + ( csr * x ) * 2.0;
+	for (int i = 0; i < n; i++) std::cout << r(i) << " ";
+	std::cout << std::endl;
+	// 0 0 0 10
+
+	// The products of the same type on the different vectors
+	// are not shared.
+	r = sell * x - sell * y + sell * x;
+	for (int i = 0; i < n; i++) std::cout << r(i) << " ";
+	std::cout << std::endl;
+	// -1 0 0 9
+
+	r += mat * y - 0.5 * ( mat * y );
+	for (int i = 0; i < n; i++) std::cout << r(i) << " ";
+	std::cout << std::endl;
+	// -0.5 0 0 9.5
+
+	std::cout << DLA::norm2( mat * x - mat * x ) << " " <<
+			DLA::sum( b - csr * x + csr * y ) << std::endl;
+	// 0 1
+
+	return 0;
+}
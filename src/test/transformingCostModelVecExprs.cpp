@@ -0,0 +1,119 @@
+/*
+ * transformingCostModelVecExprs.cpp
+ *
+ *  Assigning vector expressions multiplying vector expressions
+ *  by matrices, whose operands are materialized or inlined
+ *  by the cost model.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include <cmath>
+#include <iostream>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+
+#include "vectorDifference.hpp"
+
+namespace DLA = DenseLinAlg;
+
+
+void print( const DLA::Vector& v)
+{
+	for (int i = 0; i < v.size(); i++) std::cout << v(i) << " ";
+	std::cout << std::endl;
+}
+
+// y = m * x computed by the loops
+DLA::Vector product( const DLA::Matrix& m, const DLA::Vector& x)
+{
+	DLA::Vector y( m.rowSize(), 0.0);
+	for (int i = 0; i < m.rowSize(); i++)
+		for (int j = 0; j < m.columnSize(); j++)
+			y(i) += m( i, j) * x(j);
+	return y;
+}
+
+int main()
+{
+	const int n = 4;
+
+	DLA::Matrix a( n, n, 0.0), b( n, n, 0.0);
+	DLA::DiagonalMatrix d( n);
+	DLA::Vector x( n), y( n), z( n);
+	for (int i = 0; i < n; i++) {
+		a( i, i) = 2.0;
+		if ( i > 0 ) a( i, i - 1) = -1.0;
+		if ( i < n - 1 ) a( i, i + 1) = -1.0;
+		for (int j = 0; j < n; j++) b( i, j) = i + j;
+		d( i) = i + 1.0;
+		x( i) = i + 1.0;
+		y( i) = 1.0;
+	}
+
+	// The inner A * x is materialized once for both of its uses.
+	DLA::VecPlanPrinter()( d * ( a * x ) + b * ( a * x ) );
+	// plus : 66 flops, 520 bytes
+	//   multiplies : 33 flops, 264 bytes
+	//     terminal
+	//     multiplies : 32 flops, 256 bytes, materialized
+	//       terminal
+	//       terminal
+	//   multiplies : 32 flops, 256 bytes
+	//     terminal
+	//     multiplies : 32 flops, 256 bytes, materialized
+	//       terminal
+	//       terminal
+	z = d * ( a * x ) + b * ( a * x );
+	print( z);
+	// A * x = ( 0, 0, 0, 5 ) , B * ( A * x ) = ( 15, 20, 25, 30 )
+	// 15 20 25 50
+
+	// The cheap operand 2 * x is inlined, while x + y is materialized.
+	DLA::VecPlanPrinter()( b * ( 2.0 * x ) );
+	// multiplies : 48 flops, 256 bytes
+	//   terminal
+	//   multiplies : 1 flops, 8 bytes, inlined
+	//     terminal
+	//     terminal
+	DLA::VecPlanPrinter()( b * ( x + y ) );
+	// multiplies : 32 flops, 256 bytes
+	//   terminal
+	//   plus : 1 flops, 16 bytes, materialized
+	//     terminal
+	//     terminal
+	DLA::Vector ref = product( b, x ), by = product( b, y );
+	for (int i = 0; i < n; i++) ref(i) -= by(i);
+	z = b * ( 2.0 * x ) - b * ( x + y );
+	std::cout << maxDiff( z, ref ) << std::endl;
+	// 0
+
+	// The nested products are materialized from the innermost.
+	z = b * ( a * ( a * x ) );
+	std::cout << maxDiff( z, product( b, product( a, product( a, x ) ) ) )
+			<< std::endl;
+	// 0
+
+	// Assigning into the vector read by the operands
+	ref = product( b, product( a, x ) );
+	x = b * ( a * x );
+	std::cout << maxDiff( x, ref ) << std::endl;
+	// 0
+	ref = product( b, y );
+	for (int i = 0; i < n; i++) ref(i) *= 2.0;
+	y = b * ( 2.0 * y );
+	std::cout << maxDiff( y, ref ) << std::endl;
+	// 0
+	DLA::Vector yy = product( b, y );
+	for (int i = 0; i < n; i++) ref(i) = y(i) + 2.0 * yy(i);
+	y += b * ( y + y );
+	std::cout << maxDiff( y, ref ) << std::endl;
+	// 0
+
+	return 0;
+}
@@ -0,0 +1,60 @@
+/*
+ * transformingFusedVecExprs.cpp
+ *
+ *  Evaluating several vector assignments and reductions in a single loop.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include <iostream>
+#include <tuple>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+
+namespace DLA = DenseLinAlg;
+
+
+int main()
+{
+	const int n = 4;
+
+	DLA::Vector x( n, 1.0), resid( n), p( n), q( n, 2.0);
+	for (int i = 0; i < n; i++) {
+		resid(i) = i + 1.0;
+		p(i) = 1.0 - i;
+	}
+	const double alpha = 0.5;
+
+	// x = ( 1.5, 1, 0.5, 0 ), resid = ( 0, 1, 2, 3 )
+	const auto results = DLA::fuse( DLA::deferred( x) += alpha * p,
+									DLA::deferred( resid) -= alpha * q,
+									DLA::norm2( resid),
+									DLA::dot( x, resid) );
+
+	for (int i = 0; i < n; i++) std::cout << x(i) << " ";
+	std::cout << std::endl;
+	// 1.5 1 0.5 0
+	for (int i = 0; i < n; i++) std::cout << resid(i) << " ";
+	std::cout << std::endl;
+	// 0 1 2 3
+	std::cout << std::get< 2 >( results) << " " <<
+			std::get< 3 >( results) << std::endl;
+	// 3.74166 2
+
+	// p = resid + 2 p = ( 2, 1, 0, -1 )
+	DLA::DiagonalMatrix diag( n, 2.0);
+	const double pSum = std::get< 1 >( DLA::fuse(
+								DLA::deferred( p) = resid + diag * p,
+								DLA::sum( p),
+								DLA::max_abs( p - resid) ) );
+	for (int i = 0; i < n; i++) std::cout << p(i) << " ";
+	std::cout << pSum << std::endl;
+	// 2 1 0 -1 2
+
+	return 0;
+}
@@ -5,6 +5,12 @@
  *      Author: Masakatsu ITO
  */
 
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <boost/proto/proto.hpp>
 
@@ -51,6 +57,38 @@ int main()
 	std::cout << result(2,0) << " " << result(2,1) << " " << result(2,2) <<
 			std::endl;
 
+	// The products larger than a tile, added to a column major matrix
+	const int rowSz = 150, innerSz = 70, colSz = 130;
+	DLA::Matrix bigPre( rowSz, innerSz), bigPost( innerSz, colSz);
+	DLA::DiagonalMatrix bigDiag( innerSz);
+	for (int ri = 0; ri < rowSz; ri++)
+		for (int k = 0; k < innerSz; k++)
+			bigPre( ri, k) = 1.0 + 0.01 * ri - 0.02 * k;
+	for (int k = 0; k < innerSz; k++) {
+		bigDiag( k) = 0.5 + 0.1 * k;
+		for (int ci = 0; ci < colSz; ci++)
+			bigPost( k, ci) = 2.0 - 0.03 * k + 0.01 * ci;
+	}
+
+	DLA::Matrix bigResult( rowSz, colSz);
+	DLA::BasicMatrix< DLA::ColumnMajor > colMajorResult( rowSz, colSz, 1.0);
+	bigResult = bigPre * bigDiag * bigPost;
+	colMajorResult += bigPre * bigDiag * bigPost - bigResult;
+
+	double maxDiff = 0.0, maxColMajorDiff = 0.0;
+	for (int ri = 0; ri < rowSz; ri++)
+		for (int ci = 0; ci < colSz; ci++) {
+			double elm = 0.0;
+			for (int k = 0; k < innerSz; k++)
+				elm += bigPre( ri, k) * bigDiag( k) * bigPost( k, ci);
+			maxDiff = std::max( maxDiff, std::fabs( bigResult( ri, ci) - elm) );
+			maxColMajorDiff = std::max( maxColMajorDiff,
+								std::fabs( colMajorResult( ri, ci) - 1.0) );
+		}
+	std::cout << maxDiff << " " << maxColMajorDiff << std::endl;
+	// The result should be :
+	// 0 0
+
 	return 0;
 }
 
@@ -0,0 +1,111 @@
+/*
+ * transformingMatMatMult.cpp
+ *
+ *  Multiplying matrices by the blocked kernel a tile at a time.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+
+namespace DLA = DenseLinAlg;
+
+
+int main()
+{
+	DLA::Matrix pre( 2, 3), post( 3, 2), result( 2, 2, 1.0), shift( 2, 2);
+
+	pre(0,0) = 1.0; pre(0,1) = 2.0; pre(0,2) = 3.0;
+	pre(1,0) = 4.0; pre(1,1) = 5.0; pre(1,2) = 6.0;
+
+	post(0,0) = 7.0;  post(0,1) = 8.0;
+	post(1,0) = 9.0;  post(1,1) = 10.0;
+	post(2,0) = 11.0; post(2,1) = 12.0;
+
+	shift(0,0) = 8.0; shift(0,1) = 4.0;
+	shift(1,0) = 9.0; shift(1,1) = 4.0;
+
+	result = pre * post - shift;
+	std::cout << result(0,0) << " " << result(0,1) << std::endl;
+	std::cout << result(1,0) << " " << result(1,1) << std::endl;
+	// The result should be :
+	// 50 60
+	// 130 150
+
+	result += pre * post;
+	std::cout << result(0,0) << " " << result(0,1) << std::endl;
+	std::cout << result(1,0) << " " << result(1,1) << std::endl;
+	// 108 124
+	// 269 304
+
+	// The products larger than a tile and not multiples of
+	// the register blocks, into row major and column major matrices
+	const int rowSz = 150, innerSz = 300, colSz = 130;
+	DLA::Matrix bigPre( rowSz, innerSz), bigPost( innerSz, colSz);
+	for (int ri = 0; ri < rowSz; ri++)
+		for (int k = 0; k < innerSz; k++)
+			bigPre( ri, k) = std::sin( 0.1 * ri + 0.2 * k);
+	for (int k = 0; k < innerSz; k++)
+		for (int ci = 0; ci < colSz; ci++)
+			bigPost( k, ci) = std::cos( 0.3 * k - 0.1 * ci);
+
+	DLA::Matrix bigResult( rowSz, colSz);
+	DLA::BasicMatrix< DLA::ColumnMajor > colMajorResult( rowSz, colSz, 1.0);
+	bigResult = bigPre * bigPost;
+	colMajorResult -= bigPre * bigPost + bigResult;
+
+	double maxDiff = 0.0, maxColMajorDiff = 0.0;
+	for (int ri = 0; ri < rowSz; ri++)
+		for (int ci = 0; ci < colSz; ci++) {
+			double elm = 0.0;
+			for (int k = 0; k < innerSz; k++)
+				elm += bigPre( ri, k) * bigPost( k, ci);
+			maxDiff = std::max( maxDiff, std::fabs( bigResult( ri, ci) - elm) );
+			maxColMajorDiff = std::max( maxColMajorDiff,
+				std::fabs( colMajorResult( ri, ci) - ( 1.0 - 2.0 * elm) ) );
+		}
+	std::cout << ( maxDiff < 1e-12 ) << " " <<
+			( maxColMajorDiff < 1e-12 ) << std::endl;
+	// 1 1
+
+	// Multiplying a matrix by another and assigning the product into
+	// the former, whose elements are still read by the tiles
+	// not yet assigned
+	const int sqSz = 100;
+	DLA::Matrix square( sqSz, sqSz), factor( sqSz, sqSz);
+	for (int ri = 0; ri < sqSz; ri++)
+		for (int ci = 0; ci < sqSz; ci++) {
+			square( ri, ci) = std::sin( 0.1 * ri - 0.3 * ci);
+			factor( ri, ci) = std::cos( 0.2 * ri + 0.1 * ci);
+		}
+	const DLA::Matrix original( square);
+	DLA::Matrix accumulated( square);
+	square = square * factor;
+	accumulated += accumulated * factor;
+
+	double maxAliasDiff = 0.0, maxPlusAliasDiff = 0.0;
+	for (int ri = 0; ri < sqSz; ri++)
+		for (int ci = 0; ci < sqSz; ci++) {
+			double elm = 0.0;
+			for (int k = 0; k < sqSz; k++)
+				elm += original( ri, k) * factor( k, ci);
+			maxAliasDiff = std::max( maxAliasDiff,
+				std::fabs( square( ri, ci) - elm) );
+			maxPlusAliasDiff = std::max( maxPlusAliasDiff,
+				std::fabs( accumulated( ri, ci) - ( original( ri, ci) + elm) ) );
+		}
+	std::cout << ( maxAliasDiff < 1e-12 ) << " " <<
+			( maxPlusAliasDiff < 1e-12 ) << std::endl;
+	// 1 1
+
+	return 0;
+}
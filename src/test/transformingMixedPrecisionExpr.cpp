@@ -0,0 +1,79 @@
+/*
+ * transformingMixedPrecisionExpr.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include <iomanip>
+#include <iostream>
+#include <type_traits>
+#include <boost/proto/proto.hpp>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+
+namespace DLA = DenseLinAlg;
+
+
+int main()
+{
+	typedef DLA::BasicMatrix< DLA::RowMajor, float > FloatMatrix;
+	typedef DLA::BasicVector< float > FloatVector;
+	typedef DLA::BasicDiagonalMatrix< float > FloatDiagonalMatrix;
+
+	// float matrix * double vector is accumulated in double.
+	static_assert( std::is_same<
+			DLA::LazyMatVecMult< FloatMatrix, DLA::Vector >::result_type,
+			double >::value,
+			"float matrix * double vector should be evaluated in double" );
+	static_assert( std::is_same<
+			DLA::LazyMatVecMult< FloatMatrix, FloatVector >::result_type,
+			float >::value,
+			"float matrix * float vector should be evaluated in float" );
+
+	FloatMatrix matA( 3, 3);
+	matA(0,0) = 1.0f; matA(0,1) = 1.0f; matA(0,2) = 0.0f;
+	matA(1,0) = 0.0f; matA(1,1) = 1.0f; matA(1,2) = 1.0f;
+	matA(2,0) = 1.0f; matA(2,1) = 0.0f; matA(2,2) = 1.0f;
+
+	DLA::Vector vecX(3), vecY(3);
+	vecX(0) = 1.0; vecX(1) = 1.0e-9; vecX(2) = 2.0e-9;
+
+	vecY = matA * vecX;
+
+	// The results should be 1.000000001, 3e-09, 1.000000002 ,
+	// which cannot be represented by float.
+	std::cout << std::setprecision(10) <<
+			vecY(0) << " " << vecY(1) << " " << vecY(2) << std::endl;
+
+	// double expressions assigned into a float vector
+	FloatVector vecF(3);
+	vecF = vecX + 2.0 * vecY;
+
+	// The results should be 3, 7e-09, 2 .
+	std::cout << std::setprecision(3) <<
+			vecF(0) << " " << vecF(1) << " " << vecF(2) << std::endl;
+
+	// float diagonal matrix and float scalar mixed with double vectors
+	FloatDiagonalMatrix diag(3, 0.5f);
+	vecY = diag * vecX + 1.0f * vecX;
+
+	// The results should be 1.5, 1.5e-09, 3e-09 .
+	std::cout << std::setprecision(3) <<
+			vecY(0) << " " << vecY(1) << " " << vecY(2) << std::endl;
+
+	// Matrices of different element types
+	DLA::Matrix matB( 3, 3, 1.0);
+	DLA::Matrix matC( 3, 3);
+	matC = matB - matA;
+
+	// The results should be 0 0 1 .
+	std::cout << matC(0,0) << " " << matC(0,1) << " " << matC(0,2) <<
+			std::endl;
+
+	return 0;
+}
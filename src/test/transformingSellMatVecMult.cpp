@@ -0,0 +1,87 @@
+/*
+ * transformingSellMatVecMult.cpp
+ *
+ *  Multiplying a sparse matrix having irregular row lengths and a vector
+ *  in the SELL-C-sigma format, by every SIMD kernel
+ *  and by matrix vector expressions.
+ *  All the products should be equal to that in the CSR format.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include <cmath>
+#include <iostream>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/SparseLinAlg.hpp>
+
+#include "vectorDifference.hpp"
+
+namespace DLA = DenseLinAlg;
+namespace SLA = SparseLinAlg;
+namespace PTT = ParallelizationTypeTag;
+
+
+int main()
+{
+	const int n = 101;
+
+	// The ri'th row has 1 + ri % 7 nonzero elements besides the diagonal.
+	DLA::Matrix dense( n, n, 0.0);
+	for (int ri = 0; ri < n; ri++) {
+		dense( ri, ri) = 10.0 + ri;
+		for (int k = 1; k <= 1 + ri % 7; k++)
+			dense( ri, ( ri + 13 * k ) % n) = 1.0 / k;
+	}
+	const SLA::CsrMatrix csr( dense);
+
+	DLA::Vector x( n), yCsr( n), zCsr( n), y( n);
+	for (int i = 0; i < n; i++) x(i) = std::sin( 0.1 * i);
+
+	yCsr = csr * x;
+	zCsr = 2.0 * x - csr * x;
+
+	const int chunkHeights[] = { 1, 2, 4, 8, 16 };
+	for (int chunkHeight : chunkHeights) {
+		// sorting all the rows, or only within every chunk
+		const SLA::SellMatrix sorted( csr, chunkHeight, n),
+							unsorted( csr, chunkHeight, chunkHeight);
+
+		std::cout << "C = " << chunkHeight << std::endl;
+		std::cout << "stored elements " << sorted.storedSize() <<
+				" " << unsorted.storedSize() << std::endl;
+		// C = 1 : 499 499
+		// C = 2 : 502 588
+		// C = 4 : 512 724
+		// C = 8 : 520 832
+		// C = 16 : 560 896
+
+		sorted.multiply( x, y, PTT::NoSIMD() );
+		std::cout << ( maxDiff( y, yCsr) < 1e-12 ) << " ";
+		sorted.multiply( x, y, PTT::AVX2() );
+		std::cout << ( maxDiff( y, yCsr) < 1e-12 ) << " ";
+		sorted.multiply( x, y, PTT::AVX512() );
+		std::cout << ( maxDiff( y, yCsr) < 1e-12 ) << " ";
+		unsorted.multiply( x, y, PTT::NativeSIMD() );
+		std::cout << ( maxDiff( y, yCsr) < 1e-12 ) << std::endl;
+		// 1 1 1 1
+
+		y = sorted * x;
+		std::cout << ( maxDiff( y, yCsr) < 1e-12 ) << " ";
+		y = 2.0 * x - sorted * x;
+		std::cout << ( maxDiff( y, zCsr) < 1e-12 ) << " ";
+		y = 2.0 * x;
+		y -= unsorted * x;
+		std::cout << ( maxDiff( y, zCsr) < 1e-12 ) << " ";
+		std::cout << ( sorted( 5, ( 5 + 13 * 3 ) % n) == 1.0 / 3 ) << " ";
+		std::cout << ( sorted( 5, 6) == 0.0 ) << std::endl;
+		// 1 1 1 1 1
+	}
+
+	return 0;
+}
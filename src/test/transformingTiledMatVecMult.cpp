@@ -0,0 +1,88 @@
+/*
+ * transformingTiledMatVecMult.cpp
+ *
+ *  Multiplying vectors by dense matrices a strip of rows at a time,
+ *  with the tile sizes tuned for each shape.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+
+namespace DLA = DenseLinAlg;
+
+
+// the largest difference between y and m * x + b computed by the loops
+template < typename MatType, typename VecType >
+double maxDiff( const VecType& y, const MatType& m,
+				const DLA::Vector& x, const DLA::Vector& b)
+{
+	double diff = 0.0;
+	for (int ri = 0; ri < m.rowSize(); ri++) {
+		double elm = 0.0;
+		for (int ci = 0; ci < m.columnSize(); ci++)
+			elm += m( ri, ci) * x( ci);
+		diff = std::max( diff, std::fabs( y( ri) - ( elm + b( ri) ) ) );
+	}
+	return diff;
+}
+
+int main()
+{
+	// The rows are not a multiple of the strips nor of the four rows
+	// accumulated together, and the columns are tiled.
+	const int rowSz = 1003, colSz = 5001;
+	DLA::Matrix a( rowSz, colSz);
+	DLA::BasicMatrix< DLA::ColumnMajor > colMajor( rowSz, colSz);
+	DLA::BasicMatrix< DLA::RowMajor, float > single( rowSz, colSz);
+	for (int ri = 0; ri < rowSz; ri++)
+		for (int ci = 0; ci < colSz; ci++) {
+			a( ri, ci) = std::sin( 0.1 * ri + 0.02 * ci);
+			colMajor( ri, ci) = a( ri, ci);
+			single( ri, ci) = float( a( ri, ci) );
+		}
+	DLA::Vector x( colSz), b( rowSz), zero( rowSz, 0.0), y( rowSz);
+	for (int ci = 0; ci < colSz; ci++) x( ci) = std::cos( 0.3 * ci);
+	for (int ri = 0; ri < rowSz; ri++) b( ri) = ri;
+
+	// Each row is summed in the same order as the loops.
+	y = a * x;
+	std::cout << maxDiff( y, a, x, zero) << std::endl;
+	// 0
+	y = b + colMajor * x;
+	std::cout << maxDiff( y, colMajor, x, b) << std::endl;
+	// 0
+	DLA::Vector minusB( rowSz);
+	minusB = zero - b;
+	y = single * x - b;
+	std::cout << maxDiff( y, single, x, minusB) << std::endl;
+	// 0
+
+	// The products repeated in an expression share a strip.
+	y = a * x + a * x - a * x;
+	std::cout << maxDiff( y, a, x, zero) << std::endl;
+	// 0
+
+	// A smaller matrix of another shape, whose vector is not tiled
+	DLA::Matrix small( 5, 3, 1.0);
+	DLA::Vector s( 3), t( 5);
+	s( 0) = 1.0; s( 1) = 2.0; s( 2) = 3.0;
+	t = small * s;
+	for (int i = 0; i < t.size(); i++) std::cout << t( i) << " ";
+	std::cout << std::endl;
+	// 6 6 6 6 6
+
+	std::cout << dot( a * x, b) - dot( y, b) << std::endl;
+	// 0
+
+	return 0;
+}
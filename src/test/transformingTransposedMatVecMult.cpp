@@ -0,0 +1,128 @@
+/*
+ * transformingTransposedMatVecMult.cpp
+ *
+ *  Multiplying vectors by the transposes of dense and sparse matrices,
+ *  trans( A ) * x , without making the transposes.
+ *  All the products should be equal to those computed by the loops.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/SparseLinAlg.hpp>
+
+#include "vectorDifference.hpp"
+
+namespace DLA = DenseLinAlg;
+namespace SLA = SparseLinAlg;
+
+
+// y = trans( m ) * x computed by the loops
+template < typename MatType >
+DLA::Vector transProduct( const MatType& m, const DLA::Vector& x)
+{
+	DLA::Vector y( m.columnSize(), 0.0);
+	for (int ri = 0; ri < m.rowSize(); ri++)
+		for (int ci = 0; ci < m.columnSize(); ci++)
+			y( ci) += m( ri, ci) * x( ri);
+	return y;
+}
+
+int main()
+{
+	// The elements are small integers, so that the products are exact
+	// in any order of the summation.
+	const int rowSz = 301, colSz = 203;
+	DLA::Matrix a( rowSz, colSz, 0.0);
+	DLA::BasicMatrix< DLA::ColumnMajor > colMajor( rowSz, colSz, 0.0);
+	for (int ri = 0; ri < rowSz; ri++)
+		for (int ci = 0; ci < colSz; ci++)
+			if ( ( ri + 2 * ci ) % 7 < 3 ) {
+				a( ri, ci) = ( ri * ci ) % 5 - 2.0;
+				colMajor( ri, ci) = a( ri, ci);
+			}
+	DLA::Vector x( rowSz), b( colSz), y( colSz), ref( colSz);
+	for (int ri = 0; ri < rowSz; ri++) x( ri) = ri % 4 - 1.0;
+	for (int ci = 0; ci < colSz; ci++) b( ci) = ci;
+
+	// Dense matrices
+	y = DLA::trans( a) * x;
+	std::cout << maxDiff( y, transProduct( a, x) ) << std::endl;
+	// 0
+	y = DLA::trans( colMajor) * x;
+	std::cout << maxDiff( y, transProduct( colMajor, x) ) << std::endl;
+	// 0
+
+	// Within expressions the product is materialized first.
+	DLA::VecPlanPrinter()( b - DLA::trans( a) * x );
+	// minus : 33 flops, 264 bytes
+	//   terminal
+	//   multiplies : 32 flops, 256 bytes, materialized
+	//     terminal
+	//     terminal
+	y = b - DLA::trans( a) * x;
+	ref = transProduct( a, x);
+	for (int ci = 0; ci < colSz; ci++) ref( ci) = b( ci) - ref( ci);
+	std::cout << maxDiff( y, ref) << std::endl;
+	// 0
+	y += DLA::trans( a) * x;
+	std::cout << maxDiff( y, b) << std::endl;
+	// 0
+	std::cout << dot( DLA::trans( a) * x, b) - dot( transProduct( a, x), b)
+			<< std::endl;
+	// 0
+
+	// Sparse matrices
+	const SLA::CsrMatrix csr( a);
+	const SLA::SellMatrix sell( csr);
+	SLA::BandedMatrix banded( rowSz, colSz, 3, 2);
+	for (int ri = 0; ri < rowSz; ri++)
+		for (int ci = std::max( 0, ri - 3); ci <= std::min( colSz - 1, ri + 2);
+				ci++)
+			banded( ri, ci) = ri - ci + 0.5;
+	y = DLA::trans( csr) * x;
+	std::cout << maxDiff( y, transProduct( a, x) ) << std::endl;
+	// 0
+	y = DLA::trans( sell) * x;
+	std::cout << maxDiff( y, transProduct( a, x) ) << std::endl;
+	// 0
+	y = DLA::trans( banded) * x;
+	std::cout << maxDiff( y, transProduct( banded, x) ) << std::endl;
+	// 0
+
+	// Within reductions the product is computed once before the elements
+	// are evaluated by the threads.
+	ref = transProduct( a, x);
+	for (int ci = 0; ci < colSz; ci++) ref( ci) = b( ci) - ref( ci);
+	std::cout << DLA::norm2( b - DLA::trans( csr) * x ) - DLA::norm2( ref)
+			<< " " << DLA::max_abs( DLA::trans( sell) * x - DLA::trans( a) * x )
+			<< std::endl;
+	// 0 0
+
+	// Assigning into the vector multiplied, through a scratch vector
+	DLA::Matrix square( 4, 4, 0.0);
+	DLA::Vector v( 4);
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j <= i; j++) square( i, j) = 1.0;
+		v( i) = i + 1.0;
+	}
+	v = DLA::trans( square) * v;
+	for (int i = 0; i < v.size(); i++) std::cout << v( i) << " ";
+	std::cout << std::endl;
+	// 10 9 7 4
+	v = v - DLA::trans( square) * v;
+	for (int i = 0; i < v.size(); i++) std::cout << v( i) << " ";
+	std::cout << std::endl;
+	// -20 -11 -4 0
+
+	return 0;
+}
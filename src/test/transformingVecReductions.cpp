@@ -0,0 +1,67 @@
+/*
+ * transformingVecReductions.cpp
+ *
+ *  Reducing vector expressions in a single pass
+ *  without storing them into temporary vectors.
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+#ifdef _OPENMP
+#include <ParallelizationTypeTag/OpenMP.hpp>
+#endif
+
+#include <iostream>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+#include <SparseLinAlg/SparseLinAlg.hpp>
+
+namespace DLA = DenseLinAlg;
+namespace SLA = SparseLinAlg;
+
+
+int main()
+{
+	const int n = 4;
+
+	DLA::Matrix mat( n, n, 0.0);
+	for (int i = 0; i < n; i++) {
+		mat( i, i) = 2.0;
+		if ( i > 0 ) mat( i, i - 1) = -1.0;
+		if ( i < n - 1 ) mat( i, i + 1) = -1.0;
+	}
+	const SLA::CsrMatrix csr( mat);
+	const SLA::SellMatrix sell( csr);
+
+	DLA::Vector x( n), b( n, 1.0);
+	for (int i = 0; i < n; i++) x(i) = i + 1.0;
+	const DLA::DiagonalMatrix diag( n, 0.5);
+
+	// A * x = ( 0, 0, 0, 5 )
+	std::cout << DLA::dot( x, b) << " " << DLA::dot( x, 2.0 * x) << " " <<
+			DLA::dot( mat * x, x) << std::endl;
+	// 10 60 20
+
+	std::cout << DLA::norm2( x) << " " << DLA::norm2( b - mat * x) << " " <<
+			DLA::norm2( b - csr * x) << " " <<
+			DLA::norm2( b - sell * x) << std::endl;
+	// 5.47723 4.3589 4.3589 4.3589
+
+	std::cout << DLA::sum( x) << " " << DLA::sum( diag * x + b) << " " <<
+			DLA::sum( x - b * 3.0) << std::endl;
+	// 10 9 -2
+
+	std::cout << DLA::max_abs( b - x) << " " <<
+			DLA::max_abs( sell * x - b) << std::endl;
+	// 3 4
+
+	// The reductions are converted to the promoted scalar types.
+	DLA::BasicVector< float > xf( n, 0.5f);
+	const double d = DLA::dot( xf, x);
+	const float f = DLA::norm2( xf);
+	std::cout << d << " " << f << std::endl;
+	// 5 1
+
+	return 0;
+}
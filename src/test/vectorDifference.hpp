@@ -0,0 +1,29 @@
+/*
+ * vectorDifference.hpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: Masakatsu ITO
+ */
+
+// The difference of the vectors compared by the tests
+
+
+#ifndef VECTORDIFFERENCE_HPP_
+#define VECTORDIFFERENCE_HPP_
+
+#include <algorithm>
+#include <cmath>
+
+#include <DenseLinAlg/DenseLinAlg.hpp>
+
+// the largest absolute difference of the elements of a and b
+inline double maxDiff( const DenseLinAlg::Vector& a,
+						const DenseLinAlg::Vector& b)
+{
+	double diff = 0.0;
+	for (int i = 0; i < a.size(); i++)
+		diff = std::max( diff, std::fabs( a(i) - b(i) ) );
+	return diff;
+}
+
+#endif /* VECTORDIFFERENCE_HPP_ */